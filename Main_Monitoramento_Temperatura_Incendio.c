@@ -1,16 +1,40 @@
 #include <stdio.h>              // Biblioteca padrão para entrada e saída (ex: printf)
 #include <stdlib.h>             // Biblioteca padrão para funções utilitárias (ex: malloc, atoi)
+#include <string.h>             // strcmp nos comandos do console
+#include <math.h>               // lroundf nas chaves da tela de depuração
 
 #include "pico/stdlib.h"        // Biblioteca principal do SDK do Raspberry Pi Pico (GPIO, delays, etc.)
 #include "hardware/adc.h"       // Controla o ADC interno do Pico (leitura de sinais analógicos)
 #include "hardware/i2c.h"       // Permite comunicação I2C (ex: com display OLED)
+#include "hardware/spi.h"       // SPI do display OLED quando compilado com OLED_SPI
 #include "hardware/pwm.h"       // Permite controle de PWM (ex: brilho de LEDs RGB)
+#include "hardware/clocks.h"    // clk_sys atual para os divisores do PWM no repouso
 
-#include "lib/ssd1306.h"        // Biblioteca para controle do display OLED SSD1306 via I2C
+#include "lib/ssd1306.h"        // Biblioteca para controle do display OLED SSD1306 (I2C ou SPI)
 #include "lib/font.h"           // Biblioteca auxiliar de fontes para uso com o display OLED
+#include "lib/historico.h"      // Histórico de temperatura em RAM (amostras brutas + agregados 1 s/1 min/1 h)
+#include "lib/hist_flash.h"     // Médias por minuto na flash, em blocos com diferenças em varint
+#include "lib/protecao.h"       // Decisão de proteção (limiares, taxa dT/dt, fusão dos sensores de fogo e contagem)
+#include "lib/ntc.h"            // Linearização do NTC por tabela gerada na compilação
+#include "lib/efeitos_led.h"    // Efeitos do LED RGB (piscar/fade/respirar) via PWM + DMA
+#include "lib/config.h"         // Configuração versionada em flash (slots A/B), editável pela serial
+#include "lib/status.h"         // SystemStatus e publicação sem travas (seqlock de buffer duplo)
+#include "lib/debounce_pio.h"   // Debounce dos botões por integração no PIO, com instante estimado da borda
+#include "lib/modbus_rtu.h"     // Escravo Modbus RTU na UART (recepção por IRQ, resposta por DMA)
+#include "lib/modbus_mapa.h"    // Mapa de registradores Modbus sobre os dados publicados e a configuração
+#include "lib/agregador_rs485.h" // Concentrador: mestre Modbus consultando as caixas do barramento RS-485
+#include "lib/secao_critica.h"  // Marca funções/tabelas do caminho de proteção para execução na SRAM
+#include "lib/latencia.h"       // Pior caso da IRQ e do caminho de proteção, com e sem contenção no XIP
+#include "lib/captura.h"        // Amostragem do ADC a 1 kHz com captura pré-disparo de 10 s (12 bits)
+#include "lib/vigia.h"          // Watchdog alimentado pela proteção e estado do disparo retido no reset
+#include "lib/ritmo.h"          // Período do ciclo de proteção escolhido pelo risco (repouso a alerta)
+#include "lib/tela_serial.h"    // Tela de depuração na serial reescrevendo só os campos que mudaram
+#include "lib/economia.h"       // Repouso em NORMAL estável: clk_sys a 48 MHz com o PLL do sistema desligado
 #include "numeros.h"            // Biblioteca com funções para exibir números na matriz de LEDs
+#include "animacao_matriz.h"    // Sequências de quadros-chave da matriz tocadas por alarme de hardware
 
 #include "pico/bootrom.h"       // Usada para acessar funções especiais da ROM, como reinício via USB (modo BOOTSEL)
+#include "hardware/sync.h"      // __sev: acorda o laço (em WFE) na borda do sensor de fogo
 
 
 /// ===============================
@@ -23,10 +47,24 @@
 #define I2C_SCL 15              // Pino GPIO 15 como linha de clock I2C (SCL)
 #define endereco 0x3C           // Endereço I2C do display OLED SSD1306
 
+// --- Display pela SPI (opção OLED_SPI do CMake): quadro ~12x mais rápido que o I2C a 400 kHz ---
+#ifndef OLED_SPI
+#define OLED_SPI 0
+#endif
+#define OLED_SPI_PORT spi0      // SPI0 nos pinos livres 16–19
+#define OLED_SPI_SCK 18         // Pino GPIO 18 como clock (D0 do módulo)
+#define OLED_SPI_MOSI 19        // Pino GPIO 19 como dados (D1 do módulo)
+#define OLED_SPI_CS 17          // Pino GPIO 17 como seleção do chip
+#define OLED_SPI_DC 16          // Pino GPIO 16 como seleção dado/comando
+
 // --- Pinos do Joystick ---
 #define JOYSTICK_X_PIN 26       // Pino GPIO 26 para leitura do eixo X (ADC0)
 #define JOYSTICK_Y_PIN 27       // Pino GPIO 27 para leitura do eixo Y (ADC1)
 
+// --- Sensores de incêndio ---
+#define FUMACA_PIN 28           // Pino GPIO 28 com o sensor de fumaça analógico (ADC2)
+#define FUMACA_ADC 2
+
 // --- LEDs RGB (controle de status) ---
 #define LED_R 11                // Pino GPIO 11 para canal vermelho do LED RGB
 #define LED_G 12                // Pino GPIO 12 para canal verde do LED RGB
@@ -34,52 +72,134 @@
 
 // --- Botões físicos no sistema ---
 #define Pino_BOTAO_A 5          // Pino GPIO 5 para o botão A (ex: reinício em modo BOOTSEL)
-#define Pino_BOTAO_B 6          // Pino GPIO 6 para o botão B (simula sensor de incêndio)
+#define Pino_BOTAO_B 6          // Pino GPIO 6 para o botão B (simula o sensor de chama IR)
 #define MATRIZ_LED_PIN 7        // Pino GPIO 7 conectado à matriz de LEDs WS2812
 
 // --- Buzzer (alerta sonoro) ---
 #define BUZZER_PIN 21           // Pino GPIO 21 usado para ativar o buzzer (alarme)
 
-float divisor_frequency = 125;  // Divisor de frequência usado para ajustar o tom do PWM do buzzer
-int countdown = 9;              // Contador para desligamento em caso de incêndio crítico
+// === Definições do Modbus RTU (SCADA) ===
+#define MODBUS_UART uart1       // UART dedicada ao SCADA (uart0 fica com o printf)
+#define MODBUS_TX_PIN 8         // Pino GPIO 8 como TX da UART1
+#define MODBUS_RX_PIN 9         // Pino GPIO 9 como RX da UART1
+#define RS485_DE_PIN 4          // Pino GPIO 4 habilita o transmissor RS-485 no modo concentrador
+
+// Uma conversão do ADC: 96 ciclos do clock de 48 MHz
+#define ADC_CONVERSAO_US 2
+
+// Contador do PWM do LED RGB (clk_sys / 1250 no clock do boot): wrap de 2000 a 50 Hz
+#define LED_PWM_CONTADOR_HZ 100000
+
+// Conversões seguidas na faixa de vigilância que acordam o laço no repouso
+#define DESPERTAR_AMOSTRAS 3
+
+// Bipe do buzzer por PWM: 1,67 kHz (contador a 1 MHz, 600 µs por período, 500 µs ligado)
+// desligado por alarme após BUZZER_BIPE_MS, sem segurar o laço
+#define BUZZER_CONTADOR_HZ 1000000
+#define BUZZER_WRAP 599
+#define BUZZER_NIVEL 500
+#define BUZZER_BIPE_MS 30
+
+// Colunas do OLED enviadas por vez; a proteção roda entre um trecho e outro
+// (~6 ms por trecho no I2C a 400 kHz, em vez de ~23 ms pelo quadro inteiro)
+#define OLED_TRECHO_COLUNAS 32
 
 volatile bool toggle_green_led = false;  // Controle de piscada do LED verde (não usado no trecho atual)
 volatile bool toggle_leds = true;        // Flag que permite ativar/desativar o controle de LEDs via joystick
 volatile uint8_t border_style = 1;       // Estilo da borda no display OLED (1 = fina, 2 = grossa)
 
-// Controle de tempo para evitar múltiplos acionamentos indevidos (debounce)
-static absolute_time_t last_button_a_time = 0;        // Último tempo de acionamento do botão A
-static absolute_time_t last_button_b_time = 0;        // Último tempo de acionamento do botão B
+// Debounce dos botões feito em hardware (PIO1, lib/debounce_pio.h)
+static const uint pinos_entradas[] = {Pino_BOTAO_A, Pino_BOTAO_B};
+static volatile uint64_t instante_entrada_fogo_us = 0;   // Instante da última borda do sensor de fogo
 
-const uint64_t DEBOUNCE_TIME = 200000;  // Tempo mínimo entre cliques: 200ms (em microssegundos)
+// Tempo de envio de um quadro ao OLED (último e pior caso), exibido na tela de depuração
+static uint32_t tempo_quadro_us = 0;
+static uint32_t tempo_quadro_max_us = 0;
+static const char *transporte_oled = "";
+
+// Limiares, debounce, períodos, joystick e brilho vêm de config_atual() (lib/config.h)
 
 // ===============================
 // === VARIÁVEL DE ESTADO DO SISTEMA ===
 // ===============================
 
-// Enum que define os estados possíveis do sistema com base na temperatura
-typedef enum
-{
-    SYSTEM_NORMAL,    // Temperatura segura (< 40°C)
-    SYSTEM_ATTENTION, // Temperatura elevada (40–59°C)
-    SYSTEM_CRITICAL   // Temperatura crítica (≥ 60°C)
-} SystemState;
-
-
-typedef struct
-{
-    SystemState state;       // Estado atual (NORMAL, ATENÇÃO ou CRÍTICO)
-    float current_temp;      // Temperatura atual lida pelo sensor
-    bool fire_detected;      // Status do sensor de incêndio (true = fogo detectado)
-} SystemStatus;
-
+// SystemState e SystemStatus estão em lib/status.h.
+// system_status é a cópia de trabalho do laço principal (único escritor); os
+// demais consumidores leem a versão publicada em status_publicado.
 SystemStatus system_status = {
     .state = SYSTEM_NORMAL,       // Inicializa como sistema normal
     .current_temp = 0.0f,         // Temperatura inicial
-    .fire_detected = false        // Nenhum incêndio detectado ao iniciar
+    .fire_detected = false,       // Nenhum incêndio detectado ao iniciar
+    .taxa_subida = 0,             // Sem taxa estimada até a janela encher
+    .countdown = 9,               // Contagem regressiva para desligamento
+    .relatorio = false            // Nenhum relatório emitido
 };
 
-int relatorio = 0;  // Flag que indica se o relatório de evento já foi gerado (evita repetição)
+status_publicado_t status_publicado;
+
+// Alternado pela interrupção do botão B e copiado para system_status no ciclo de proteção
+volatile bool entrada_fogo = false;
+static volatile bool disparo_pendente = false;   // Borda de fogo ainda não refletida em CRÍTICO
+
+// Canais de temperatura por string, contíguos para a comparação entre vizinhos
+// (ponto quente exige PONTO_QUENTE_MIN_CANAIS; hoje só o canal simulado no ADC0)
+#define NUM_CANAIS_TEMP 1
+static int16_t temperaturas_dc[NUM_CANAIS_TEMP];
+
+// ===============================
+// === MARCAS DE TEMPO DO BOOT ===
+// ===============================
+// Instante (µs desde o reset) em que cada fase do boot terminou: mede o tempo até a proteção
+typedef enum
+{
+    BOOT_CONFIG,          // Configuração selecionada na flash
+    BOOT_PROTECAO,        // ADC, entradas, alarme e primeira avaliação de estado
+    BOOT_INDICADORES,     // LED RGB (PWM + DMA)
+    BOOT_CONSOLE_MATRIZ,  // Serial e matriz WS2812
+    BOOT_DISPLAY,         // Display OLED
+    BOOT_NUM_FASES
+} boot_fase_t;
+
+static const char *const boot_nomes[BOOT_NUM_FASES] = {"config", "proteção", "indicadores", "console+matriz", "display"};
+uint32_t boot_marcas_us[BOOT_NUM_FASES];
+
+static inline void boot_marcar(boot_fase_t fase)
+{
+    boot_marcas_us[fase] = time_us_32();
+}
+
+historico_t historico;  // Histórico de temperatura (memória fixa, ver HIST_ORCAMENTO_BYTES)
+protecao_t protecao;  // Lógica de proteção (a mesma usada pelo replay de traços no host)
+
+// Período do ciclo de proteção conforme o risco; o laço dorme em WFE até o
+// próximo ciclo e a borda do sensor de fogo o acorda antes. As IRQs só marcam
+// a flag e executam SEV: nada da flash (sem_release) no caminho crítico
+ritmo_t ritmo;
+static volatile bool despertar = false;
+static uint64_t proxima_protecao_us = 0;   // Vencimento do próximo ciclo de proteção
+static int16_t temp_atual_dc;             // Última temperatura avaliada pela proteção
+static uint64_t metricas_inicio_us;   // Ocupação da CPU desde o boot ou "ritmo zerar"
+static uint64_t ocupado_us;
+static uint64_t protecao_us;
+
+// Disparo, contagem e sensor de fogo lidos dos registradores do watchdog no boot
+static vigia_estado_t estado_retido;
+static bool estado_restaurado = false;
+
+// Repouso (lib/economia.h): o laço é acordado pela borda do fogo ou pelo tique de
+// 1 kHz quando a temperatura entra na faixa de vigilância; o instante do evento
+// mede a latência até a decisão da proteção
+static volatile bool em_repouso = false;
+static volatile bool despertar_por_limiar = false;
+static volatile uint64_t instante_despertar_us = 0;
+static int16_t limite_despertar_dc;   // Limiar de atenção menos a margem do ritmo
+static uint8_t amostras_acima = 0;
+
+// Concentrador (lib/agregador_rs485.h): pior caixa do barramento, copiada a cada atualização da interface
+static agregador_caixa_t pior_remota;
+static bool remota_valida = false;
+static uint8_t caixas_online = 0;
+static uint8_t caixas_total = 0;
 
 
 // ===============================
@@ -107,15 +227,37 @@ void update_rgb_led(void);
 void update_display(void);
 
 // --- Temperatura e Sensores ---
-// Converte o valor lido do ADC em temperatura (°C)
-float read_temperature(float adc_x);
+// Converte o valor lido do ADC em temperatura (décimos de °C) pela tabela do NTC
+int16_t read_temperature(uint16_t adc_x);
 
 // Retorna o status do sensor de incêndio (simulado via botão B)
 bool read_fire_sensor(void);
 
+// Repassa a configuração em vigor aos módulos que mantêm cópia dos parâmetros
+void aplicar_config(void);
+
+// --- Economia de energia ---
+// Mantém o PWM do LED RGB a 50 Hz com o clk_sys atual
+void ajustar_clkdiv_led(void);
+
+// Entra/sai do repouso: clock, divisores dependentes dele, OLED e matriz
+void entrar_repouso(ssd1306_t *ssd);
+void sair_repouso(ssd1306_t *ssd);
+
+// Tique de 1 kHz no repouso (interrupção): acorda o laço na faixa de vigilância
+void observar_temperatura(uint16_t adc, uint64_t instante_us);
+
+// Converte a amostra, alimenta histórico, detector de taxa e fusão e reavalia o estado
+int16_t ciclo_protecao(uint16_t adc_temp, uint16_t adc_fumaca, uint64_t agora_us);
+
+// Roda o ciclo de proteção se o período do ritmo venceu ou uma IRQ pediu (despertar).
+// Chamada no topo do laço e entre as etapas da interface, que assim não atrasam a
+// proteção mais do que a etapa mais longa (um trecho do OLED, um bloco da flash)
+bool proteger_se_devido(void);
+
 // --- Interações e eventos ---
-// Callback das interrupções de botões (A, B e botão do joystick)
-void button_callback(uint gpio, uint32_t events);
+// Recebe as bordas já filtradas pelo PIO, com o instante real da transição
+void button_callback(uint gpio, uint32_t events, uint64_t instante_us);
 
 // (Reservadas para ações futuras com botões ou joystick)
 void handle_button_1(void); // Não implementada
@@ -124,71 +266,206 @@ void handle_button_3(void); // Não implementada
 void handle_button_4(void); // Não implementada
 
 // --- Depuração e Relatório ---
+// Registra rótulos e campos da tela de depuração (após o OLED, que define o transporte)
+void preparar_tela_depuracao(void);
+
 // Exibe as informações do sistema no terminal (temperatura, estado, joystick, LED)
 void show_debug_screen(uint16_t adc_x, uint16_t adc_y, float temp, bool fire_detected);
 
 // Gera um relatório formatado no terminal quando incêndio ou temperatura crítica é detectado
 void gerar_relatorio_evento(SystemStatus status);
 
+// Fontes da fusão votando, separadas por '+' ("-" sem votos)
+void descrever_votos(char *texto, size_t tamanho, uint8_t votos);
+
+// Comando "ritmo" do console: tempo por nível, ciclos/s, intervalos atingidos, CPU/ADC e pior latência
+void comando_ritmo(const char *argumento);
+
+// Comando "tela" do console: redesenha a tela de depuração ou mostra os bytes/s dela
+void comando_tela(const char *argumento);
+
+// --- Concentrador RS-485 ---
+// Nível da caixa em 4 letras ("NORM", "ATEN", "CRIT", "MUDA" ou "----")
+const char *descrever_caixa(const agregador_caixa_t *caixa);
+
+// Pior caixa e caixas respondendo, dentro da borda do OLED
+void desenhar_concentrador(ssd1306_t *ssd);
+
+// Comando "rede" do console: tabela das caixas e tempos do ciclo de consulta
+void comando_rede(const char *argumento);
+
 // --- Buzzer ---
-// Emite sinal sonoro intermitente no buzzer (5 bipes rápidos)
+// Bipe de BUZZER_BIPE_MS no buzzer por PWM; retorna na hora (um alarme desliga)
 void buzzer_alerta_incendio(void);
 
+// Envia o quadro do OLED em trechos de colunas, com a proteção em dia entre eles
+void enviar_quadro_oled(ssd1306_t *ssd);
+
 int main(void)
 {
-    // Inicializa comunicação serial padrão (UART via USB) para printf
-    stdio_init_all();
+    // Motivo do reset e estado do disparo antes de qualquer inicialização
+    estado_restaurado = vigia_restaurar(&estado_retido);
 
-    // Inicializa a matriz de LEDs WS2812 conectada ao pino definido
-    npInit(MATRIZ_LED_PIN);
+    // ===============================
+    // === FASE 0: CONFIGURAÇÃO ======
+    // ===============================
+    // Seleciona a configuração gravada (slot A/B) direto da flash, sem parsing
+    config_carregar();
+    economia_iniciar();   // clk_peri no PLL da USB antes das UARTs e da SPI
+    boot_marcar(BOOT_CONFIG);
 
-    // Configura o pino do buzzer como saída
-    gpio_init(BUZZER_PIN);
-    gpio_set_dir(BUZZER_PIN, GPIO_OUT);
+    // ===============================
+    // === FASE 1: PROTEÇÃO ==========
+    // ===============================
+    // Sensoriamento e saída de alarme são armados antes de qualquer interface
 
-    // --- Configuração dos botões físicos ---
+    // Pino do buzzer (saída de alarme) no PWM, parado até o primeiro bipe
+    gpio_set_function(BUZZER_PIN, GPIO_FUNC_PWM);
+    pwm_set_wrap(pwm_gpio_to_slice_num(BUZZER_PIN), BUZZER_WRAP);
+    pwm_set_gpio_level(BUZZER_PIN, 0);
+    pwm_set_enabled(pwm_gpio_to_slice_num(BUZZER_PIN), true);
 
-    // Botão B (simula sensor de fogo)
+    // Botão B (simula sensor de fogo) e botão A (modo BOOTSEL)
     gpio_init(Pino_BOTAO_B);
     gpio_set_dir(Pino_BOTAO_B, GPIO_IN);
     gpio_pull_up(Pino_BOTAO_B);
-    gpio_set_irq_enabled_with_callback(Pino_BOTAO_B, GPIO_IRQ_EDGE_FALL, true, &button_callback);
 
-
-
-    // Botão A (modo BOOTSEL)
     gpio_init(Pino_BOTAO_A);
     gpio_set_dir(Pino_BOTAO_A, GPIO_IN);
     gpio_pull_up(Pino_BOTAO_A);
 
-    // --- Inicializa barramento I2C e configura display OLED SSD1306 ---
+    latencia_iniciar();
+    debounce_pio_iniciar(pinos_entradas, count_of(pinos_entradas), config_atual()->debounce_us, &button_callback);
+
+    // --- Inicializa ADC (sensor de temperatura simulado pelo joystick) ---
+    adc_init();
+    adc_gpio_init(JOYSTICK_X_PIN);
+    adc_gpio_init(JOYSTICK_Y_PIN);
+    adc_gpio_init(FUMACA_PIN);
+
+    // Inicia o histórico de temperatura vazio e a lógica de proteção
+    // (limiares, taxa e fusão são copiados da configuração em aplicar_config)
+    hist_iniciar(&historico);
+    protecao_config_t config_protecao = {config_atual()->limiar_atencao_dc, config_atual()->limiar_critico_dc};
+    taxa_config_t config_taxa = TAXA_CONFIG_PADRAO;
+    fusao_config_t config_fusao = FUSAO_CONFIG_PADRAO;
+    protecao_iniciar(&protecao, &config_protecao, &config_taxa, &config_fusao);
+    ritmo_config_t config_ritmo = RITMO_CONFIG_PADRAO;
+    ritmo_iniciar(&ritmo, &config_ritmo);
+    aplicar_config();   // Também arma o watchdog
+
+    // Reset em CRÍTICO (travamento ou reinício): o disparo continua de onde parou
+    if (estado_restaurado)
+    {
+        entrada_fogo = estado_retido.fogo;
+        system_status.relatorio = estado_retido.relatorio;
+        protecao_retomar(&protecao, &system_status, (uint32_t)(time_us_64() / 1000), &estado_retido.protecao);
+    }
+
+    // Primeira amostra e primeira avaliação de estado já no boot
+    adc_select_input(FUMACA_ADC);
+    uint16_t adc_fumaca = adc_read();
+    adc_select_input(0);
+    uint64_t inicio_boot_us = time_us_64();
+    temp_atual_dc = ciclo_protecao(adc_read(), adc_fumaca, inicio_boot_us);
+    proxima_protecao_us = inicio_boot_us + ritmo_periodo_ms(&ritmo) * 1000ull;
+    config_console_registrar("ritmo", comando_ritmo);
+    config_console_registrar("tela", comando_tela);
+    config_console_registrar("rede", comando_rede);
+
+    // A partir daqui o ADC é do amostrador de 1 kHz: ADC0 (temperatura) também
+    // vai para o anel de pré-disparo; ADC1 (joystick Y) e ADC2 (fumaça) só têm
+    // a última leitura e a média desde o ciclo anterior
+    static const uint8_t entradas_adc[] = {0, 1, FUMACA_ADC};
+    captura_iniciar(entradas_adc, count_of(entradas_adc));
+    boot_marcar(BOOT_PROTECAO);
+
+    // ===============================
+    // === FASE 2: INDICADORES =======
+    // ===============================
+    // --- Configura LED RGB como saída PWM ---
+    gpio_set_function(LED_R, GPIO_FUNC_PWM);
+    gpio_set_function(LED_G, GPIO_FUNC_PWM);
+    gpio_set_function(LED_B, GPIO_FUNC_PWM);
+
+    uint slice_num_r = pwm_gpio_to_slice_num(LED_R);
+    uint slice_num_g = pwm_gpio_to_slice_num(LED_G);
+    uint slice_num_b = pwm_gpio_to_slice_num(LED_B);
+
+    // Frequência ~50Hz
+    ajustar_clkdiv_led();
+
+    pwm_set_wrap(slice_num_r, 2000);
+    pwm_set_wrap(slice_num_g, 2000);
+    pwm_set_wrap(slice_num_b, 2000);
 
+    pwm_set_enabled(slice_num_r, true);
+    pwm_set_enabled(slice_num_g, true);
+    pwm_set_enabled(slice_num_b, true);
+
+    // Efeitos do LED RGB animados por DMA no wrap do PWM (sem CPU por quadro)
+    efeitos_led_iniciar(LED_R, LED_G, LED_B, 2000);
+    boot_marcar(BOOT_INDICADORES);
+
+    // ===============================
+    // === FASE 3: CONSOLE E MATRIZ ==
+    // ===============================
+    // Inicializa comunicação serial padrão (UART via USB) para printf
+    stdio_init_all();
+
+    // Inicializa a matriz de LEDs WS2812 conectada ao pino definido e a desliga
+    npInit(MATRIZ_LED_PIN);
+    DesligaMatriz();
+
+    // UART1: concentrador das caixas do barramento ou escravo do SCADA (escolhido no boot)
+    const config_t *cfg = config_atual();
+    if (cfg->agregador_caixas > 0)
+    {
+        agregador_config_t config_agregador = {cfg->modbus_baud, cfg->agregador_timeout_ms,
+                                               cfg->agregador_tentativas, cfg->agregador_periodo_ms};
+        agregador_rs485_iniciar(MODBUS_UART, MODBUS_TX_PIN, MODBUS_RX_PIN, RS485_DE_PIN,
+                                cfg->agregador_primeiro, cfg->agregador_caixas, &config_agregador);
+    }
+    else
+    {
+        // Escravo Modbus RTU: o mapa referencia status publicado, histórico e configuração
+        const modbus_mapa_t *mapa_modbus = modbus_mapa_iniciar(&status_publicado, modbus_rtu_contadores());
+        modbus_rtu_iniciar(MODBUS_UART, MODBUS_TX_PIN, MODBUS_RX_PIN, cfg->modbus_endereco, cfg->modbus_baud, mapa_modbus);
+    }
+
+    // Histórico compacto na flash: localiza o bloco mais recente e continua a série dele
+    hist_flash_iniciar();
+    boot_marcar(BOOT_CONSOLE_MATRIZ);
+
+    // ===============================
+    // === FASE 4: DISPLAY OLED ======
+    // ===============================
+    // Inicializa estrutura e configura o display OLED (um único quadro em branco)
+    static ssd1306_t ssd;   // Inclui o framebuffer: alocação estática, fora da pilha
+#if OLED_SPI
+    spi_init(OLED_SPI_PORT, SSD1306_SPI_HZ); // Modo 0, MSB primeiro (padrão do SDK)
+    gpio_set_function(OLED_SPI_SCK, GPIO_FUNC_SPI);
+    gpio_set_function(OLED_SPI_MOSI, GPIO_FUNC_SPI);
+    ssd1306_init_spi(&ssd, WIDTH, HEIGHT, false, OLED_SPI_PORT, OLED_SPI_DC, OLED_SPI_CS);
+#else
     i2c_init(I2C_PORT, 400 * 1000); // Inicializa I2C a 400kHz
     gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
     gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_SDA);
     gpio_pull_up(I2C_SCL);
-
-    // Inicializa estrutura e configura o display OLED
-    ssd1306_t ssd;
     ssd1306_init(&ssd, WIDTH, HEIGHT, false, endereco, I2C_PORT);
+#endif
+    transporte_oled = ssd.transporte->nome;
     ssd1306_config(&ssd);
-    ssd1306_send_data(&ssd);
     ssd1306_fill(&ssd, false);
     ssd1306_send_data(&ssd);
-
-    // --- Inicializa ADC para ler joystick analógico ---
-    adc_init();
-    adc_gpio_init(JOYSTICK_X_PIN);
-    adc_gpio_init(JOYSTICK_Y_PIN);
+    preparar_tela_depuracao();
+    boot_marcar(BOOT_DISPLAY);
 
     // --- Variáveis de controle da posição e exibição no display ---
     int16_t x_pos, y_pos;
     char str_x[5], str_y[5];
 
-    const uint16_t CENTRO_X = 1870;
-    const uint16_t CENTRO_Y = 1969;
-    const uint16_t ZONA_MORTA = 200;
     const int VELOCIDADE_MAX = 5;
 
     const int CENTRO_DISPLAY_X = 64;
@@ -206,121 +483,122 @@ int main(void)
 
     bool cor = true;
 
-    // --- Configura LED RGB como saída PWM ---
-    gpio_set_function(LED_R, GPIO_FUNC_PWM);
-    gpio_set_function(LED_G, GPIO_FUNC_PWM);
-    gpio_set_function(LED_B, GPIO_FUNC_PWM);
-
-    // Ativa interrupções para botões e joystick
-    gpio_set_irq_enabled_with_callback(Pino_BOTAO_A, GPIO_IRQ_EDGE_FALL, true, &button_callback);
-    gpio_set_irq_enabled_with_callback(Pino_BOTAO_B, GPIO_IRQ_EDGE_FALL, true, &button_callback);
-
-    // --- Configura PWM dos LEDs RGB ---
-    uint slice_num_r = pwm_gpio_to_slice_num(LED_R);
-    uint slice_num_g = pwm_gpio_to_slice_num(LED_G);
-    uint slice_num_b = pwm_gpio_to_slice_num(LED_B);
-
-    // Frequência ~50Hz
-    pwm_set_clkdiv(slice_num_r, 1250);
-    pwm_set_clkdiv(slice_num_g, 1250);
-    pwm_set_clkdiv(slice_num_b, 1250);
-
-    pwm_set_wrap(slice_num_r, 2000);
-    pwm_set_wrap(slice_num_g, 2000);
-    pwm_set_wrap(slice_num_b, 2000);
-
-    pwm_set_enabled(slice_num_r, true);
-    pwm_set_enabled(slice_num_g, true);
-    pwm_set_enabled(slice_num_b, true);
-
-    // Desliga a matriz de LEDs no início
-    DesligaMatriz();
-
     // Controle de tempo para atualizar a tela periodicamente
     uint64_t ultimo_tempo = 0;
-    const uint64_t intervalo = 1000 * 1000; // Atualiza a cada 1 segundo
+    uint64_t proxima_interface = 0;
+    metricas_inicio_us = time_us_64();
 
     // ===============================
     // === LOOP PRINCIPAL ============
     // ===============================
     while (true)
     {
-        // --- Leitura do joystick (X e Y analógicos via ADC) ---
-        adc_select_input(0);
-        uint16_t adc_x = adc_read();
-        adc_select_input(1);
-        uint16_t adc_y = adc_read();
-
-        // Atualiza temperatura com base na leitura do ADC
-        float temp = read_temperature(adc_x);
-        system_status.current_temp = temp;
+        // Temperatura, histórico, taxa de elevação e estado do sistema no ritmo do
+        // risco (o laço também acorda para a interface, que não roda a proteção fora de hora)
+        uint64_t inicio_iteracao = time_us_64();
+        proteger_se_devido();
+
+        // Repouso em NORMAL estável; o primeiro ciclo com risco já decidiu antes de o clock voltar.
+        // O concentrador não repousa: OLED e matriz mostram as caixas remotas
+        bool repousar = config_atual()->economia_energia && ritmo.nivel == RITMO_REPOUSO &&
+                        system_status.state == SYSTEM_NORMAL && !entrada_fogo && !agregador_rs485_ativo();
+        if (repousar && !em_repouso)
+            entrar_repouso(&ssd);
+        else if (!repousar && em_repouso)
+            sair_repouso(&ssd);
 
-        // Atualiza a tela OLED a cada segundo
         uint64_t agora = time_us_64();
-        if (agora - ultimo_tempo >= intervalo)
-        {
-            ultimo_tempo = agora;
-            show_debug_screen(adc_x, adc_y, temp, system_status.fire_detected);
-        }
 
-        // --- Calcula posição do quadrado na tela com base no joystick ---
-        x_pos = ((adc_y * (WIDTH - 24)) / 4095) + 8;
-        y_pos = HEIGHT - 16 - ((adc_x * (HEIGHT - 24)) / 4095);
-
-        // Limita a posição para manter dentro da tela
-        if (x_pos < 8) x_pos = 8;
-        if (x_pos > WIDTH - 16) x_pos = WIDTH - 16;
-        if (y_pos < 8) y_pos = 8;
-        if (y_pos > HEIGHT - 16) y_pos = HEIGHT - 16;
-
-        // --- Atualiza o display OLED com o quadrado e bordas ---
-        ssd1306_fill(&ssd, false);
-        ssd1306_rect(&ssd, y_pos, x_pos, QUADRADO_SIZE, QUADRADO_SIZE, true, true);
-
-        // Desenha borda (fina ou grossa) de acordo com o estilo selecionado
-        if (border_style == 1)
+        // Interface, console e configuração no período de amostragem configurado
+        // (limitado ao que o watchdog tolera, caso uma configuração antiga tenha período maior);
+        // no repouso, no período da proteção
+        if (agora >= proxima_interface)
         {
-            ssd1306_rect(&ssd, 0, 0, WIDTH, HEIGHT, true, false); // borda 1px
-        }
-        else
-        {
-            ssd1306_rect(&ssd, 0, 0, WIDTH, HEIGHT, true, false);       // camada externa
-            ssd1306_rect(&ssd, 1, 1, WIDTH - 2, HEIGHT - 2, true, false); // camada interna
-        }
+            uint16_t periodo_ms = em_repouso ? ritmo_periodo_ms(&ritmo) : config_atual()->periodo_amostragem_ms;
+            proxima_interface = agora + (periodo_ms < VIGIA_PERIODO_MAX_MS ? periodo_ms : VIGIA_PERIODO_MAX_MS) * 1000ull;
 
-        // Atualiza display com os dados
-        ssd1306_send_data(&ssd);
-
-        // --- Controle do brilho dos LEDs RGB com base no joystick ---
-        if (toggle_leds)
-        {
-            int32_t dist_x = abs(2048 - adc_x);
-            int32_t dist_y = abs(2048 - adc_y);
-            const int32_t deadzone = 300;
+            // --- Leitura do joystick (X e Y analógicos via ADC) ---
+            uint16_t adc_x = captura_ultima(0);
+            uint16_t adc_y = captura_ultima(1);
+            float temp = temp_atual_dc / 10.0f;   // Usada apenas para exibição
+            remota_valida = agregador_rs485_pior(&pior_remota, &caixas_online, &caixas_total);
 
-            uint16_t duty_r = 0;
-            if (dist_y > deadzone)
+            // Atualiza a tela OLED a cada segundo
+            if (agora - ultimo_tempo >= config_atual()->intervalo_tela_us)
             {
-                duty_r = ((dist_y - deadzone) * 2000) / (2048 - deadzone);
-                if (duty_r > 2000) duty_r = 2000;
+                ultimo_tempo = agora;
+                show_debug_screen(adc_x, adc_y, temp, entrada_fogo);   // O relatório pode levar dezenas de ms na serial
+                proteger_se_devido();
             }
 
-            uint16_t duty_b = 0;
-            if (dist_x > deadzone)
+            // OLED e matriz ficam apagados no repouso
+            if (!em_repouso)
             {
-                duty_b = ((dist_x - deadzone) * 2000) / (2048 - deadzone);
-                if (duty_b > 2000) duty_b = 2000;
+                // --- Calcula posição do quadrado na tela com base no joystick ---
+                x_pos = ((adc_y * (WIDTH - 24)) / 4095) + 8;
+                y_pos = HEIGHT - 16 - ((adc_x * (HEIGHT - 24)) / 4095);
+
+                // Limita a posição para manter dentro da tela
+                if (x_pos < 8) x_pos = 8;
+                if (x_pos > WIDTH - 16) x_pos = WIDTH - 16;
+                if (y_pos < 8) y_pos = 8;
+                if (y_pos > HEIGHT - 16) y_pos = HEIGHT - 16;
+
+                // --- Atualiza o display OLED com o quadrado e bordas ---
+                ssd1306_fill(&ssd, false);
+                ssd1306_rect(&ssd, y_pos, x_pos, QUADRADO_SIZE, QUADRADO_SIZE, true, true);
+
+                // Desenha borda (fina ou grossa) de acordo com o estilo selecionado
+                if (border_style == 1)
+                {
+                    ssd1306_rect(&ssd, 0, 0, WIDTH, HEIGHT, true, false); // borda 1px
+                }
+                else
+                {
+                    ssd1306_rect(&ssd, 0, 0, WIDTH, HEIGHT, true, false);       // camada externa
+                    ssd1306_rect(&ssd, 1, 1, WIDTH - 2, HEIGHT - 2, true, false); // camada interna
+                }
+                if (remota_valida)
+                    desenhar_concentrador(&ssd);
+
+                // Atualiza display com os dados, em trechos (mede o tempo de quadro do transporte)
+                enviar_quadro_oled(&ssd);
+
+                // Atualiza status da matriz de LEDs conforme o estado do sistema
+                update_led_matrix();
             }
 
-            // pwm_set_duty(LED_R, duty_r);
-            // pwm_set_duty(LED_B, duty_b);
-        }
+            // Apagar um setor da flash (até ~400 ms sem interrupções) só em NORMAL e com o
+            // ritmo em NORMAL ou REPOUSO: perto de um limiar a proteção não pode parar tanto
+            bool pode_apagar = system_status.state == SYSTEM_NORMAL && ritmo.nivel <= RITMO_NORMAL;
+
+            // Minuto fechado no histórico em RAM vai para a flash (fora do ciclo de proteção)
+            hist_flash_atualizar(&historico, pode_apagar);
+            proteger_se_devido();
+
+            // Pré-disparo congelado: exporta um trecho por iteração e rearma fora de CRÍTICO
+            if (captura_congelada() && captura_exportar() && system_status.state != SYSTEM_CRITICAL)
+                captura_rearmar();
+            proteger_se_devido();
+
+            config_manutencao_flash(pode_apagar);
 
-        // Atualiza status da matriz de LEDs conforme o estado do sistema
-        update_led_matrix();
+            // Comandos de configuração pela serial ou escritas do SCADA (validadas na IRQ da
+            // UART e aplicadas só aqui, fora de interrupção, sem reiniciar)
+            bool config_alterada = config_processar_console();
+            config_alterada |= modbus_mapa_aplicar_escritas();
+            if (config_alterada)
+                aplicar_config();
+        }
 
-        // Delay entre cada iteração do loop
-        sleep_ms(100);
+        // Dorme até o próximo ciclo de proteção ou de interface; a borda do sensor de fogo acorda antes
+        // (despertar fica marcado e é consumido pelo ciclo de proteção no topo do laço)
+        uint64_t fim_iteracao = time_us_64();
+        ocupado_us += fim_iteracao - inicio_iteracao;
+        uint64_t proximo = proxima_protecao_us < proxima_interface ? proxima_protecao_us : proxima_interface;
+        absolute_time_t ate = from_us_since_boot(proximo);
+        while (!despertar && !best_effort_wfe_or_timeout(ate))
+            ;
     }
 
     // Desliga a matriz de LEDs ao encerrar o programa
@@ -344,21 +622,202 @@ void pwm_set_duty(uint gpio, uint16_t value)
 // ================================================
 void set_rgb_led(uint8_t r, uint8_t g, uint8_t b)
 {
-    uint16_t duty_r = (r * 2000) / 255;
-    uint16_t duty_g = (g * 2000) / 255;
-    uint16_t duty_b = (b * 2000) / 255;
-
-    pwm_set_duty(LED_R, duty_r);
-    pwm_set_duty(LED_G, duty_g);
-    pwm_set_duty(LED_B, duty_b);
+    // Cor fixa: interrompe qualquer animação em andamento no DMA
+    efeitos_led_aplicar(EFEITO_FIXO, r, g, b);
 }
 
 // ================================================
 // === LEITURA DE TEMPERATURA PELO ADC ============
 // ================================================
-float read_temperature(float adc_x)
+int16_t CRITICO_FUNC(read_temperature)(uint16_t adc_x)
 {
-    return (float)(adc_x * 100.0f / 4095.0f) - 20;
+    return ntc_adc_para_dc(adc_x);
+}
+
+// ================================================
+// === CICLO DE PROTEÇÃO ==========================
+// ================================================
+int16_t ciclo_protecao(uint16_t adc_temp, uint16_t adc_fumaca, uint64_t agora_us)
+{
+    uint32_t agora_ms = (uint32_t)(agora_us / 1000);
+    uint32_t inicio = latencia_ciclos();
+
+    // Atualiza temperatura com base na leitura do ADC (aritmética inteira)
+    int16_t temp_dc = read_temperature(adc_temp);
+
+    // Limiares absolutos, taxa de elevação, fusão de chama/fumaça/temperatura/taxa
+    // e contagem regressiva (lib/protecao.c)
+    protecao_sensores_t sensores = {.chama = entrada_fogo, .fumaca_adc = adc_fumaca};
+    protecao_ciclo(&protecao, &system_status, agora_ms, temp_dc, &sensores);
+
+    // Cada canal contra a mediana dos demais (conector/porta-fusível aquecendo)
+    temperaturas_dc[0] = temp_dc;
+    protecao_canais(&protecao, &system_status, agora_ms, temperaturas_dc, NUM_CANAIS_TEMP);
+    latencia_fim(LAT_PROTECAO, inicio);
+
+    // Só para exibição: o ponto flutuante fica fora da medida do caminho crítico
+    system_status.current_temp = temp_dc / 10.0f;
+
+    // Período até o próximo ciclo conforme a proximidade dos limiares e a taxa
+    ritmo_atualizar(&ritmo, agora_ms, &system_status, temp_dc, &protecao.config);
+
+    // Único ponto que alimenta o watchdog: guarda antes o estado do disparo
+    vigia_estado_t retido = {.fogo = entrada_fogo, .relatorio = system_status.relatorio};
+    protecao_reter(&protecao, &system_status, agora_ms, &retido.protecao);
+    vigia_alimentar(&retido);
+
+    status_publicar(&status_publicado, &system_status);
+    if (disparo_pendente && system_status.state == SYSTEM_CRITICAL)
+    {
+        disparo_pendente = false;
+        latencia_registrar(LAT_BORDA_DISPARO, (uint32_t)(latencia_agora_us() - instante_entrada_fogo_us));
+    }
+    if (instante_despertar_us)
+    {
+        latencia_registrar(LAT_DESPERTAR, (uint32_t)(latencia_agora_us() - instante_despertar_us));
+        instante_despertar_us = 0;
+    }
+
+    // Disparo: congela o pré-disparo no instante da borda de fogo ou da detecção
+    if (system_status.state == SYSTEM_CRITICAL)
+        captura_disparar(CAPTURA_TODOS, entrada_fogo ? instante_entrada_fogo_us : agora_us);
+
+    // Registra a amostra no histórico (décimos de grau), fora do caminho crítico,
+    // no período de amostragem configurado mesmo com a proteção em ritmo acelerado
+    static uint32_t ultimo_hist_ms;
+    static bool hist_iniciado = false;
+    if (!hist_iniciado || agora_ms - ultimo_hist_ms >= config_atual()->periodo_amostragem_ms)
+    {
+        hist_iniciado = true;
+        ultimo_hist_ms = agora_ms;
+        hist_adicionar(&historico, agora_us / 1000u, temp_dc);   // Base de 64 bits, sem volta em 49,7 dias
+        modbus_mapa_publicar_historico(&historico);   // Cópia consistente para a IRQ da UART
+    }
+    return temp_dc;
+}
+
+bool proteger_se_devido(void)
+{
+    uint64_t inicio = time_us_64();
+    if (inicio < proxima_protecao_us && !despertar)
+        return false;
+    despertar = false;
+
+    // Média das conversões de 1 kHz desde o ciclo anterior
+    uint16_t adc_temp = captura_media(0);
+    if (despertar_por_limiar)
+    {
+        // Acordado pelo limiar: avalia a conversão que o cruzou, não a média do repouso
+        despertar_por_limiar = false;
+        adc_temp = captura_ultima(0);
+    }
+    temp_atual_dc = ciclo_protecao(adc_temp, captura_media(FUMACA_ADC), inicio);
+
+    // Próximo vencimento a partir deste ciclo: um atraso não vira rajada de ciclos
+    proxima_protecao_us = inicio + ritmo_periodo_ms(&ritmo) * 1000ull;
+    protecao_us += time_us_64() - inicio;
+    return true;
+}
+
+// ================================================
+// === APLICAÇÃO DA CONFIGURAÇÃO EM TEMPO REAL ====
+// ================================================
+void aplicar_config(void)
+{
+    const config_t *cfg = config_atual();
+
+    protecao.config.limiar_atencao_dc = cfg->limiar_atencao_dc;
+    protecao.config.limiar_critico_dc = cfg->limiar_critico_dc;
+    protecao.taxa.config.atencao_dc_min = cfg->taxa_atencao_dc_min;
+    protecao.taxa.config.critica_dc_min = cfg->taxa_critica_dc_min;
+    protecao.taxa.config.histerese_dc_min = cfg->taxa_histerese_dc_min;
+    protecao.config.fumaca_base_adc = cfg->fumaca_base_adc;
+    protecao.config.fumaca_alarme_adc = cfg->fumaca_alarme_adc;
+    protecao.fusao.config.peso[FUSAO_CHAMA] = cfg->fusao_peso_chama;
+    protecao.fusao.config.peso[FUSAO_FUMACA] = cfg->fusao_peso_fumaca;
+    protecao.fusao.config.peso[FUSAO_TEMPERATURA] = cfg->fusao_peso_temperatura;
+    protecao.fusao.config.peso[FUSAO_TAXA] = cfg->fusao_peso_taxa;
+    protecao.fusao.config.limiar = cfg->fusao_limiar;
+    protecao.fusao.config.votos_imediatos = cfg->fusao_votos;
+    protecao.fusao.config.confirmacao_ms = cfg->fusao_confirmacao_ms;
+    animacao_definir_brilho(cfg->brilho_matriz);
+    debounce_pio_definir_tempo(cfg->debounce_us);
+    modbus_rtu_configurar(cfg->modbus_endereco, cfg->modbus_baud);
+
+    ritmo.config.periodo_ms[RITMO_REPOUSO] = cfg->ritmo_repouso_ms;
+    ritmo.config.periodo_ms[RITMO_NORMAL] = cfg->periodo_amostragem_ms;
+    ritmo.config.periodo_ms[RITMO_VIGILANCIA] = cfg->ritmo_vigilancia_ms;
+    ritmo.config.periodo_ms[RITMO_ALERTA] = cfg->ritmo_alerta_ms;
+    ritmo.config.margem_dc = cfg->ritmo_margem_dc;
+    ritmo.config.taxa_dc_min = cfg->ritmo_taxa_dc_min;
+    ritmo.config.estavel_ms = cfg->ritmo_estavel_s * 1000u;
+
+    // O watchdog precisa tolerar o maior período entre dois ciclos de proteção
+    uint16_t maior_periodo = 0;
+    for (int n = 0; n < RITMO_NIVEIS; n++)
+        if (ritmo.config.periodo_ms[n] > maior_periodo)
+            maior_periodo = ritmo.config.periodo_ms[n];
+    vigia_armar(maior_periodo);
+
+    limite_despertar_dc = cfg->limiar_atencao_dc - cfg->ritmo_margem_dc;
+}
+
+// ================================================
+// === ECONOMIA DE ENERGIA (REPOUSO) ==============
+// ================================================
+void ajustar_clkdiv_led(void)
+{
+    float divisor = clock_get_hz(clk_sys) / (float)LED_PWM_CONTADOR_HZ;
+    pwm_set_clkdiv(pwm_gpio_to_slice_num(LED_R), divisor);
+    pwm_set_clkdiv(pwm_gpio_to_slice_num(LED_G), divisor);
+    pwm_set_clkdiv(pwm_gpio_to_slice_num(LED_B), divisor);
+}
+
+void entrar_repouso(ssd1306_t *ssd)
+{
+    // Interface desligada ainda no clock cheio (I2C e WS2812 dependem dele)
+    ssd1306_command(ssd, SET_DISP | 0x00);   // O SSD1306 mantém a RAM do quadro
+    animacao_parar();
+    npAguardar();                            // Quadro apagado fora do PIO antes da troca de clock
+
+    economia_entrar();
+    debounce_pio_ajustar_clock();
+    ajustar_clkdiv_led();
+
+    amostras_acima = 0;
+    em_repouso = true;
+    captura_observar(0, observar_temperatura);
+}
+
+void sair_repouso(ssd1306_t *ssd)
+{
+    captura_observar(0, NULL);
+    em_repouso = false;
+
+    economia_sair();
+    debounce_pio_ajustar_clock();
+    ajustar_clkdiv_led();
+
+    ssd1306_command(ssd, SET_DISP | 0x01);
+    // A matriz volta na próxima atualização da interface (update_led_matrix)
+}
+
+void CRITICO_FUNC(observar_temperatura)(uint16_t adc, uint64_t instante_us)
+{
+    if (ntc_adc_para_dc(adc) < limite_despertar_dc)
+    {
+        amostras_acima = 0;
+        return;
+    }
+
+    // Só a primeira vez em cada cruzamento; uma conversão isolada (ruído) não acorda
+    if (amostras_acima < DESPERTAR_AMOSTRAS && ++amostras_acima == DESPERTAR_AMOSTRAS)
+    {
+        instante_despertar_us = instante_us;
+        despertar_por_limiar = true;
+        despertar = true;
+        __sev();
+    }
 }
 
 // ================================================
@@ -372,48 +831,72 @@ bool read_fire_sensor(void)
 // ================================================
 // === CALLBACK PARA INTERRUPÇÕES DOS BOTÕES ======
 // ================================================
-void button_callback(uint gpio, uint32_t events)
+void CRITICO_FUNC(button_callback)(uint gpio, uint32_t events, uint64_t instante_us)
 {
-    absolute_time_t now = get_absolute_time();
-    uint64_t time_diff;
+    // Apenas o acionamento (borda de descida) gera ação
+    if (!(events & GPIO_IRQ_EDGE_FALL))
+        return;
 
     switch (gpio)
     {
     case Pino_BOTAO_A:
-        time_diff = absolute_time_diff_us(last_button_a_time, now);
-        if (time_diff >= DEBOUNCE_TIME)
-        {
-            last_button_a_time = now;
-            reset_usb_boot(0, 0); // Reinicia em modo BOOTSEL
-        }
+        reset_usb_boot(0, 0); // Reinicia em modo BOOTSEL
         break;
 
     case Pino_BOTAO_B:
-        time_diff = absolute_time_diff_us(last_button_b_time, now);
-        if (time_diff >= DEBOUNCE_TIME)
-        {
-            last_button_b_time = now;
-            system_status.fire_detected = !system_status.fire_detected;
-        }
+        instante_entrada_fogo_us = instante_us;
+        if (em_repouso)
+            instante_despertar_us = instante_us;
+        entrada_fogo = !entrada_fogo;
+        disparo_pendente = entrada_fogo;
+        despertar = true;   // Reavalia já, sem esperar o período do ritmo atual
+        __sev();
         break;
-
-  
-    
     }
 }
 
 // ================================================
 // === ALERTA SONORO COM O BUZZER ==================
 // ================================================
+int64_t buzzer_silenciar(alarm_id_t id, void *dados)
+{
+    pwm_set_gpio_level(BUZZER_PIN, 0);
+    return 0;   // Não repete
+}
+
 void buzzer_alerta_incendio()
 {
-    for (int i = 0; i < 50; i++)
+    static alarm_id_t alarme_buzzer = 0;
+
+    // Um bipe ainda tocando é estendido, não sobreposto
+    if (alarme_buzzer > 0)
+        cancel_alarm(alarme_buzzer);
+
+    // Divisor pelo clk_sys atual (o repouso muda o clock, mas não toca o buzzer)
+    pwm_set_clkdiv(pwm_gpio_to_slice_num(BUZZER_PIN), clock_get_hz(clk_sys) / (float)BUZZER_CONTADOR_HZ);
+    pwm_set_gpio_level(BUZZER_PIN, BUZZER_NIVEL);
+    alarme_buzzer = add_alarm_in_ms(BUZZER_BIPE_MS, buzzer_silenciar, NULL, true);
+    if (alarme_buzzer <= 0)
+        pwm_set_gpio_level(BUZZER_PIN, 0);   // Sem alarme livre: não deixa o buzzer preso ligado
+}
+
+// ================================================
+// === ENVIO DO QUADRO DO OLED EM TRECHOS =========
+// ================================================
+void enviar_quadro_oled(ssd1306_t *ssd)
+{
+    // Só o tempo do transporte entra na medida do quadro, não o da proteção intercalada
+    uint32_t tempo_envio_us = 0;
+    for (uint x0 = 0; x0 < WIDTH; x0 += OLED_TRECHO_COLUNAS)
     {
-        gpio_put(BUZZER_PIN, 1);
-        sleep_us(500);
-        gpio_put(BUZZER_PIN, 0);
-        sleep_us(100);
+        uint32_t inicio_trecho = time_us_32();
+        ssd1306_send_data_parcial(ssd, (uint8_t)x0, (uint8_t)(x0 + OLED_TRECHO_COLUNAS - 1));
+        tempo_envio_us += time_us_32() - inicio_trecho;
+        proteger_se_devido();
     }
+    tempo_quadro_us = tempo_envio_us;
+    if (tempo_quadro_us > tempo_quadro_max_us)
+        tempo_quadro_max_us = tempo_quadro_us;
 }
 
 // ================================================
@@ -423,7 +906,12 @@ void gerar_relatorio_evento(SystemStatus status)
 {
     printf("\n=========== RELATÓRIO DE DESLIGAMENTO ===========\n");
     printf("Temperatura atual     : %.1f °C\n", status.current_temp);
-    printf("Sensor de Incêndio    : %s\n", status.fire_detected ? "DETECTADO" : "NORMAL");
+    printf("Incêndio (fusão)      : %s\n", status.fire_detected ? "DETECTADO" : "NORMAL");
+    printf("Taxa de Elevação      : %.1f °C/min\n", status.taxa_subida / 10.0f);
+
+    char votos[48];
+    descrever_votos(votos, sizeof(votos), status.fusao_votos);
+    printf("Fusão dos sensores    : %u/%u, votos: %s\n", status.fusao_pontuacao, config_atual()->fusao_limiar, votos);
 
     const char *causa = "";
     if (status.fire_detected && status.current_temp >= 60.0f)
@@ -432,68 +920,236 @@ void gerar_relatorio_evento(SystemStatus status)
         causa = "Incêndio detectado";
     else if (status.current_temp >= 60.0f)
         causa = "Temperatura Crítica";
+    else if (status.state == SYSTEM_CRITICAL)
+        causa = "Taxa de Elevação Crítica";
     else
         causa = "Desconhecida (falha no sistema?)";
 
     printf("Causa do Desligamento : %s\n", causa);
     printf("Ação Executada        : Contagem regressiva (9 a 0), Seccionamento da String Box\n");
     printf("Status Final          : SISTEMA DESENERGIZADO \n");
+    if (captura_congelada())
+        printf("Pré-disparo           : %u amostras a %d Hz congeladas (linhas #C)\n",
+               captura_total(0), CAPTURA_TAXA_HZ);
     printf("=================================================\n\n");
 }
 
+void descrever_votos(char *texto, size_t tamanho, uint8_t votos)
+{
+    int n = snprintf(texto, tamanho, "%s", votos ? "" : "-");
+    for (int i = 0; i < FUSAO_FONTES && n < (int)tamanho; i++)
+        if (votos & (1u << i))
+            n += snprintf(texto + n, tamanho - n, "%s%s", n ? "+" : "", fusao_nomes[i]);
+}
+
 // ================================================
 // === TELA DE DEPURAÇÃO ==========================
 // ================================================
+// Layout fixo no topo do terminal (lib/tela_serial.h): os rótulos só vão na
+// primeira vez e em "tela"; a cada atualização saem apenas os campos cuja chave
+// (o valor bruto exibido) mudou. Relatórios e console rolam abaixo da tela.
+#define TELA_LINHAS 23
+
+enum
+{
+    CAMPO_TEMP,
+    CAMPO_FOGO,
+    CAMPO_BORDA,
+    CAMPO_TAXA,
+    CAMPO_PONTO_QUENTE,
+    CAMPO_ESTADO,
+    CAMPO_RISCO,
+    CAMPO_ACAO,
+    CAMPO_ALERTA,
+    CAMPO_MINUTO,
+    CAMPO_FUSAO,
+    CAMPO_JOY_X,
+    CAMPO_JOY_Y,
+    CAMPO_LED,
+    CAMPO_QUADRO,
+    CAMPO_QUADRO_PIOR,
+    CAMPO_AMOSTRAGEM,
+    CAMPO_CPU,
+    CAMPO_RESET,
+    CAMPO_BOOT,
+    NUM_CAMPOS_TELA
+};
+
+// Linha, coluna e largura (0 = até o fim da linha) de cada campo, na ordem do enum
+static const uint8_t layout_campos[NUM_CAMPOS_TELA][3] = {
+    {2, 26, 0}, {4, 26, 0}, {5, 26, 0}, {6, 26, 0}, {7, 1, 0}, {8, 26, 0}, {9, 26, 0},
+    {10, 26, 0}, {11, 1, 0}, {12, 26, 0}, {13, 26, 0}, {15, 7, 4}, {15, 22, 4}, {16, 14, 0}, {17, 26, 6},
+    {17, 41, 6}, {18, 26, 0}, {19, 26, 0}, {20, 26, 0}, {21, 25, 0},
+};
+
+void preparar_tela_depuracao(void)
+{
+    tela_iniciar(TELA_LINHAS);
+    tela_rotulo(1, 1, "===== MONITORAMENTO DE TEMPERATURA E INCÊNDIO =====");
+    tela_rotulo(2, 1, "Temperatura Atual:");
+    tela_rotulo(3, 1, "Temperatura de Referência:  0.0 °C");
+    tela_rotulo(4, 1, "Sensor de Chama (IR):");
+    tela_rotulo(5, 1, "Última borda do sensor:");
+    tela_rotulo(6, 1, "Taxa de Elevação:");
+    tela_rotulo(8, 1, "Estado do Sistema:");
+    tela_rotulo(9, 1, "Risco de Incêndio:");
+    tela_rotulo(10, 1, "Ação Recomendada:");
+    tela_rotulo(12, 1, "Último minuto:");
+    tela_rotulo(13, 1, "Fusão dos sensores:");
+    tela_rotulo(14, 1, "Joystick:");
+    tela_rotulo(15, 1, "  X =        |   Y =        |");
+    tela_rotulo(16, 1, "LED RGB:");
+    tela_rotulo(17, 1, "Quadro OLED:");
+    tela_rotulo(17, 32, " µs (pior");
+    tela_rotulo(17, 47, " µs) via");
+    tela_rotulo(17, 56, transporte_oled);
+    tela_rotulo(18, 1, "Amostragem:");
+    tela_rotulo(19, 1, "CPU ocupada:");
+    tela_rotulo(20, 1, "Último reset:");
+    tela_rotulo(21, 1, "Boot (µs desde o reset):");
+    tela_rotulo(22, 1, "===================================================");
+
+    for (int i = 0; i < NUM_CAMPOS_TELA; i++)
+        tela_campo(layout_campos[i][0], layout_campos[i][1], layout_campos[i][2]);
+}
+
+// Décimos da grandeza exibida com uma casa: a chave muda exatamente quando o texto muda
+static inline uint32_t chave_decimos(float valor)
+{
+    return (uint32_t)(int32_t)lroundf(valor * 10.0f);
+}
+
 void show_debug_screen(uint16_t adc_x, uint16_t adc_y, float temp, bool fire_detected)
 {
-    printf("\033[2J\033[H");
-    printf("===== MONITORAMENTO DE TEMPERATURA E INCÊNDIO =====\n");
-    printf("Temperatura Atual:       %.1f °C\n", temp);
-    printf("Temperatura de Referência:  0.0 °C\n");
-    printf("Sensor de Incêndio:      %s\n", fire_detected ? "DETECTADO" : "NORMAL");
+    // Cópia consistente do estado publicado (sem travar o laço de proteção)
+    SystemStatus status;
+    status_ler(&status_publicado, &status);
+
+    // Terminal aberto na USB depois do boot não viu o quadro completo
+    static bool usb_conectado = false;
+    bool usb = stdio_usb_connected();
+    if (usb && !usb_conectado)
+        tela_redesenhar();
+    usb_conectado = usb;
+
+    tela_inicio_quadro();
+    tela_valor(CAMPO_TEMP, chave_decimos(temp), "%.1f °C", temp);
+    tela_valor(CAMPO_FOGO, fire_detected, "%s", fire_detected ? "DETECTADO" : "NORMAL");
+    tela_valor(CAMPO_BORDA, instante_entrada_fogo_us / 1000, "%.3f s", instante_entrada_fogo_us / 1000000.0);
+    tela_valor(CAMPO_TAXA, (uint16_t)status.taxa_subida, "%.1f °C/min", status.taxa_subida / 10.0f);
+
+    int16_t mediana_dc = protecao.ponto_quente.mediana_dc;
+    if (status.canais_quentes)
+        tela_valor(CAMPO_PONTO_QUENTE, (uint64_t)status.canais_quentes << 16 | (uint16_t)mediana_dc,
+                   "Ponto quente:            canais 0x%08lx acima dos vizinhos (mediana %.1f °C)",
+                   (unsigned long)status.canais_quentes, mediana_dc / 10.0f);
+    else
+        tela_valor(CAMPO_PONTO_QUENTE, 0, "%s", "");
 
-    if (temp >= 60.0f)
+    // O estado já foi avaliado no laço principal (limiares + taxa de elevação)
+    uint32_t chave_atual = chave_decimos(status.current_temp);
+    uint32_t chave_taxa = (uint16_t)status.taxa_subida;
+    if (status.state == SYSTEM_CRITICAL)
     {
-        printf("Estado do Sistema:       CRÍTICO\n");
-        printf("Risco de Incêndio:       ALTO\n");
-        printf("Ação Recomendada:        Desligar String Box\n");
-        system_status.state = SYSTEM_CRITICAL;
-        printf("ALERTA: Temperatura Crítica! %.1f°C\n", system_status.current_temp);
+        tela_valor(CAMPO_ESTADO, status.state, "CRÍTICO");
+        tela_valor(CAMPO_RISCO, status.state, "ALTO");
+        tela_valor(CAMPO_ACAO, status.state, "Desligar String Box");
+        if (temp >= 60.0f)
+            tela_valor(CAMPO_ALERTA, 1ull << 32 | chave_atual, "ALERTA: Temperatura Crítica! %.1f°C", status.current_temp);
+        else
+            tela_valor(CAMPO_ALERTA, 2ull << 32 | chave_taxa, "ALERTA: Elevação rápida! %.1f °C/min", status.taxa_subida / 10.0f);
     }
-    else if (temp >= 40.0f)
+    else if (status.state == SYSTEM_ATTENTION)
     {
-        printf("Estado do Sistema:       ATENÇÃO\n");
-        printf("Risco de Incêndio:       BAIXO\n");
-        printf("Ação Recomendada:        Monitorar\n");
-        system_status.state = SYSTEM_ATTENTION;
-        printf("Atenção: Temperatura elevada! %.1f°C\n", system_status.current_temp);
+        tela_valor(CAMPO_ESTADO, status.state, "ATENÇÃO");
+        tela_valor(CAMPO_RISCO, status.state, "BAIXO");
+        tela_valor(CAMPO_ACAO, status.state, "Monitorar");
+        if (temp >= 40.0f)
+            tela_valor(CAMPO_ALERTA, 3ull << 32 | chave_atual, "Atenção: Temperatura elevada! %.1f°C", status.current_temp);
+        else if (status.canais_quentes)
+            tela_valor(CAMPO_ALERTA, 4ull << 32, "Atenção: Ponto quente em relação às outras strings!");
+        else
+            tela_valor(CAMPO_ALERTA, 5ull << 32 | chave_taxa, "Atenção: Temperatura subindo! %.1f °C/min", status.taxa_subida / 10.0f);
     }
     else
     {
-        relatorio = 1;
-        printf("Estado do Sistema:       NORMAL\n");
-        printf("Risco de Incêndio:       NULO\n");
-        printf("Ação Recomendada:        Operação Segura\n");
-        system_status.state = SYSTEM_NORMAL;
-        printf("Temperatura normal: %.1f°C\n", system_status.current_temp);
+        system_status.relatorio = true;
+        tela_valor(CAMPO_ESTADO, status.state, "NORMAL");
+        tela_valor(CAMPO_RISCO, status.state, "NULO");
+        tela_valor(CAMPO_ACAO, status.state, "Operação Segura");
+        tela_valor(CAMPO_ALERTA, 6ull << 32 | chave_atual, "Temperatura normal: %.1f°C", status.current_temp);
     }
 
-    printf("\nJoystick:\n");
-    printf("  X = %4d   |   Y = %4d   |",adc_x, adc_y);
-
-    if (temp >= 60.0f)
-        printf("\nLED RGB:     VERMELHO (Sistema Desligado)\n");
+    hist_bloco_t ultimo_minuto;
+    if (hist_resumo(&historico, HIST_SEGUNDO, 60, &ultimo_minuto))
+    {
+        tela_valor(CAMPO_MINUTO, 1ull << 48 | (uint64_t)(uint16_t)ultimo_minuto.min << 32 |
+                                     (uint32_t)(uint16_t)ultimo_minuto.max << 16 | (uint16_t)ultimo_minuto.media,
+                   "mín %.1f | máx %.1f | média %.1f °C",
+                   ultimo_minuto.min / 10.0f, ultimo_minuto.max / 10.0f, ultimo_minuto.media / 10.0f);
+    }
     else
-        printf("\nLED RGB:     VERDE (Sistema Ligado)\n");
+        tela_valor(CAMPO_MINUTO, 0, "%s", "");
 
-    if (temp < 40) relatorio = 0;
+    // Fusão: pontuação contra o limiar, fontes votando e confirmação em andamento
+    const fusao_t *fusao = &protecao.fusao;
+    uint64_t chave_fusao = (uint64_t)fusao->config.limiar << 32 | (uint32_t)status.fusao_pontuacao << 16 |
+                           (uint32_t)status.fusao_votos << 8 | fusao->suspeita << 1 | status.fire_detected;
+    if (tela_pendente(CAMPO_FUSAO, chave_fusao))
+    {
+        char votos[48];
+        descrever_votos(votos, sizeof(votos), status.fusao_votos);
+        tela_valor(CAMPO_FUSAO, chave_fusao, "%u/%u, votos: %s%s", status.fusao_pontuacao, fusao->config.limiar, votos,
+                   status.fire_detected ? " (INCÊNDIO)" : fusao->suspeita ? " (confirmando)" : "");
+    }
 
-    printf("===================================================\n");
+    tela_valor(CAMPO_JOY_X, adc_x, "%4d", adc_x);
+    tela_valor(CAMPO_JOY_Y, adc_y, "%4d", adc_y);
 
-    if (relatorio || (temp >= 60.0f || system_status.fire_detected))
+    if (status.state == SYSTEM_CRITICAL)
+        tela_valor(CAMPO_LED, 1, "VERMELHO (Sistema Desligado)");
+    else
+        tela_valor(CAMPO_LED, 0, "VERDE (Sistema Ligado)");
+
+    if (status.state == SYSTEM_NORMAL) system_status.relatorio = false;
+
+    tela_valor(CAMPO_QUADRO, tempo_quadro_us, "%6lu", (unsigned long)tempo_quadro_us);
+    tela_valor(CAMPO_QUADRO_PIOR, tempo_quadro_max_us, "%6lu", (unsigned long)tempo_quadro_max_us);
+
+    // Período configurado e maior intervalo atingido no nível atual (períodos vão até 2000 ms)
+    float ciclos_s = ritmo_ciclos_por_s(&ritmo);
+    uint32_t intervalo_max = ritmo.intervalo_max_ms[ritmo.nivel];
+    tela_valor(CAMPO_AMOSTRAGEM,
+               (uint64_t)ritmo.nivel << 60 | (uint64_t)(ritmo_periodo_ms(&ritmo) & 0xFFF) << 48 |
+                   (uint64_t)(intervalo_max & 0xFFFF) << 32 | chave_decimos(ciclos_s),
+               "%s a %u ms (máx %lu ms, %.1f ciclos/s)", ritmo_nomes[ritmo.nivel], ritmo_periodo_ms(&ritmo),
+               (unsigned long)intervalo_max, ciclos_s);
+    float cpu = 100.0f * ocupado_us / (float)(time_us_64() - metricas_inicio_us);
+    uint32_t mhz = clock_get_hz(clk_sys) / 1000000u;
+    tela_valor(CAMPO_CPU, (uint64_t)mhz << 32 | chave_decimos(cpu), "%.1f %% a %lu MHz%s", cpu, (unsigned long)mhz,
+               em_repouso ? " (repouso: OLED e matriz apagados)" : "");
+
+    bool disparo_restaurado = estado_restaurado && estado_retido.protecao.estado == SYSTEM_CRITICAL;
+    tela_valor(CAMPO_RESET, (uint64_t)disparo_restaurado << 40 | (uint64_t)vigia_resets_watchdog() << 8 | vigia_motivo_reset(),
+               "%s (travamentos: %u)%s", vigia_nome_reset(vigia_motivo_reset()),
+               vigia_resets_watchdog(), disparo_restaurado ? " | disparo restaurado" : "");
+
+    // Fixo após o boot: só é montado nos redesenhos
+    if (tela_pendente(CAMPO_BOOT, 0))
     {
-        gerar_relatorio_evento(system_status);
-        relatorio = 1;
+        char boot[96];
+        int n = 0;
+        for (int i = 0; i < BOOT_NUM_FASES && n < (int)sizeof(boot); i++)
+            n += snprintf(boot + n, sizeof(boot) - n, " %s %lu%s", boot_nomes[i], (unsigned long)boot_marcas_us[i],
+                          i + 1 < BOOT_NUM_FASES ? " |" : "");
+        tela_valor(CAMPO_BOOT, 0, "%s", boot);
+    }
+    tela_fim_quadro();
+
+    if (system_status.relatorio || (status.state == SYSTEM_CRITICAL || status.fire_detected))
+    {
+        gerar_relatorio_evento(status);
+        system_status.relatorio = true;
     }
 }
 
@@ -502,33 +1158,37 @@ void show_debug_screen(uint16_t adc_x, uint16_t adc_y, float temp, bool fire_det
 // ================================================
 void update_led_matrix(void)
 {
-    static uint32_t last_update = 0;
-
-    if (system_status.current_temp >= 60.0f || system_status.fire_detected)
+    // Fogo detectado já leva o estado a CRÍTICO (lib/protecao.c)
+    if (system_status.state == SYSTEM_CRITICAL)
     {
-        set_rgb_led(0, 0, 255); // azul
+        efeitos_led_aplicar(EFEITO_PISCAR, 0, 0, 255); // azul piscando
         buzzer_alerta_incendio();
 
-        if (countdown <= 0)
-        {
-            vermelho();
-            countdown = 0;
-        }
+        // Dígito da contagem regressiva calculada pela proteção (inclusive a retomada
+        // após um reset) e, depois do desligamento, vermelho piscante
+        if (system_status.countdown > 0)
+            animacao_fixar((quadro_matriz_t)(QUADRO_NUM0 + system_status.countdown));
         else
-        {
-            Num(countdown);
-            countdown--;
-        }
-    }
-    else if (system_status.current_temp >= 40.0f)
-    {
-        amarelo();
+            animacao_tocar(&SEQ_CRITICO);
     }
     else
     {
-        verde();
-        set_rgb_led(255, 0, 0); // verde
-        countdown = 9;
+        // Fora do CRÍTICO local a matriz mostra o pior entre a caixa local e a pior
+        // caixa remota do concentrador; o buzzer e o LED RGB seguem só a caixa local
+        uint8_t gravidade = remota_valida ? agregador_gravidade(&pior_remota) : 0;
+        if (gravidade == 4)
+            animacao_tocar(&SEQ_REMOTO_CRITICO);
+        else if (system_status.state == SYSTEM_ATTENTION || gravidade == 2)
+            animacao_tocar(&SEQ_ATENCAO);
+        else if (gravidade == 3)
+            animacao_tocar(&SEQ_REMOTO_FALHA);
+        else
+            animacao_tocar(&SEQ_NORMAL);
+
+        if (system_status.state == SYSTEM_ATTENTION)
+            efeitos_led_aplicar(EFEITO_FADE, 255, 0, 0); // verde em fade
+        else
+            efeitos_led_aplicar(EFEITO_RESPIRAR, 255, 0, 0); // verde respirando
     }
 }
 
@@ -546,3 +1206,140 @@ void update_rgb_led(void)
         printNum();
     }
 }
+
+// ================================================
+// === MÉTRICAS DA AMOSTRAGEM ADAPTATIVA ==========
+// ================================================
+void comando_ritmo(const char *argumento)
+{
+    if (argumento && strcmp(argumento, "zerar") == 0)
+    {
+        ritmo_zerar(&ritmo);
+        metricas_inicio_us = time_us_64();
+        ocupado_us = 0;
+        protecao_us = 0;
+        printf("ritmo: métricas zeradas\n");
+        return;
+    }
+
+    uint64_t decorrido_us = time_us_64() - metricas_inicio_us;
+    uint64_t total_ms = 0;
+    for (int n = 0; n < RITMO_NIVEIS; n++)
+        total_ms += ritmo.tempo_ms[n];
+
+    printf("ritmo: nível %s (%u ms), %.1f ciclos/s em média\n", ritmo_nomes[ritmo.nivel],
+           ritmo_periodo_ms(&ritmo), ritmo_ciclos_por_s(&ritmo));
+    // Intervalos atingidos (médio e máximo) ao lado do configurado; a pior latência vem do máximo
+    printf("  %-10s %8s %8s %10s %10s %8s %8s %9s %12s\n", "nível", "período", "tempo", "ciclos", "ciclos/s",
+           "médio", "máximo", "atrasados", "pior latência");
+    for (int n = 0; n < RITMO_NIVEIS; n++)
+    {
+        float tempo_pct = total_ms ? 100.0f * ritmo.tempo_ms[n] / (float)total_ms : 0.0f;
+        float ciclos_s = ritmo.tempo_ms[n] ? ritmo.ciclos[n] * 1000.0f / (float)ritmo.tempo_ms[n] : 0.0f;
+        float medio_ms = ciclos_s > 0.0f ? 1000.0f / ciclos_s : 0.0f;
+        printf("  %-10s %5u ms %7.1f%% %10lu %10.1f %5.1f ms %5lu ms %9lu %9lu ms\n", ritmo_nomes[n],
+               ritmo.config.periodo_ms[n], tempo_pct, (unsigned long)ritmo.ciclos[n], ciclos_s, medio_ms,
+               (unsigned long)ritmo.intervalo_max_ms[n], (unsigned long)ritmo.atrasados[n],
+               (unsigned long)ritmo_pior_latencia_ms(&ritmo, (ritmo_nivel_t)n));
+    }
+
+    // O ADC segue a 1 kHz por causa do pré-disparo; o que varia é o custo da proteção
+    uint32_t conversoes_s = CAPTURA_TAXA_HZ * captura_entradas();
+    printf("  CPU ocupada %.2f%% (proteção %.3f%%) | ADC %lu conversões/s, %.2f%% ocupado\n",
+           decorrido_us ? 100.0f * ocupado_us / (float)decorrido_us : 0.0f,
+           decorrido_us ? 100.0f * protecao_us / (float)decorrido_us : 0.0f,
+           (unsigned long)conversoes_s, conversoes_s * ADC_CONVERSAO_US / 10000.0f);
+
+    uint64_t ligado_us = time_us_64();
+    printf("  Repouso %s: %lu entradas, %.1f%% do tempo desde o boot, religar o PLL %lu µs (pior)\n",
+           em_repouso ? "ATIVO" : "inativo", (unsigned long)economia_entradas(),
+           ligado_us ? 100.0f * economia_tempo_us() / (float)ligado_us : 0.0f, (unsigned long)economia_pior_saida_us());
+}
+
+// ================================================
+// === COMANDO "tela" DO CONSOLE ==================
+// ================================================
+void comando_tela(const char *argumento)
+{
+    static uint32_t bytes_anteriores = 0;
+    static uint64_t instante_anterior_us = 0;
+
+    if (!argumento || strcmp(argumento, "taxa") != 0)
+    {
+        tela_redesenhar();   // Quadro completo na próxima atualização
+        return;
+    }
+
+    // Bytes/s da tela desde a última consulta, comparados ao quadro completo a cada atualização
+    uint64_t agora = time_us_64();
+    uint32_t bytes = tela_bytes();
+    float segundos = (agora - instante_anterior_us) / 1000000.0f;
+    float atualizacoes_s = 1000000.0f / (float)config_atual()->intervalo_tela_us;
+    printf("tela: %.0f B/s (quadro completo: %lu B, %.0f B/s se redesenhado a cada atualização)\n",
+           segundos > 0.0f ? (bytes - bytes_anteriores) / segundos : 0.0f,
+           (unsigned long)tela_bytes_redesenho(), tela_bytes_redesenho() * atualizacoes_s);
+    bytes_anteriores = bytes;
+    instante_anterior_us = agora;
+}
+
+// ================================================
+// === CONCENTRADOR RS-485 ========================
+// ================================================
+const char *descrever_caixa(const agregador_caixa_t *caixa)
+{
+    if (caixa->estado == SYSTEM_CRITICAL || caixa->fogo)
+        return "CRIT";
+    if (agregador_sem_resposta(caixa))
+        return "MUDA";
+    if (caixa->estado == SYSTEM_ATTENTION)
+        return "ATEN";
+    return caixa->estado == SYSTEM_NORMAL ? "NORM" : "----";
+}
+
+void desenhar_concentrador(ssd1306_t *ssd)
+{
+    char linha[17];   // 16 caracteres de 8 px
+    if (pior_remota.estado == AGREGADOR_SEM_DADOS)
+        snprintf(linha, sizeof(linha), "CX%02u %s", pior_remota.escravo, descrever_caixa(&pior_remota));
+    else
+        snprintf(linha, sizeof(linha), "CX%02u %s %5.1fC", pior_remota.escravo, descrever_caixa(&pior_remota),
+                 pior_remota.temp_dc / 10.0f);
+    ssd1306_draw_string(ssd, linha, 4, 4);
+    snprintf(linha, sizeof(linha), "%u/%u online", caixas_online, caixas_total);
+    ssd1306_draw_string(ssd, linha, 4, HEIGHT - 12);
+}
+
+void comando_rede(const char *argumento)
+{
+    static agregador_caixa_t caixas[AGREGADOR_MAX_CAIXAS];
+    agregador_estatisticas_t e;
+    uint8_t n = agregador_rs485_tabela(caixas, &e);
+    if (n == 0)
+    {
+        printf("rede: concentrador desligado (set agregador_caixas <n>, salvar e reiniciar)\n");
+        return;
+    }
+
+    uint32_t agora_ms = (uint32_t)(time_us_64() / 1000);
+    printf("rede: %u caixas a %lu baud, %lu ciclos\n", n, (unsigned long)config_atual()->modbus_baud,
+           (unsigned long)e.ciclos);
+    if (e.ciclos > 0)
+        printf("  ciclo: último %.1f ms, mín %.1f ms, médio %.1f ms, máx %.1f ms\n", e.ciclo_us / 1000.0f,
+               e.ciclo_min_us / 1000.0f, e.ciclo_soma_us / 1000.0f / e.ciclos, e.ciclo_max_us / 1000.0f);
+    printf("  requisições %lu, respostas %lu, timeouts %lu, erros %lu\n", (unsigned long)e.requisicoes,
+           (unsigned long)e.respostas, (unsigned long)e.timeouts, (unsigned long)e.erros);
+    printf("  %-4s %-6s %7s %9s %6s %5s %6s %10s\n", "cx", "nível", "temp", "taxa/min", "fusão", "cont", "falhas", "há");
+    for (uint8_t i = 0; i < n; i++)
+    {
+        const agregador_caixa_t *c = &caixas[i];
+        if (c->estado == AGREGADOR_SEM_DADOS)
+        {
+            printf("  %-4u %-6s %7s %9s %6s %5s %6u %10s\n", c->escravo, descrever_caixa(c), "-", "-", "-", "-",
+                   c->falhas, "-");
+            continue;
+        }
+        printf("  %-4u %-6s %6.1fC %9.1f %3u/%u %5d %6u %7lu ms\n", c->escravo, descrever_caixa(c), c->temp_dc / 10.0f,
+               c->taxa_dc_min / 10.0f, c->fusao_pontuacao, c->fusao_votos, c->contagem, c->falhas,
+               (unsigned long)(agora_ms - c->resposta_ms));
+    }
+}
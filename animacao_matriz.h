@@ -0,0 +1,184 @@
+#ifndef ANIMACAO_MATRIZ_H
+#define ANIMACAO_MATRIZ_H
+
+// ANIMAÇÕES POR QUADROS-CHAVE NA MATRIZ DE LEDS 5x5
+// Cada sequência é uma lista constante (em flash) de quadros-chave: sprite, tempo
+// de permanência e brilho. O tocador avança os quadros a partir de um alarme de
+// hardware, sem alocação e sem depender do laço principal. npWrite só dispara o
+// DMA do quadro, então o alarme não segura a IRQ compartilhada com a captura de
+// 1 kHz, os tempos de quadro do Modbus e os prazos do concentrador.
+// Requer numeros.h incluído antes (sprites, desenhaSpriteBrilho e npWrite).
+
+#include "pico/time.h"
+
+// Índices dos sprites disponíveis para os quadros-chave
+typedef enum
+{
+    QUADRO_NUM0,
+    QUADRO_NUM1,
+    QUADRO_NUM2,
+    QUADRO_NUM3,
+    QUADRO_NUM4,
+    QUADRO_NUM5,
+    QUADRO_NUM6,
+    QUADRO_NUM7,
+    QUADRO_NUM8,
+    QUADRO_NUM9,
+    QUADRO_VERDE,
+    QUADRO_AMARELO,
+    QUADRO_VERMELHO,
+    QUADRO_APAGADO
+} quadro_matriz_t;
+
+typedef struct
+{
+    uint8_t quadro;         // quadro_matriz_t
+    uint16_t duracao_ms;    // Tempo de permanência do quadro
+    uint8_t brilho;         // 0–255, relativo ao brilho global da matriz
+} keyframe_t;
+
+typedef struct sequencia_matriz
+{
+    const keyframe_t *quadros;
+    uint8_t total;
+    const struct sequencia_matriz *proxima;   // Ao terminar: NULL repete, senão encadeia
+} sequencia_matriz_t;
+
+static const uint8_t (*const sprites_matriz[])[5][3] = {
+    Num0, Num1, Num2, Num3, Num4, Num5, Num6, Num7, Num8, Num9,
+    CorVerde, CorAmarela, CorVermelha, OFF};
+
+#define BRILHO_PLENO 255   // Brilho global da matriz (ver animacao_definir_brilho)
+
+// --- Sequências pré-compiladas ---
+static const keyframe_t kf_normal[] = {
+    {QUADRO_VERDE, 150, BRILHO_PLENO},
+    {QUADRO_APAGADO, 150, 0},
+    {QUADRO_VERDE, 150, BRILHO_PLENO},
+    {QUADRO_APAGADO, 2550, 0}};
+
+static const keyframe_t kf_atencao[] = {
+    {QUADRO_AMARELO, 500, BRILHO_PLENO},
+    {QUADRO_APAGADO, 500, 0}};
+
+static const keyframe_t kf_critico[] = {
+    {QUADRO_VERMELHO, 250, BRILHO_PLENO},
+    {QUADRO_APAGADO, 250, 0}};
+
+// Pior caixa remota do concentrador (caixa local em NORMAL): piscada dupla
+static const keyframe_t kf_remoto_critico[] = {
+    {QUADRO_VERMELHO, 150, BRILHO_PLENO},
+    {QUADRO_APAGADO, 150, 0},
+    {QUADRO_VERMELHO, 150, BRILHO_PLENO},
+    {QUADRO_APAGADO, 550, 0}};
+
+static const keyframe_t kf_remoto_falha[] = {
+    {QUADRO_AMARELO, 150, BRILHO_PLENO},
+    {QUADRO_APAGADO, 150, 0},
+    {QUADRO_AMARELO, 150, BRILHO_PLENO},
+    {QUADRO_APAGADO, 1550, 0}};
+
+static const sequencia_matriz_t SEQ_NORMAL = {kf_normal, count_of(kf_normal), NULL};
+static const sequencia_matriz_t SEQ_ATENCAO = {kf_atencao, count_of(kf_atencao), NULL};
+static const sequencia_matriz_t SEQ_CRITICO = {kf_critico, count_of(kf_critico), NULL};
+static const sequencia_matriz_t SEQ_REMOTO_CRITICO = {kf_remoto_critico, count_of(kf_remoto_critico), NULL};
+static const sequencia_matriz_t SEQ_REMOTO_FALHA = {kf_remoto_falha, count_of(kf_remoto_falha), NULL};
+
+// --- Estado do tocador ---
+static const sequencia_matriz_t *volatile seq_atual = NULL;
+static volatile uint8_t passo_atual = 0;
+static int8_t quadro_fixo = -1;   // Quadro de animacao_fixar (-1: nenhum)
+static alarm_id_t alarme_animacao = 0;
+static volatile uint8_t brilho_global = 3;   // 3 equivale à antiga intensidade 0.01
+
+static void mostrar_keyframe(const keyframe_t *kf)
+{
+    desenhaSpriteBrilho(sprites_matriz[kf->quadro], (uint8_t)((kf->brilho * brilho_global) / 255));
+    npWrite();
+}
+
+// Callback do alarme: avança para o próximo quadro e reagenda pelo tempo dele
+static int64_t animacao_tick(alarm_id_t id, void *dados)
+{
+    const sequencia_matriz_t *seq = seq_atual;
+    if (!seq)
+        return 0;   // Trocada por um quadro fixo
+    uint8_t passo = passo_atual + 1;
+
+    if (passo >= seq->total)
+    {
+        passo = 0;
+        if (seq->proxima)
+            seq = seq->proxima;
+    }
+
+    seq_atual = seq;
+    passo_atual = passo;
+    mostrar_keyframe(&seq->quadros[passo]);
+
+    // Valor negativo: reagenda relativo ao disparo anterior (sem deriva)
+    return -(int64_t)seq->quadros[passo].duracao_ms * 1000;
+}
+
+// Inicia uma sequência; não faz nada se ela já estiver tocando
+void animacao_tocar(const sequencia_matriz_t *seq)
+{
+    if (seq == seq_atual)
+        return;
+
+    if (alarme_animacao > 0)
+        cancel_alarm(alarme_animacao);
+    alarme_animacao = 0;
+
+    quadro_fixo = -1;
+    seq_atual = seq;
+    passo_atual = 0;
+    mostrar_keyframe(&seq->quadros[0]);
+    alarme_animacao = add_alarm_in_ms(seq->quadros[0].duracao_ms, animacao_tick, NULL, true);
+}
+
+// Mostra um quadro fixo escolhido pelo chamador, sem alarme (ex: o dígito da
+// contagem regressiva, que vem da lógica de proteção); não faz nada se já estiver nele
+void animacao_fixar(quadro_matriz_t quadro)
+{
+    if (seq_atual == NULL && quadro_fixo == (int8_t)quadro)
+        return;
+
+    if (alarme_animacao > 0)
+        cancel_alarm(alarme_animacao);
+    alarme_animacao = 0;
+
+    seq_atual = NULL;
+    quadro_fixo = (int8_t)quadro;
+    const keyframe_t kf = {quadro, 0, BRILHO_PLENO};
+    mostrar_keyframe(&kf);
+}
+
+// Interrompe a animação e apaga a matriz
+void animacao_parar(void)
+{
+    if (alarme_animacao > 0)
+        cancel_alarm(alarme_animacao);
+    alarme_animacao = 0;
+    seq_atual = NULL;
+    quadro_fixo = -1;
+    DesligaMatriz();
+}
+
+// Define o brilho global (0–255); vale a partir do próximo quadro
+void animacao_definir_brilho(uint8_t brilho)
+{
+    brilho_global = brilho;
+}
+
+const sequencia_matriz_t *animacao_atual(void)
+{
+    return seq_atual;
+}
+
+uint8_t animacao_passo(void)
+{
+    return passo_atual;
+}
+
+#endif // ANIMACAO_MATRIZ_H
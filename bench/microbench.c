@@ -0,0 +1,271 @@
+// ================================================
+// === MICROBENCHMARK NO HARDWARE =================
+// ================================================
+// Imagem separada do firmware (alvo "microbench" no CMakeLists.txt) que roda
+// uma suíte fixa sobre as mesmas bibliotecas: desenho e envio do OLED, matriz
+// WS2812, conversão do NTC e ADC. Cada caso é repetido em várias rodadas e o
+// resultado sai pela USB em CSV, um caso por linha, para comparar versões com
+// tools/comparar_bench.py. Qualquer tecla recebida roda a suíte de novo.
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/i2c.h"
+#include "hardware/spi.h"
+
+#include "lib/ssd1306.h"
+#include "lib/ntc.h"
+#include "lib/ponto_quente.h"
+#include "lib/fusao.h"
+#include "numeros.h"
+
+// Mesma pinagem do firmware principal
+#define I2C_PORT i2c1
+#define I2C_SDA 14
+#define I2C_SCL 15
+#define OLED_ENDERECO 0x3C
+
+#ifndef OLED_SPI
+#define OLED_SPI 0
+#endif
+#define OLED_SPI_PORT spi0
+#define OLED_SPI_SCK 18
+#define OLED_SPI_MOSI 19
+#define OLED_SPI_CS 17
+#define OLED_SPI_DC 16
+
+#define MATRIZ_LED_PIN 7
+#define ADC_TEMP_PIN 26   // Eixo X do joystick (simula o NTC)
+
+#define BENCH_RODADAS 7         // Rodadas por caso (mínimo, mediana e máximo)
+#define BENCH_ESPERA_USB_MS 10000
+
+typedef struct
+{
+    const char *nome;
+    uint32_t iteracoes;    // Chamadas por rodada
+    void (*executar)(uint32_t iteracoes);
+} caso_bench_t;
+
+static ssd1306_t ssd;
+static volatile int32_t descarte;   // Evita que o compilador elimine o trabalho medido
+
+// ===============================
+// === CASOS ======================
+// ===============================
+static void bench_fill(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        ssd1306_fill(&ssd, i & 1);
+}
+
+static void bench_rect(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        ssd1306_rect(&ssd, 2, 2, WIDTH - 4, HEIGHT - 4, true, i & 1);
+}
+
+static void bench_draw_string(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        ssd1306_draw_string(&ssd, "TEMP 25 C", 0, 0);
+}
+
+static void bench_send_quadro(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        ssd1306_send_data(&ssd);
+}
+
+static void bench_send_parcial(uint32_t n)
+{
+    // 16 colunas: a área de um valor numérico atualizado na tela
+    for (uint32_t i = 0; i < n; i++)
+        ssd1306_send_data_parcial(&ssd, 0, 15);
+}
+
+static void bench_sprite(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        desenhaSprite(i & 1 ? Num8 : OFF, 0.01);
+        npWrite();
+    }
+}
+
+// read_temperature do firmware é exatamente a conversão pela tabela do NTC
+static void bench_ntc(uint32_t n)
+{
+    int32_t soma = 0;
+    for (uint32_t i = 0; i < n; i++)
+        soma += ntc_adc_para_dc((uint16_t)(i & 4095));
+    descarte = soma;
+}
+
+// Ponto quente entre strings: ~18 °C com ruído e um canal 15 °C acima
+static void bench_ponto_quente(uint8_t canais, uint32_t n)
+{
+    static ponto_quente_t pq;
+    static int16_t temps[PONTO_QUENTE_MAX_CANAIS];
+    const ponto_quente_config_t config = PONTO_QUENTE_CONFIG_PADRAO;
+
+    ponto_quente_iniciar(&pq, &config);
+    for (uint8_t i = 0; i < canais; i++)
+        temps[i] = 180 + (int16_t)((i * 7) % 11) - 5;
+    temps[canais / 3] += 150;
+
+    uint32_t mascara = 0;
+    for (uint32_t i = 0; i < n; i++)
+        mascara |= ponto_quente_avaliar(&pq, i * 100u, temps, canais);
+    descarte = (int32_t)mascara;
+}
+
+static void bench_ponto_quente_8(uint32_t n)
+{
+    bench_ponto_quente(8, n);
+}
+
+static void bench_ponto_quente_16(uint32_t n)
+{
+    bench_ponto_quente(16, n);
+}
+
+static void bench_ponto_quente_32(uint32_t n)
+{
+    bench_ponto_quente(32, n);
+}
+
+// Fusão com as quatro fontes mudando a cada avaliação (custo constante por ciclo)
+static void bench_fusao(uint32_t n)
+{
+    static fusao_t f;
+    const fusao_config_t config = FUSAO_CONFIG_PADRAO;
+    fusao_iniciar(&f, &config);
+
+    uint32_t decisoes = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint8_t evidencia[FUSAO_FONTES] = {(uint8_t)(i & 1 ? 100 : 0), fusao_evidencia((int32_t)(i & 4095), 2600, 3600),
+                                           (uint8_t)(i % 101), (uint8_t)((i * 7) % 101)};
+        decisoes += fusao_avaliar(&f, i, evidencia);
+    }
+    descarte = (int32_t)decisoes;
+}
+
+static void bench_adc(uint32_t n)
+{
+    int32_t soma = 0;
+    adc_select_input(0);
+    for (uint32_t i = 0; i < n; i++)
+        soma += adc_read();
+    descarte = soma;
+}
+
+static const caso_bench_t casos[] = {
+    {"ssd1306_fill", 1000, bench_fill},
+    {"ssd1306_rect", 1000, bench_rect},
+    {"ssd1306_draw_string", 1000, bench_draw_string},
+    {"ssd1306_send_data", 20, bench_send_quadro},
+    {"ssd1306_send_data_parcial16", 100, bench_send_parcial},
+    {"desenhaSprite+npWrite", 50, bench_sprite},
+    {"read_temperature", 10000, bench_ntc},
+    {"ponto_quente_8", 1000, bench_ponto_quente_8},
+    {"ponto_quente_16", 1000, bench_ponto_quente_16},
+    {"ponto_quente_32", 1000, bench_ponto_quente_32},
+    {"fusao_avaliar", 10000, bench_fusao},
+    {"adc_read", 10000, bench_adc},
+};
+
+// ===============================
+// === EXECUÇÃO E RELATÓRIO =======
+// ===============================
+static void ordenar(uint32_t *v, int n)
+{
+    for (int i = 1; i < n; i++)
+    {
+        uint32_t x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x)
+        {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+}
+
+static void rodar_suite(void)
+{
+    uint32_t mhz = clock_get_hz(clk_sys) / 1000000u;
+
+    printf("# microbench clk_sys_mhz=%lu oled=%s rodadas=%d\n",
+           (unsigned long)mhz, ssd.transporte->nome, BENCH_RODADAS);
+    printf("caso,iteracoes,min_ns,mediana_ns,max_ns,ciclos\n");
+    uint32_t mediana_adc_ns = 0;
+
+    for (uint i = 0; i < count_of(casos); i++)
+    {
+        const caso_bench_t *c = &casos[i];
+        uint32_t ns[BENCH_RODADAS];
+
+        c->executar(1);   // Aquece cache do XIP e periféricos fora da medida
+        for (int r = 0; r < BENCH_RODADAS; r++)
+        {
+            uint64_t inicio = time_us_64();
+            c->executar(c->iteracoes);
+            uint64_t total_us = time_us_64() - inicio;
+            ns[r] = (uint32_t)((total_us * 1000u) / c->iteracoes);
+        }
+
+        ordenar(ns, BENCH_RODADAS);
+        uint32_t mediana = ns[BENCH_RODADAS / 2];
+        printf("%s,%lu,%lu,%lu,%lu,%lu\n", c->nome, (unsigned long)c->iteracoes,
+               (unsigned long)ns[0], (unsigned long)mediana, (unsigned long)ns[BENCH_RODADAS - 1],
+               (unsigned long)((mediana * mhz) / 1000u));
+        if (c->executar == bench_adc)
+            mediana_adc_ns = mediana;
+    }
+
+    // Taxa de conversão do ADC (uma conversão por adc_read)
+    if (mediana_adc_ns > 0)
+        printf("# adc_amostras_por_s=%lu\n", (unsigned long)(1000000000u / mediana_adc_ns));
+    printf("# fim\n");
+}
+
+int main(void)
+{
+    stdio_init_all();
+
+    adc_init();
+    adc_gpio_init(ADC_TEMP_PIN);
+    npInit(MATRIZ_LED_PIN);
+
+#if OLED_SPI
+    spi_init(OLED_SPI_PORT, SSD1306_SPI_HZ);
+    gpio_set_function(OLED_SPI_SCK, GPIO_FUNC_SPI);
+    gpio_set_function(OLED_SPI_MOSI, GPIO_FUNC_SPI);
+    ssd1306_init_spi(&ssd, WIDTH, HEIGHT, false, OLED_SPI_PORT, OLED_SPI_DC, OLED_SPI_CS);
+#else
+    i2c_init(I2C_PORT, 400 * 1000);
+    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(I2C_SDA);
+    gpio_pull_up(I2C_SCL);
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, OLED_ENDERECO, I2C_PORT);
+#endif
+    ssd1306_config(&ssd);
+
+    // Espera o terminal abrir a porta USB (ou segue pela UART após o prazo)
+    uint64_t limite = time_us_64() + BENCH_ESPERA_USB_MS * 1000ull;
+    while (!stdio_usb_connected() && time_us_64() < limite)
+        sleep_ms(100);
+
+    while (true)
+    {
+        rodar_suite();
+        while (getchar_timeout_us(1000000) == PICO_ERROR_TIMEOUT)
+            tight_loop_contents();
+    }
+}
@@ -0,0 +1,37 @@
+# Tabela de linearização do NTC gerada em tempo de compilação (ADC -> décimos de °C)
+# Para usar Steinhart-Hart, defina NTC_STEINHART com os coeficientes "A;B;C"
+# Compartilhado pelo firmware e pelas ferramentas de host (tools/CMakeLists.txt)
+set(NTC_BETA 3950 CACHE STRING "Coeficiente Beta do NTC")
+set(NTC_R25 10000 CACHE STRING "Resistencia do NTC a 25 C (ohms)")
+set(NTC_R_SERIE 10000 CACHE STRING "Resistor do divisor com o NTC (ohms)")
+set(NTC_STEINHART "" CACHE STRING "Coeficientes Steinhart-Hart A;B;C (opcional)")
+
+set(NTC_GERADOR ${CMAKE_CURRENT_LIST_DIR}/../tools/gerar_tabela_ntc.py)
+
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+# Gera ntc_tabela.h no diretório de build e o adiciona aos includes do alvo;
+# vários alvos (firmware, microbench) compartilham a mesma regra de geração
+function(ntc_gerar_tabela alvo)
+    set(dir ${CMAKE_CURRENT_BINARY_DIR}/gerado)
+
+    if (NOT TARGET ntc_tabela)
+        set(args --beta ${NTC_BETA} --r25 ${NTC_R25} --r-serie ${NTC_R_SERIE})
+        if (NTC_STEINHART)
+            list(APPEND args --steinhart ${NTC_STEINHART})
+        endif()
+
+        add_custom_command(
+            OUTPUT ${dir}/ntc_tabela.h
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${dir}
+            COMMAND Python3::Interpreter ${NTC_GERADOR} ${args} -o ${dir}/ntc_tabela.h
+            DEPENDS ${NTC_GERADOR}
+            COMMENT "Gerando tabela de linearizacao do NTC"
+            VERBATIM
+        )
+        add_custom_target(ntc_tabela DEPENDS ${dir}/ntc_tabela.h)
+    endif()
+
+    add_dependencies(${alvo} ntc_tabela)
+    target_include_directories(${alvo} PRIVATE ${dir})
+endfunction()
@@ -0,0 +1,195 @@
+#include "agregador.h"
+
+#include <string.h>
+
+#include "modbus.h"
+
+#define FC_LER_ENTRADA 0x04
+
+void agregador_iniciar(agregador_t *a, const agregador_config_t *config, uint8_t primeiro, uint8_t n,
+                       agregador_enviar_t enviar, void *contexto, uint64_t agora_us)
+{
+    memset(a, 0, sizeof(*a));
+    a->config = *config;
+    if (a->config.tentativas == 0)
+        a->config.tentativas = 1;
+    a->enviar = enviar;
+    a->contexto = contexto;
+    a->num_caixas = n < AGREGADOR_MAX_CAIXAS ? n : AGREGADOR_MAX_CAIXAS;
+    a->silencio_us = modbus_silencio_us(config->baud);
+
+    // Requisições prontas: o envio é só entregar 8 bytes ao transporte
+    for (uint8_t i = 0; i < a->num_caixas; i++)
+    {
+        agregador_caixa_t *c = &a->caixas[i];
+        c->escravo = (uint8_t)(primeiro + i);
+        c->estado = AGREGADOR_SEM_DADOS;
+        modbus_montar_leitura(a->requisicoes[i], c->escravo, false, 0, AGREGADOR_REGS);
+    }
+
+    a->estatisticas.ciclo_min_us = UINT32_MAX;
+    a->atual = 0;
+    a->inicio_ciclo_us = agora_us;
+    a->prazo_us = agora_us;
+}
+
+uint8_t agregador_gravidade(const agregador_caixa_t *c)
+{
+    if (c->estado == SYSTEM_CRITICAL || c->fogo)
+        return 4;
+    if (agregador_sem_resposta(c))
+        return 3;
+    if (c->estado == SYSTEM_ATTENTION)
+        return 2;
+    return c->estado == AGREGADOR_SEM_DADOS ? 0 : 1;
+}
+
+// Caixa sem resposta fica fora da maioria dos ciclos, escalonada pelo índice
+static bool consultar_no_ciclo(const agregador_t *a, uint8_t i)
+{
+    return !agregador_sem_resposta(&a->caixas[i]) ||
+           (a->estatisticas.ciclos + i) % AGREGADOR_RECONSULTA_CICLOS == 0;
+}
+
+static void fim_de_ciclo(agregador_t *a, uint64_t agora_us)
+{
+    agregador_estatisticas_t *e = &a->estatisticas;
+    uint32_t duracao = (uint32_t)(agora_us - a->inicio_ciclo_us);
+    e->ciclos++;
+    e->ciclo_us = duracao;
+    e->ciclo_soma_us += duracao;
+    if (duracao < e->ciclo_min_us)
+        e->ciclo_min_us = duracao;
+    if (duracao > e->ciclo_max_us)
+        e->ciclo_max_us = duracao;
+
+    uint8_t pior = 0;
+    for (uint8_t i = 1; i < a->num_caixas; i++)
+    {
+        const agregador_caixa_t *c = &a->caixas[i];
+        const agregador_caixa_t *p = &a->caixas[pior];
+        uint8_t g = agregador_gravidade(c), gp = agregador_gravidade(p);
+        if (g > gp || (g == gp && c->temp_dc > p->temp_dc))
+            pior = i;
+    }
+    a->pior = pior;
+
+    // Próximo ciclo no período configurado, ou já após o silêncio entre quadros
+    uint64_t proximo = a->inicio_ciclo_us + (uint64_t)a->config.periodo_ms * 1000u;
+    a->prazo_us = proximo > agora_us ? proximo : agora_us;
+    a->atual = a->num_caixas;
+}
+
+static void enviar_atual(agregador_t *a, uint64_t agora_us)
+{
+    a->enviar(a->requisicoes[a->atual], 8, a->contexto);
+    a->aguardando = true;
+    a->prazo_us = agora_us + modbus_tempo_quadro_us(a->config.baud, 8) + a->config.timeout_ms * 1000ull;
+    a->estatisticas.requisicoes++;
+}
+
+// Avança para a próxima caixa do ciclo; 'gap_us' é o silêncio exigido antes do envio
+static void avancar(agregador_t *a, uint64_t agora_us, uint32_t gap_us)
+{
+    a->tentativa = 0;
+    do
+        a->atual++;
+    while (a->atual < a->num_caixas && !consultar_no_ciclo(a, a->atual));
+
+    if (a->atual >= a->num_caixas)
+        fim_de_ciclo(a, agora_us + gap_us);
+    else
+        a->prazo_us = agora_us + gap_us;
+}
+
+// Tentativa sem resposta válida: repete a mesma caixa ou registra a falha no ciclo
+static void falhar(agregador_t *a, uint64_t agora_us, uint32_t gap_us)
+{
+    agregador_caixa_t *c = &a->caixas[a->atual];
+    uint8_t tentativas = agregador_sem_resposta(c) ? 1 : a->config.tentativas;
+
+    a->aguardando = false;
+    if (++a->tentativa < tentativas)
+    {
+        a->prazo_us = agora_us + gap_us;
+        return;
+    }
+    if (c->falhas < UINT8_MAX)
+        c->falhas++;
+    avancar(a, agora_us, gap_us);
+}
+
+uint64_t agregador_processar(agregador_t *a, uint64_t agora_us)
+{
+    if (a->num_caixas == 0 || agora_us < a->prazo_us)
+        return a->prazo_us;
+
+    if (a->aguardando)
+    {
+        // Espera vencida: o barramento já está em silêncio há mais que t3,5
+        a->estatisticas.timeouts++;
+        falhar(a, agora_us, 0);
+        if (agora_us < a->prazo_us)
+            return a->prazo_us;
+    }
+
+    // Entre ciclos: começa o próximo pela primeira caixa a consultar
+    if (a->atual >= a->num_caixas)
+    {
+        a->inicio_ciclo_us = agora_us;
+        a->atual = 0;
+        a->tentativa = 0;
+        while (a->atual < a->num_caixas && !consultar_no_ciclo(a, a->atual))
+            a->atual++;
+        if (a->atual >= a->num_caixas)
+        {
+            fim_de_ciclo(a, agora_us);   // Todas sem resposta e fora da vez
+            return a->prazo_us;
+        }
+    }
+
+    enviar_atual(a, agora_us);
+    return a->prazo_us;
+}
+
+static int16_t ler_reg(const uint8_t *dados, uint8_t reg)
+{
+    return (int16_t)((dados[2 * reg] << 8) | dados[2 * reg + 1]);
+}
+
+uint64_t agregador_receber(agregador_t *a, const uint8_t *quadro, uint16_t tamanho, uint64_t agora_us)
+{
+    if (!a->aguardando)
+    {
+        a->estatisticas.erros++;   // Resposta atrasada de uma tentativa já vencida
+        return a->prazo_us;
+    }
+
+    agregador_caixa_t *c = &a->caixas[a->atual];
+    bool valido = tamanho == AGREGADOR_RESPOSTA_BYTES && quadro[0] == c->escravo &&
+                  quadro[1] == FC_LER_ENTRADA && quadro[2] == 2 * AGREGADOR_REGS &&
+                  modbus_crc16(quadro, tamanho - 2) == (uint16_t)(quadro[tamanho - 2] | (quadro[tamanho - 1] << 8));
+    if (!valido)
+    {
+        a->estatisticas.erros++;
+        falhar(a, agora_us, a->silencio_us);
+        return a->prazo_us;
+    }
+
+    // Registradores 0–9 de lib/modbus_mapa.h
+    const uint8_t *d = &quadro[3];
+    c->estado = (uint8_t)ler_reg(d, 0);
+    c->temp_dc = ler_reg(d, 1);
+    c->fogo = ler_reg(d, 2) != 0;
+    c->taxa_dc_min = ler_reg(d, 3);
+    c->contagem = (int8_t)ler_reg(d, 4);
+    c->fusao_pontuacao = (uint16_t)ler_reg(d, 8);
+    c->fusao_votos = (uint8_t)ler_reg(d, 9);
+    c->falhas = 0;
+    c->resposta_ms = (uint32_t)(agora_us / 1000);
+
+    a->aguardando = false;
+    a->estatisticas.respostas++;
+    avancar(a, agora_us, a->silencio_us);
+    return a->prazo_us;
+}
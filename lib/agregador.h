@@ -0,0 +1,119 @@
+#ifndef AGREGADOR_H
+#define AGREGADOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "status.h"
+
+// ===============================
+// === CONCENTRADOR RS-485 (MESTRE MODBUS) ===
+// ===============================
+// Uma unidade consulta as caixas de string do barramento e mantém uma linha
+// compacta com o estado de cada uma. Cada caixa é lida com uma única FC04 dos
+// registradores de entrada 0–9 (lib/modbus_mapa.h). As requisições são montadas
+// na inicialização e a seguinte sai assim que termina o silêncio de 3,5
+// caracteres após a resposta anterior. Sem resposta no prazo a consulta é
+// repetida até 'tentativas' vezes; após AGREGADOR_FALHAS_SEM_RESPOSTA ciclos
+// seguidos sem resposta a caixa só é consultada a cada AGREGADOR_RECONSULTA_CICLOS
+// ciclos, uma tentativa por vez, para não alongar o ciclo das demais.
+//
+// Independente de hardware e dirigido por eventos, com o tempo por parâmetro:
+// o firmware chama a partir da interrupção da UART e de alarmes
+// (lib/agregador_rs485.c) e o host, de um barramento simulado
+// (tools/agregador_sim.c). Cada chamada custa O(1), exceto o fim de ciclo (O(N)).
+
+#define AGREGADOR_MAX_CAIXAS          32
+#define AGREGADOR_REGS                10   // Entrada 0–9 de cada caixa
+#define AGREGADOR_RESPOSTA_BYTES      (5 + 2 * AGREGADOR_REGS)
+#define AGREGADOR_FALHAS_SEM_RESPOSTA 3
+#define AGREGADOR_RECONSULTA_CICLOS   10
+#define AGREGADOR_SEM_DADOS           0xFF   // 'estado' de uma caixa que ainda não respondeu
+
+typedef struct
+{
+    uint32_t baud;           // Velocidade do barramento (8E1)
+    uint16_t timeout_ms;     // Espera pela resposta completa após o fim da requisição
+    uint8_t tentativas;      // Consultas por caixa em cada ciclo (1 = sem repetição)
+    uint16_t periodo_ms;     // Início a início entre ciclos (0 = contínuo)
+} agregador_config_t;
+
+// Linha da tabela de status (16 bytes por caixa)
+typedef struct
+{
+    uint8_t escravo;
+    uint8_t estado;          // SystemState da última resposta (AGREGADOR_SEM_DADOS antes da primeira)
+    bool fogo;
+    int8_t contagem;
+    int16_t temp_dc;
+    int16_t taxa_dc_min;
+    uint16_t fusao_pontuacao;
+    uint8_t fusao_votos;
+    uint8_t falhas;          // Ciclos seguidos sem resposta
+    uint32_t resposta_ms;    // Instante da última resposta
+} agregador_caixa_t;
+
+typedef struct
+{
+    uint32_t ciclos;
+    uint32_t ciclo_us;       // Último ciclo completo (primeira requisição ao fim da última)
+    uint32_t ciclo_min_us;
+    uint32_t ciclo_max_us;
+    uint64_t ciclo_soma_us;
+    uint32_t requisicoes;
+    uint32_t respostas;
+    uint32_t timeouts;
+    uint32_t erros;          // CRC, endereço, exceção, tamanho ou resposta fora de hora
+} agregador_estatisticas_t;
+
+// Transmite um quadro no barramento (o transporte cuida do pino DE)
+typedef void (*agregador_enviar_t)(const uint8_t *quadro, uint16_t tamanho, void *contexto);
+
+typedef struct
+{
+    agregador_config_t config;
+    agregador_enviar_t enviar;
+    void *contexto;
+
+    agregador_caixa_t caixas[AGREGADOR_MAX_CAIXAS];
+    uint8_t requisicoes[AGREGADOR_MAX_CAIXAS][8];
+    uint8_t num_caixas;
+    uint8_t pior;            // Índice da pior caixa no último ciclo completo
+
+    uint8_t atual;           // Caixa em consulta (num_caixas: entre ciclos)
+    uint8_t tentativa;
+    bool aguardando;         // Requisição enviada, resposta pendente
+    uint32_t silencio_us;
+    uint64_t prazo_us;       // Próximo evento: fim da espera ou próximo envio
+    uint64_t inicio_ciclo_us;
+
+    agregador_estatisticas_t estatisticas;
+} agregador_t;
+
+// 'n' caixas com endereços consecutivos a partir de 'primeiro'
+void agregador_iniciar(agregador_t *a, const agregador_config_t *config, uint8_t primeiro, uint8_t n,
+                       agregador_enviar_t enviar, void *contexto, uint64_t agora_us);
+
+// Envia a próxima requisição ou trata a espera vencida; retorna quando chamar de novo
+uint64_t agregador_processar(agregador_t *a, uint64_t agora_us);
+
+// Quadro completo recebido do barramento; retorna quando chamar agregador_processar
+uint64_t agregador_receber(agregador_t *a, const uint8_t *quadro, uint16_t tamanho, uint64_t agora_us);
+
+// Caixa há AGREGADOR_FALHAS_SEM_RESPOSTA ciclos ou mais sem responder
+static inline bool agregador_sem_resposta(const agregador_caixa_t *c)
+{
+    return c->falhas >= AGREGADOR_FALHAS_SEM_RESPOSTA;
+}
+
+// Ordem da pior caixa: CRÍTICO, sem resposta, ATENÇÃO, NORMAL, sem dados;
+// no mesmo nível, a mais quente
+uint8_t agregador_gravidade(const agregador_caixa_t *c);
+
+static inline const agregador_caixa_t *agregador_pior(const agregador_t *a)
+{
+    return a->num_caixas ? &a->caixas[a->pior] : NULL;
+}
+
+#endif // AGREGADOR_H
@@ -0,0 +1,191 @@
+#include "agregador_rs485.h"
+
+#include <string.h>
+
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "modbus.h"
+
+static agregador_t agregador;
+static bool ativo = false;
+static uart_inst_t *uart_ag;
+static int pino_de_ag = -1;
+static uint32_t silencio_us;
+
+static uint8_t quadro_rx[MODBUS_QUADRO_MAX];
+static uint16_t tam_rx = 0;
+static volatile bool transmitindo = false;
+static alarm_id_t alarme_silencio = 0;
+static alarm_id_t alarme_prazo = 0;
+
+static int64_t no_prazo(alarm_id_t id, void *dados);
+
+// Próximo evento do núcleo; prazo já vencido dispara na hora
+static void agendar(uint64_t prazo_us)
+{
+    if (alarme_prazo > 0)
+    {
+        cancel_alarm(alarme_prazo);
+        alarme_prazo = 0;
+    }
+    alarm_id_t id = add_alarm_at(from_us_since_boot(prazo_us), no_prazo, NULL, true);
+    if (id > 0)
+        alarme_prazo = id;
+}
+
+static int64_t no_prazo(alarm_id_t id, void *dados)
+{
+    alarme_prazo = 0;
+    agendar(agregador_processar(&agregador, time_us_64()));
+    return 0;
+}
+
+static void entregar_quadro(void)
+{
+    if (alarme_silencio > 0)
+    {
+        cancel_alarm(alarme_silencio);
+        alarme_silencio = 0;
+    }
+    uint16_t n = tam_rx;
+    tam_rx = 0;
+    agendar(agregador_receber(&agregador, quadro_rx, n, time_us_64()));
+}
+
+// Lê a FIFO; durante a própria transmissão os bytes são eco e vão fora
+static void drenar_fifo(void)
+{
+    while (uart_is_readable(uart_ag))
+    {
+        uint8_t c = (uint8_t)uart_get_hw(uart_ag)->dr;
+        if (!transmitindo && tam_rx < MODBUS_QUADRO_MAX)
+            quadro_rx[tam_rx++] = c;
+    }
+}
+
+static int64_t fim_de_quadro(alarm_id_t id, void *dados)
+{
+    if (uart_is_readable(uart_ag))
+    {
+        drenar_fifo();
+        return silencio_us;
+    }
+    alarme_silencio = 0;
+    if (tam_rx > 0)
+        entregar_quadro();
+    return 0;
+}
+
+static void tratar_irq_uart(void)
+{
+    drenar_fifo();
+    if (tam_rx == 0)
+        return;
+
+    // Resposta do tamanho esperado já está completa: não espera o silêncio
+    if (tam_rx == AGREGADOR_RESPOSTA_BYTES)
+    {
+        entregar_quadro();
+        return;
+    }
+    if (alarme_silencio > 0)
+        cancel_alarm(alarme_silencio);
+    alarme_silencio = add_alarm_in_us(silencio_us, fim_de_quadro, NULL, true);
+}
+
+// Libera o barramento quando o último bit saiu do registrador de deslocamento
+static int64_t fim_de_transmissao(alarm_id_t id, void *dados)
+{
+    if (uart_get_hw(uart_ag)->fr & UART_UARTFR_BUSY_BITS)
+        return 20;
+    if (pino_de_ag >= 0)
+        gpio_put((uint)pino_de_ag, 0);
+    drenar_fifo();
+    transmitindo = false;
+    return 0;
+}
+
+static void enviar(const uint8_t *quadro, uint16_t tamanho, void *contexto)
+{
+    transmitindo = true;
+    tam_rx = 0;
+    if (pino_de_ag >= 0)
+        gpio_put((uint)pino_de_ag, 1);
+
+    // 8 bytes cabem na FIFO de transmissão: a escrita não espera a UART
+    for (uint16_t i = 0; i < tamanho; i++)
+        uart_get_hw(uart_ag)->dr = quadro[i];
+    add_alarm_in_us(modbus_tempo_quadro_us(agregador.config.baud, tamanho), fim_de_transmissao, NULL, true);
+}
+
+void agregador_rs485_iniciar(uart_inst_t *uart, uint pino_tx, uint pino_rx, int pino_de,
+                             uint8_t primeiro, uint8_t n, const agregador_config_t *config)
+{
+    uart_ag = uart;
+    pino_de_ag = pino_de;
+    silencio_us = modbus_silencio_us(config->baud);
+
+    uart_init(uart, config->baud);
+    gpio_set_function(pino_tx, GPIO_FUNC_UART);
+    gpio_set_function(pino_rx, GPIO_FUNC_UART);
+    uart_set_format(uart, 8, 1, UART_PARITY_EVEN);
+    uart_set_fifo_enabled(uart, true);
+
+    if (pino_de >= 0)
+    {
+        gpio_init((uint)pino_de);
+        gpio_set_dir((uint)pino_de, GPIO_OUT);
+        gpio_put((uint)pino_de, 0);
+    }
+
+    uint irq = uart == uart0 ? UART0_IRQ : UART1_IRQ;
+    irq_set_exclusive_handler(irq, tratar_irq_uart);
+    irq_set_enabled(irq, true);
+    uart_set_irq_enables(uart, true, false);
+
+    agregador_iniciar(&agregador, config, primeiro, n, enviar, NULL, time_us_64());
+    ativo = true;
+    agendar(agregador.prazo_us);
+}
+
+bool agregador_rs485_ativo(void)
+{
+    return ativo;
+}
+
+bool agregador_rs485_pior(agregador_caixa_t *caixa, uint8_t *online, uint8_t *total)
+{
+    if (!ativo)
+        return false;
+
+    uint32_t estado_irq = save_and_disable_interrupts();
+    bool pronto = agregador.estatisticas.ciclos > 0;
+    if (pronto)
+    {
+        *caixa = *agregador_pior(&agregador);
+        *total = agregador.num_caixas;
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < agregador.num_caixas; i++)
+        {
+            const agregador_caixa_t *c = &agregador.caixas[i];
+            if (c->estado != AGREGADOR_SEM_DADOS && c->falhas == 0)
+                n++;
+        }
+        *online = n;
+    }
+    restore_interrupts(estado_irq);
+    return pronto;
+}
+
+uint8_t agregador_rs485_tabela(agregador_caixa_t *caixas, agregador_estatisticas_t *estatisticas)
+{
+    if (!ativo)
+        return 0;
+
+    uint32_t estado_irq = save_and_disable_interrupts();
+    uint8_t n = agregador.num_caixas;
+    memcpy(caixas, agregador.caixas, n * sizeof(agregador_caixa_t));
+    *estatisticas = agregador.estatisticas;
+    restore_interrupts(estado_irq);
+    return n;
+}
@@ -0,0 +1,31 @@
+#ifndef AGREGADOR_RS485_H
+#define AGREGADOR_RS485_H
+
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#include "agregador.h"
+
+// ===============================
+// === TRANSPORTE DO CONCENTRADOR (UART + RS-485) ===
+// ===============================
+// Liga o núcleo de lib/agregador.c à UART: requisição escrita direto na FIFO
+// com o pino DE do transceptor em alto até o último bit sair, recepção por
+// interrupção e fim de quadro pelo silêncio de 3,5 caracteres (ou já no último
+// byte, quando a resposta tem o tamanho esperado). Prazos do núcleo viram um
+// alarme de hardware: toda a consulta corre em interrupção e o laço principal
+// só lê a tabela.
+
+// Configura a UART (8E1) como mestre e inicia o primeiro ciclo.
+// 'pino_de' < 0: transceptor com controle de direção automático
+void agregador_rs485_iniciar(uart_inst_t *uart, uint pino_tx, uint pino_rx, int pino_de,
+                             uint8_t primeiro, uint8_t n, const agregador_config_t *config);
+
+bool agregador_rs485_ativo(void);
+
+// Cópia da pior caixa e do número de caixas respondendo; false antes do primeiro ciclo
+bool agregador_rs485_pior(agregador_caixa_t *caixa, uint8_t *online, uint8_t *total);
+
+// Cópia da tabela inteira e das estatísticas; retorna o número de caixas
+uint8_t agregador_rs485_tabela(agregador_caixa_t *caixas, agregador_estatisticas_t *estatisticas);
+
+#endif // AGREGADOR_RS485_H
@@ -0,0 +1,239 @@
+#include "captura.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/sync.h"
+
+#include "secao_critica.h"
+
+#define EXPORTA_BYTES_LINHA  64   // Bytes empacotados por linha "#C"
+#define EXPORTA_LINHAS       2    // Linhas por chamada (~25 ms a 115200 baud)
+#define ADC_NUM_ENTRADAS     5    // ADC0–ADC3 nos pinos 26–29 e o sensor interno
+
+typedef struct
+{
+    uint8_t dados[CAPTURA_BYTES];
+    uint16_t cabeca;              // Próxima posição a gravar
+    uint16_t total;               // Amostras válidas (até CAPTURA_AMOSTRAS)
+    volatile bool congelado;
+    uint64_t fim_us;              // Instante da última amostra gravada
+} anel_captura_t;
+
+static anel_captura_t aneis[CAPTURA_CANAIS];
+static uint8_t entradas_adc[CAPTURA_MAX_ENTRADAS];
+static uint8_t num_entradas = 0;
+static volatile uint16_t ultimas[ADC_NUM_ENTRADAS];   // Indexado pela entrada do ADC
+static volatile uint32_t somas[ADC_NUM_ENTRADAS];     // Acumulado desde o último captura_media
+static volatile uint32_t contagens[ADC_NUM_ENTRADAS];
+static repeating_timer_t timer_captura;
+static volatile captura_observador_t observador = NULL;
+static volatile uint8_t entrada_observada;
+
+static uint64_t disparo_us;
+static bool disparada = false;
+
+// Estado da exportação em andamento
+static uint8_t canal_exportando;
+static uint16_t amostra_exportando;
+static bool cabecalho_enviado = false;
+
+// --- Empacotamento de 12 bits: amostras 2k e 2k+1 em dados[3k..3k+2] ---
+static inline void gravar_12(uint8_t *dados, uint16_t i, uint16_t v)
+{
+    uint8_t *p = dados + (i >> 1) * 3;
+    if ((i & 1u) == 0)
+    {
+        p[0] = (uint8_t)v;
+        p[1] = (uint8_t)((p[1] & 0xF0u) | (v >> 8));
+    }
+    else
+    {
+        p[1] = (uint8_t)((p[1] & 0x0Fu) | ((v & 0x0Fu) << 4));
+        p[2] = (uint8_t)(v >> 4);
+    }
+}
+
+static inline uint16_t ler_12(const uint8_t *dados, uint16_t i)
+{
+    const uint8_t *p = dados + (i >> 1) * 3;
+    if ((i & 1u) == 0)
+        return (uint16_t)(p[0] | ((p[1] & 0x0Fu) << 8));
+    return (uint16_t)((p[1] >> 4) | (p[2] << 4));
+}
+
+// Tique de 1 kHz (contexto de interrupção): todas as entradas, anéis não congelados
+static bool amostrar(repeating_timer_t *t)
+{
+    uint64_t agora = time_us_64();
+    captura_observador_t obs = observador;
+    for (uint8_t e = 0; e < num_entradas; e++)
+    {
+        adc_select_input(entradas_adc[e]);
+        uint16_t v = adc_read();
+        ultimas[entradas_adc[e]] = v;
+        somas[entradas_adc[e]] += v;
+        contagens[entradas_adc[e]]++;
+        if (obs && entradas_adc[e] == entrada_observada)
+            obs(v, agora);
+
+        if (e < CAPTURA_CANAIS && !aneis[e].congelado)
+        {
+            anel_captura_t *a = &aneis[e];
+            gravar_12(a->dados, a->cabeca, v);
+            a->cabeca = (uint16_t)((a->cabeca + 1) % CAPTURA_AMOSTRAS);
+            if (a->total < CAPTURA_AMOSTRAS)
+                a->total++;
+            a->fim_us = agora;
+        }
+    }
+    return true;
+}
+
+void captura_iniciar(const uint8_t *entradas, uint8_t n)
+{
+    num_entradas = 0;
+    for (uint8_t e = 0; e < n && num_entradas < CAPTURA_MAX_ENTRADAS; e++)
+        if (entradas[e] < ADC_NUM_ENTRADAS)
+            entradas_adc[num_entradas++] = entradas[e];
+    captura_rearmar();
+    add_repeating_timer_us(-1000000 / CAPTURA_TAXA_HZ, amostrar, NULL, &timer_captura);
+}
+
+void captura_observar(uint8_t entrada, captura_observador_t novo)
+{
+    observador = NULL;
+    entrada_observada = entrada;
+    observador = novo;
+}
+
+uint16_t captura_ultima(uint8_t entrada)
+{
+    return entrada < ADC_NUM_ENTRADAS ? ultimas[entrada] : 0;
+}
+
+uint16_t CRITICO_FUNC(captura_media)(uint8_t entrada)
+{
+    if (entrada >= ADC_NUM_ENTRADAS)
+        return 0;
+
+    // O tique roda em interrupção neste mesmo núcleo: basta bloqueá-lo na leitura
+    uint32_t estado = save_and_disable_interrupts();
+    uint32_t soma = somas[entrada];
+    uint32_t n = contagens[entrada];
+    somas[entrada] = 0;
+    contagens[entrada] = 0;
+    restore_interrupts(estado);
+
+    return n ? (uint16_t)((soma + n / 2) / n) : ultimas[entrada];
+}
+
+uint8_t captura_entradas(void)
+{
+    return num_entradas;
+}
+
+void captura_disparar(uint32_t canais, uint64_t instante_us)
+{
+    if (disparada)
+        return;
+    for (uint8_t c = 0; c < CAPTURA_CANAIS; c++)
+        if (canais & (1u << c))
+            aneis[c].congelado = true;
+    disparo_us = instante_us;
+    disparada = true;
+    canal_exportando = 0;
+    amostra_exportando = 0;
+    cabecalho_enviado = false;
+}
+
+bool captura_congelada(void)
+{
+    return disparada;
+}
+
+void captura_rearmar(void)
+{
+    for (uint8_t c = 0; c < CAPTURA_CANAIS; c++)
+    {
+        aneis[c].congelado = true;   // Impede o tique de gravar durante a limpeza
+        aneis[c].cabeca = 0;
+        aneis[c].total = 0;
+        aneis[c].congelado = false;
+    }
+    disparada = false;
+}
+
+uint16_t captura_total(uint8_t canal)
+{
+    return aneis[canal].total;
+}
+
+uint16_t captura_amostra(uint8_t canal, uint16_t indice)
+{
+    const anel_captura_t *a = &aneis[canal];
+    uint16_t inicio = a->total < CAPTURA_AMOSTRAS ? 0 : a->cabeca;
+    return ler_12(a->dados, (uint16_t)((inicio + indice) % CAPTURA_AMOSTRAS));
+}
+
+// Formato (tools/captura_csv.py converte para CSV do replay):
+//   #CAPTURA inicio taxa_hz=1000 canais=N disparo_us=...
+//   #CAPTURA canal=C adc=E amostras=M fim_us=...
+//   #C<canal> <índice da 1ª amostra> <hex, 12 bits empacotados, mais antiga primeiro>
+//   #CAPTURA fim
+bool captura_exportar(void)
+{
+    if (!disparada || canal_exportando >= CAPTURA_CANAIS)
+        return true;
+
+    if (!cabecalho_enviado)
+    {
+        printf("#CAPTURA inicio taxa_hz=%d canais=%d disparo_us=%llu\n",
+               CAPTURA_TAXA_HZ, CAPTURA_CANAIS, (unsigned long long)disparo_us);
+        cabecalho_enviado = true;
+    }
+
+    for (int l = 0; l < EXPORTA_LINHAS && canal_exportando < CAPTURA_CANAIS; l++)
+    {
+        const anel_captura_t *a = &aneis[canal_exportando];
+        if (amostra_exportando == 0)
+            printf("#CAPTURA canal=%u adc=%u amostras=%u fim_us=%llu\n", canal_exportando,
+                   entradas_adc[canal_exportando], a->total, (unsigned long long)a->fim_us);
+
+        // Reempacota a partir da mais antiga: a linha sempre começa em amostra par
+        uint8_t linha[EXPORTA_BYTES_LINHA];
+        uint16_t n = 0;
+        uint16_t primeira = amostra_exportando;
+        while (n + 3 <= EXPORTA_BYTES_LINHA && amostra_exportando < a->total)
+        {
+            uint16_t s0 = captura_amostra(canal_exportando, amostra_exportando++);
+            uint16_t s1 = amostra_exportando < a->total ? captura_amostra(canal_exportando, amostra_exportando++) : 0;
+            linha[n++] = (uint8_t)s0;
+            linha[n++] = (uint8_t)((s0 >> 8) | ((s1 & 0x0Fu) << 4));
+            linha[n++] = (uint8_t)(s1 >> 4);
+        }
+
+        if (n > 0)
+        {
+            printf("#C%u %u ", canal_exportando, primeira);
+            for (uint16_t i = 0; i < n; i++)
+                printf("%02x", linha[i]);
+            printf("\n");
+        }
+
+        if (amostra_exportando >= a->total)
+        {
+            canal_exportando++;
+            amostra_exportando = 0;
+        }
+    }
+
+    if (canal_exportando >= CAPTURA_CANAIS)
+    {
+        printf("#CAPTURA fim\n");
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,69 @@
+#ifndef CAPTURA_H
+#define CAPTURA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ===============================
+// === CAPTURA PRÉ-DISPARO ===
+// ===============================
+// Um alarme de hardware a 1 kHz é o único dono do ADC: converte todas as
+// entradas em uso, publica a última leitura de cada uma (captura_ultima) e
+// grava as CAPTURA_CANAIS primeiras em anéis de 10 s com amostras de 12 bits
+// empacotadas (duas amostras em três bytes). No disparo da proteção os anéis
+// são congelados como o pré-disparo de um osciloscópio, enquanto a amostragem
+// continua para o laço principal; a exportação pela serial é feita em trechos,
+// sem travar o laço, e a captura é rearmada quando o sistema sai de CRÍTICO.
+
+#define CAPTURA_TAXA_HZ   1000
+#define CAPTURA_SEGUNDOS  10
+#define CAPTURA_AMOSTRAS  (CAPTURA_TAXA_HZ * CAPTURA_SEGUNDOS)   // Por canal (par)
+#define CAPTURA_BYTES     (CAPTURA_AMOSTRAS * 3 / 2)
+
+#ifndef CAPTURA_CANAIS
+#define CAPTURA_CANAIS 1   // Canais gravados nos anéis (15 KiB de RAM cada)
+#endif
+
+#define CAPTURA_MAX_ENTRADAS 4   // Entradas do ADC amostradas (gravadas ou não)
+#define CAPTURA_TODOS ((1u << CAPTURA_CANAIS) - 1)
+
+_Static_assert(CAPTURA_AMOSTRAS % 2 == 0, "anel de 12 bits guarda pares de amostras");
+
+// 'entradas': entradas do ADC (0–3) lidas a cada tique; as CAPTURA_CANAIS
+// primeiras também são gravadas. Requer adc_init() e adc_gpio_init() já feitos.
+void captura_iniciar(const uint8_t *entradas, uint8_t n);
+
+// Última conversão (0–4095) de uma entrada do ADC, atualizada a 1 kHz
+uint16_t captura_ultima(uint8_t entrada);
+
+// Média das conversões de uma entrada desde a chamada anterior (filtro de
+// decimação: o ciclo de proteção consome a 1 kHz no seu próprio ritmo); sem
+// conversões novas retorna a última
+uint16_t captura_media(uint8_t entrada);
+
+// Chamado no tique de 1 kHz (contexto de interrupção) com cada conversão da
+// entrada observada: reage a um cruzamento de limiar sem esperar o ciclo de proteção
+typedef void (*captura_observador_t)(uint16_t adc, uint64_t instante_us);
+
+// 'observador' NULL desliga
+void captura_observar(uint8_t entrada, captura_observador_t observador);
+
+// Entradas convertidas a cada tique (ocupação do ADC = CAPTURA_TAXA_HZ x entradas)
+uint8_t captura_entradas(void);
+
+// Congela os canais da máscara (se armados); 'disparo_us' é o instante do evento
+void captura_disparar(uint32_t canais, uint64_t disparo_us);
+
+bool captura_congelada(void);
+
+// Envia o próximo trecho da captura congelada pela serial; true ao terminar
+bool captura_exportar(void);
+
+// Descarta a captura e volta a gravar todos os canais
+void captura_rearmar(void);
+
+// Amostra 'indice' (0 = mais antiga) de um canal
+uint16_t captura_amostra(uint8_t canal, uint16_t indice);
+uint16_t captura_total(uint8_t canal);
+
+#endif // CAPTURA_H
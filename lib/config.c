@@ -0,0 +1,504 @@
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+// Slots A e B: os dois últimos setores da flash
+#define CONFIG_OFFSET_A (PICO_FLASH_SIZE_BYTES - 2 * FLASH_SECTOR_SIZE)
+#define CONFIG_OFFSET_B (PICO_FLASH_SIZE_BYTES - 1 * FLASH_SECTOR_SIZE)
+
+#define CONFIG_SLOT_A ((const config_t *)(XIP_BASE + CONFIG_OFFSET_A))
+#define CONFIG_SLOT_B ((const config_t *)(XIP_BASE + CONFIG_OFFSET_B))
+
+#define CONFIG_LINHA_MAX 48
+
+static const config_t config_padrao = {
+    .magico = CONFIG_MAGICO,
+    .versao = CONFIG_VERSAO,
+    .tamanho = sizeof(config_t),
+    .sequencia = 0,
+    .limiar_atencao_dc = 400,
+    .limiar_critico_dc = 600,
+    .taxa_atencao_dc_min = 50,
+    .taxa_critica_dc_min = 100,
+    .debounce_us = 5000,
+    .intervalo_tela_us = 1000000,
+    .periodo_amostragem_ms = 100,
+    .centro_x = 1870,
+    .centro_y = 1969,
+    .zona_morta = 200,
+    .brilho_matriz = 3,
+    .modbus_endereco = 1,
+    .modbus_baud = 19200,
+    .ritmo_repouso_ms = 500,
+    .ritmo_vigilancia_ms = 20,
+    .ritmo_alerta_ms = 5,
+    .ritmo_margem_dc = 50,
+    .ritmo_taxa_dc_min = 20,
+    .ritmo_estavel_s = 60,
+    .economia_energia = 1,
+    .fusao_peso_chama = 100,
+    .fusao_peso_fumaca = 60,
+    .fusao_peso_temperatura = 50,
+    .fusao_peso_taxa = 50,
+    .fusao_limiar = 100,
+    .fusao_confirmacao_ms = 1000,
+    .fusao_votos = 2,
+    .fumaca_base_adc = 2600,
+    .fumaca_alarme_adc = 3600,
+    .agregador_caixas = 0,
+    .agregador_primeiro = 1,
+    .agregador_tentativas = 2,
+    .agregador_timeout_ms = 50,
+    .agregador_periodo_ms = 1000,
+    .taxa_histerese_dc_min = 20,
+};
+
+#define CAMPO(nome, tipo, min, max) {#nome, offsetof(config_t, nome), tipo, min, max}
+
+const config_campo_t config_campos[] = {
+    CAMPO(limiar_atencao_dc, CAMPO_I16, -400, 1500),
+    CAMPO(limiar_critico_dc, CAMPO_I16, -400, 1500),
+    CAMPO(taxa_atencao_dc_min, CAMPO_I16, 1, 10000),
+    CAMPO(taxa_critica_dc_min, CAMPO_I16, 1, 10000),
+    CAMPO(debounce_us, CAMPO_U32, 0, 1000000),
+    CAMPO(intervalo_tela_us, CAMPO_U32, 100000, 60000000),
+    CAMPO(periodo_amostragem_ms, CAMPO_U16, 1, 2000),   // VIGIA_PERIODO_MAX_MS
+    CAMPO(centro_x, CAMPO_U16, 0, 4095),
+    CAMPO(centro_y, CAMPO_U16, 0, 4095),
+    CAMPO(zona_morta, CAMPO_U16, 0, 2048),
+    CAMPO(brilho_matriz, CAMPO_U8, 0, 255),
+    CAMPO(modbus_endereco, CAMPO_U8, 1, 247),
+    CAMPO(modbus_baud, CAMPO_U32, 9600, 115200),
+    CAMPO(ritmo_repouso_ms, CAMPO_U16, 1, 2000),   // VIGIA_PERIODO_MAX_MS
+    CAMPO(ritmo_vigilancia_ms, CAMPO_U16, 1, 1000),
+    CAMPO(ritmo_alerta_ms, CAMPO_U16, 1, 1000),
+    CAMPO(ritmo_margem_dc, CAMPO_I16, 0, 500),
+    CAMPO(ritmo_taxa_dc_min, CAMPO_I16, 1, 10000),
+    CAMPO(ritmo_estavel_s, CAMPO_U16, 1, 3600),
+    CAMPO(economia_energia, CAMPO_U8, 0, 1),
+    CAMPO(fusao_peso_chama, CAMPO_U8, 0, 255),
+    CAMPO(fusao_peso_fumaca, CAMPO_U8, 0, 255),
+    CAMPO(fusao_peso_temperatura, CAMPO_U8, 0, 255),
+    CAMPO(fusao_peso_taxa, CAMPO_U8, 0, 255),
+    CAMPO(fusao_limiar, CAMPO_U16, 1, 1020),   // 4 fontes x peso 255
+    CAMPO(fusao_confirmacao_ms, CAMPO_U16, 0, 10000),
+    CAMPO(fusao_votos, CAMPO_U8, 1, 4),        // FUSAO_FONTES
+    CAMPO(fumaca_base_adc, CAMPO_U16, 0, 4095),
+    CAMPO(fumaca_alarme_adc, CAMPO_U16, 0, 4095),
+    CAMPO(agregador_caixas, CAMPO_U8, 0, 32),   // AGREGADOR_MAX_CAIXAS
+    CAMPO(agregador_primeiro, CAMPO_U8, 1, 247),
+    CAMPO(agregador_tentativas, CAMPO_U8, 1, 5),
+    CAMPO(agregador_timeout_ms, CAMPO_U16, 5, 1000),
+    CAMPO(agregador_periodo_ms, CAMPO_U16, 0, 60000),
+    CAMPO(taxa_histerese_dc_min, CAMPO_I16, 0, 10000),
+};
+
+const uint8_t config_num_campos = sizeof(config_campos) / sizeof(config_campos[0]);
+
+static const config_t *volatile config_em_uso = &config_padrao;
+static config_t config_ram;
+
+typedef struct
+{
+    const char *nome;
+    console_comando_t executar;
+} comando_extra_t;
+
+static comando_extra_t comandos_extras[CONFIG_CONSOLE_EXTRAS];
+static uint8_t num_comandos_extras = 0;
+
+static bool pode_apagar = false;       // Último valor de config_manutencao_flash
+static bool salvar_pendente = false;   // "salvar" à espera de um momento em que possa apagar
+
+static uint32_t crc32(const uint8_t *dados, size_t tamanho)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    while (tamanho--)
+    {
+        crc ^= *dados++;
+        for (int i = 0; i < 8; i++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+    }
+    return ~crc;
+}
+
+static uint32_t crc_config(const config_t *cfg)
+{
+    return crc32((const uint8_t *)cfg, offsetof(config_t, crc));
+}
+
+int32_t config_ler_campo(const config_t *cfg, const config_campo_t *campo)
+{
+    const uint8_t *p = (const uint8_t *)cfg + campo->deslocamento;
+    switch (campo->tipo)
+    {
+    case CAMPO_U8:
+        return *p;
+    case CAMPO_I16:
+        return *(const int16_t *)p;
+    case CAMPO_U16:
+        return *(const uint16_t *)p;
+    default:
+        return (int32_t)*(const uint32_t *)p;
+    }
+}
+
+static void escrever_campo(config_t *cfg, const config_campo_t *campo, int32_t valor)
+{
+    uint8_t *p = (uint8_t *)cfg + campo->deslocamento;
+    switch (campo->tipo)
+    {
+    case CAMPO_U8:
+        *p = (uint8_t)valor;
+        break;
+    case CAMPO_I16:
+        *(int16_t *)p = (int16_t)valor;
+        break;
+    case CAMPO_U16:
+        *(uint16_t *)p = (uint16_t)valor;
+        break;
+    default:
+        *(uint32_t *)p = (uint32_t)valor;
+        break;
+    }
+}
+
+// Menor estrutura já gravada (v1: até brilho_matriz e 3 bytes reservados, mais o CRC)
+#define CONFIG_TAMANHO_MIN (offsetof(config_t, modbus_baud) + sizeof(uint32_t))
+
+// Íntegra em qualquer versão conhecida. Os campos só foram acrescentados antes
+// do CRC, que fica nos 4 últimos bytes de 'tamanho' da versão gravada.
+static bool slot_valido(const config_t *cfg)
+{
+    if (cfg->magico != CONFIG_MAGICO || cfg->versao < 1 || cfg->versao > CONFIG_VERSAO ||
+        cfg->tamanho < CONFIG_TAMANHO_MIN || cfg->tamanho > sizeof(config_t) || cfg->tamanho % 4 != 0)
+        return false;
+    uint32_t crc;
+    memcpy(&crc, (const uint8_t *)cfg + cfg->tamanho - sizeof(crc), sizeof(crc));
+    return crc == crc32((const uint8_t *)cfg, cfg->tamanho - sizeof(crc));
+}
+
+// Íntegra e no formato atual: pode ser usada direto pelo endereço XIP
+static bool slot_atual(const config_t *cfg)
+{
+    return slot_valido(cfg) && cfg->versao == CONFIG_VERSAO && cfg->tamanho == sizeof(config_t);
+}
+
+// Fim dos campos de cada versão (índice = versão): o primeiro campo da versão
+// seguinte. O padding antes do CRC não entra, já que a versão seguinte pode
+// ter posto um campo nele.
+static const uint16_t fim_campos_versao[CONFIG_VERSAO + 1] = {
+    [1] = offsetof(config_t, modbus_endereco),
+    [2] = offsetof(config_t, modbus_endereco),
+    [3] = offsetof(config_t, ritmo_repouso_ms),
+    [4] = offsetof(config_t, economia_energia),
+    [5] = offsetof(config_t, fusao_peso_chama),
+    [6] = offsetof(config_t, agregador_caixas),
+    [7] = offsetof(config_t, taxa_histerese_dc_min),
+    [8] = offsetof(config_t, crc),
+};
+_Static_assert(CONFIG_VERSAO == 8, "nova versão: acrescente o fim dos campos em fim_campos_versao");
+
+// Versão anterior para a cópia em RAM: os campos que ela já tinha são mantidos,
+// os novos (e os bytes reservados) recebem o padrão, e um campo antigo fora da
+// faixa atual também volta ao padrão
+static void migrar(const config_t *antiga)
+{
+    config_ram = config_padrao;
+    memcpy(&config_ram, antiga, fim_campos_versao[antiga->versao]);
+    config_ram.versao = CONFIG_VERSAO;
+    config_ram.tamanho = sizeof(config_t);
+    for (uint8_t i = 0; i < config_num_campos; i++)
+    {
+        const config_campo_t *campo = &config_campos[i];
+        int32_t valor = config_ler_campo(&config_ram, campo);
+        if (valor < campo->min || valor > campo->max)
+            escrever_campo(&config_ram, campo, config_ler_campo(&config_padrao, campo));
+    }
+    config_ram.crc = crc_config(&config_ram);
+    config_em_uso = &config_ram;
+    printf("config: v%u migrada para v%u na RAM (\"salvar\" grava no formato novo)\n", antiga->versao,
+           CONFIG_VERSAO);
+}
+
+void config_carregar(void)
+{
+    const config_t *a = CONFIG_SLOT_A;
+    const config_t *b = CONFIG_SLOT_B;
+    bool a_ok = slot_valido(a);
+    bool b_ok = slot_valido(b);
+
+    const config_t *recente;
+    if (a_ok && b_ok)
+        recente = ((int32_t)(b->sequencia - a->sequencia) > 0) ? b : a;
+    else if (a_ok)
+        recente = a;
+    else if (b_ok)
+        recente = b;
+    else
+    {
+        config_em_uso = &config_padrao;
+        return;
+    }
+
+    if (slot_atual(recente))
+        config_em_uso = recente;
+    else
+        migrar(recente);
+}
+
+const config_t *config_atual(void)
+{
+    return config_em_uso;
+}
+
+char config_origem(void)
+{
+    const config_t *cfg = config_em_uso;
+    if (cfg == CONFIG_SLOT_A)
+        return 'A';
+    if (cfg == CONFIG_SLOT_B)
+        return 'B';
+    if (cfg == &config_ram)
+        return 'R';
+    return 'P';
+}
+
+// Prepara a cópia em RAM a partir da configuração em vigor (se ainda não for ela)
+static config_t *copia_editavel(void)
+{
+    if (config_em_uso != &config_ram)
+        config_ram = *config_em_uso;
+    return &config_ram;
+}
+
+bool config_definir(const char *nome, int32_t valor)
+{
+    for (uint8_t i = 0; i < config_num_campos; i++)
+    {
+        const config_campo_t *campo = &config_campos[i];
+        if (strcmp(campo->nome, nome) != 0)
+            continue;
+        if (valor < campo->min || valor > campo->max)
+            return false;
+
+        config_t *cfg = copia_editavel();
+        escrever_campo(cfg, campo, valor);
+        cfg->crc = crc_config(cfg);
+        config_em_uso = cfg;
+        return true;
+    }
+    return false;
+}
+
+void config_restaurar_padrao(void)
+{
+    uint32_t sequencia = config_em_uso->sequencia;
+    config_ram = config_padrao;
+    config_ram.sequencia = sequencia;
+    config_ram.crc = crc_config(&config_ram);
+    config_em_uso = &config_ram;
+}
+
+// Slot que não contém a versão mais recente válida (destino da próxima gravação).
+// Slots de versões anteriores contam: a gravação nunca apaga a origem de uma migração.
+static uint32_t slot_livre(uint32_t *sequencia)
+{
+    const config_t *a = CONFIG_SLOT_A;
+    const config_t *b = CONFIG_SLOT_B;
+    *sequencia = 0;
+    if (slot_valido(a) && (!slot_valido(b) || (int32_t)(a->sequencia - b->sequencia) > 0))
+    {
+        *sequencia = a->sequencia;
+        return CONFIG_OFFSET_B;
+    }
+    if (slot_valido(b))
+        *sequencia = b->sequencia;
+    return CONFIG_OFFSET_A;
+}
+
+// Só a página da configuração precisa estar apagada para ser programada
+static bool slot_em_branco(uint32_t offset)
+{
+    const uint32_t *p = (const uint32_t *)(XIP_BASE + offset);
+    for (uint32_t i = 0; i < FLASH_PAGE_SIZE / 4; i++)
+        if (p[i] != 0xFFFFFFFFu)
+            return false;
+    return true;
+}
+
+// XIP fica indisponível durante apagamento/gravação: nada pode rodar da flash.
+// Apagar um setor leva dezenas de ms (até ~400 ms) com as interrupções desligadas.
+static void apagar_slot(uint32_t offset)
+{
+    uint32_t estado_irq = save_and_disable_interrupts();
+    flash_range_erase(offset, FLASH_SECTOR_SIZE);
+    restore_interrupts(estado_irq);
+}
+
+bool config_salvar(void)
+{
+    if (config_em_uso != &config_ram)
+        return false;
+
+    uint32_t sequencia;
+    uint32_t offset = slot_livre(&sequencia);
+    if (!slot_em_branco(offset))
+    {
+        if (!pode_apagar)
+        {
+            salvar_pendente = true;
+            return false;
+        }
+        apagar_slot(offset);
+    }
+
+    static uint8_t pagina[FLASH_PAGE_SIZE];
+    memset(pagina, 0xFF, sizeof(pagina));
+    config_ram.sequencia = sequencia + 1;
+    config_ram.crc = crc_config(&config_ram);
+    memcpy(pagina, &config_ram, sizeof(config_t));
+
+    // Programar uma página: ~0,4 ms (até 3 ms)
+    uint32_t estado_irq = save_and_disable_interrupts();
+    flash_range_program(offset, pagina, FLASH_PAGE_SIZE);
+    restore_interrupts(estado_irq);
+
+    salvar_pendente = false;
+    const config_t *gravada = (const config_t *)(XIP_BASE + offset);
+    if (!slot_atual(gravada))
+        return false;
+
+    config_em_uso = gravada;
+    return true;
+}
+
+bool config_salvar_pendente(void)
+{
+    return salvar_pendente;
+}
+
+void config_manutencao_flash(bool permitido)
+{
+    pode_apagar = permitido;
+    if (!permitido)
+        return;
+
+    // O slot livre guarda a versão anterior até o próximo "salvar": só é apagado
+    // logo antes de receber a nova, então sempre há uma cópia válida para o boot
+    if (salvar_pendente)
+    {
+        if (config_salvar())
+            printf("OK configuração gravada no slot %c\n", config_origem());
+        else
+            printf("ERRO: falha na gravação adiada da configuração\n");
+    }
+}
+
+static void imprimir_config(void)
+{
+    const config_t *cfg = config_em_uso;
+    printf("\n--- CONFIGURAÇÃO (v%u, seq %lu, origem %c) ---\n",
+           cfg->versao, (unsigned long)cfg->sequencia, config_origem());
+    for (uint8_t i = 0; i < config_num_campos; i++)
+        printf("%-22s = %ld\n", config_campos[i].nome, (long)config_ler_campo(cfg, &config_campos[i]));
+}
+
+static bool executar_comando(char *linha)
+{
+    char *cmd = strtok(linha, " ");
+    if (!cmd)
+        return false;
+
+    if (strcmp(cmd, "cfg") == 0)
+    {
+        imprimir_config();
+    }
+    else if (strcmp(cmd, "set") == 0)
+    {
+        char *nome = strtok(NULL, " ");
+        char *valor = strtok(NULL, " ");
+        if (nome && valor && config_definir(nome, strtol(valor, NULL, 0)))
+        {
+            printf("OK %s = %s (não salvo)\n", nome, valor);
+            return true;
+        }
+        printf("ERRO: campo inválido ou valor fora da faixa\n");
+    }
+    else if (strcmp(cmd, "salvar") == 0)
+    {
+        if (config_salvar())
+            printf("OK configuração gravada no slot %c\n", config_origem());
+        else if (config_salvar_pendente())
+            printf("Gravação adiada: o slot livre só é apagado com o sistema em NORMAL\n");
+        else
+            printf("Nada a gravar (ou falha na gravação)\n");
+    }
+    else if (strcmp(cmd, "padrao") == 0)
+    {
+        config_restaurar_padrao();
+        printf("OK valores de fábrica aplicados (não salvo)\n");
+        return true;
+    }
+    else
+    {
+        for (uint8_t i = 0; i < num_comandos_extras; i++)
+        {
+            if (strcmp(cmd, comandos_extras[i].nome) == 0)
+            {
+                comandos_extras[i].executar(strtok(NULL, " "));
+                return false;
+            }
+        }
+
+        printf("Comandos: cfg | set <campo> <valor> | salvar | padrao");
+        for (uint8_t i = 0; i < num_comandos_extras; i++)
+            printf(" | %s", comandos_extras[i].nome);
+        printf("\n");
+    }
+    return false;
+}
+
+bool config_console_registrar(const char *nome, console_comando_t executar)
+{
+    if (num_comandos_extras >= CONFIG_CONSOLE_EXTRAS)
+    {
+        // Sem isso o comando sumiria do console sem aviso: aumente CONFIG_CONSOLE_EXTRAS
+        printf("console: tabela cheia (%u), comando \"%s\" não registrado\n", CONFIG_CONSOLE_EXTRAS, nome);
+        return false;
+    }
+    comandos_extras[num_comandos_extras].nome = nome;
+    comandos_extras[num_comandos_extras].executar = executar;
+    num_comandos_extras++;
+    return true;
+}
+
+bool config_processar_console(void)
+{
+    static char linha[CONFIG_LINHA_MAX];
+    static uint8_t tamanho = 0;
+    bool alterou = false;
+
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+    {
+        if (c == '\r' || c == '\n')
+        {
+            linha[tamanho] = '\0';
+            if (tamanho > 0)
+                alterou |= executar_comando(linha);
+            tamanho = 0;
+        }
+        else if (tamanho < CONFIG_LINHA_MAX - 1)
+        {
+            linha[tamanho++] = (char)c;
+        }
+    }
+    return alterou;
+}
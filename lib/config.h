@@ -0,0 +1,156 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ===============================
+// === CONFIGURAÇÃO EM FLASH ===
+// ===============================
+// Estrutura única, versionada e protegida por CRC32, gravada em dois setores
+// no fim da flash (slots A/B). No boot o slot válido mais recente é usado
+// diretamente pelo endereço XIP, sem cópia nem parsing. Alterações feitas pela
+// serial passam a valer imediatamente (cópia em RAM) e só vão para a flash com
+// o comando "salvar", sempre no slot que não contém a versão em uso. Campos
+// novos só entram antes do CRC: um slot de versão anterior é migrado na RAM
+// (campos conhecidos mantidos, os novos com o padrão) em vez de descartado.
+
+#define CONFIG_MAGICO 0x31474643u   // "CFG1"
+#define CONFIG_VERSAO 8   // v8: histerese da taxa de elevação
+
+typedef struct
+{
+    uint32_t magico;
+    uint16_t versao;
+    uint16_t tamanho;
+    uint32_t sequencia;              // Incrementada a cada gravação (maior = mais recente)
+
+    // --- Proteção ---
+    int16_t limiar_atencao_dc;       // Décimos de °C
+    int16_t limiar_critico_dc;
+    int16_t taxa_atencao_dc_min;     // Décimos de °C por minuto
+    int16_t taxa_critica_dc_min;
+
+    // --- Temporização ---
+    uint32_t debounce_us;            // Tempo de estabilidade exigido pelo debounce no PIO
+    uint32_t intervalo_tela_us;      // Período da tela de depuração
+    uint16_t periodo_amostragem_ms;  // Interface e ciclo de proteção no nível NORMAL
+
+    // --- Joystick ---
+    uint16_t centro_x;
+    uint16_t centro_y;
+    uint16_t zona_morta;
+
+    // --- Matriz de LEDs ---
+    uint8_t brilho_matriz;           // 0–255 (3 equivale à antiga intensidade 0.01)
+
+    // --- Modbus RTU (SCADA) ---
+    uint8_t modbus_endereco;         // Endereço do escravo (1–247)
+    uint8_t reservado[2];
+    uint32_t modbus_baud;            // 19200–115200, 8E1
+
+    // --- Amostragem adaptativa ao risco (lib/ritmo.h) ---
+    uint16_t ritmo_repouso_ms;       // Período da proteção em NORMAL estável
+    uint16_t ritmo_vigilancia_ms;    // Perto do limiar de atenção ou com a temperatura subindo
+    uint16_t ritmo_alerta_ms;        // ATENÇÃO/CRÍTICO ou perto do limiar crítico
+    int16_t ritmo_margem_dc;         // Antecipação em relação aos limiares (décimos de °C)
+    int16_t ritmo_taxa_dc_min;       // Taxa de elevação que já acelera a amostragem
+    uint16_t ritmo_estavel_s;        // Tempo sem risco para desacelerar um nível
+
+    // --- Economia de energia (lib/economia.h) ---
+    uint8_t economia_energia;        // 1: clock reduzido, OLED e matriz apagados no repouso
+    uint8_t reservado_economia[3];
+
+    // --- Fusão dos sensores de incêndio (lib/fusao.h) ---
+    uint8_t fusao_peso_chama;        // Peso de cada fonte com evidência plena (0 = ignorada)
+    uint8_t fusao_peso_fumaca;
+    uint8_t fusao_peso_temperatura;
+    uint8_t fusao_peso_taxa;
+    uint16_t fusao_limiar;           // Pontuação que caracteriza incêndio
+    uint16_t fusao_confirmacao_ms;   // Persistência exigida com menos de fusao_votos fontes
+    uint8_t fusao_votos;             // Fontes votando para disparar sem confirmação
+    uint8_t reservado_fusao;
+    uint16_t fumaca_base_adc;        // Sensor de fumaça em ar limpo
+    uint16_t fumaca_alarme_adc;      // Sensor de fumaça com fumaça densa
+
+    // --- Concentrador RS-485 (lib/agregador.h), lido no boot ---
+    uint8_t agregador_caixas;        // Caixas consultadas no barramento (0 = escravo Modbus)
+    uint8_t agregador_primeiro;      // Endereço da primeira caixa (as demais em sequência)
+    uint8_t agregador_tentativas;    // Consultas por caixa em cada ciclo
+    uint8_t reservado_agregador;
+    uint16_t agregador_timeout_ms;   // Espera pela resposta de cada caixa
+    uint16_t agregador_periodo_ms;   // Início a início entre ciclos (0 = contínuo)
+
+    // --- Taxa de elevação: liberação dos níveis ---
+    int16_t taxa_histerese_dc_min;   // ATENÇÃO/CRÍTICO da taxa só saem abaixo do limite menos isto
+    uint16_t reservado_taxa;
+
+    uint32_t crc;                    // CRC32 de todos os campos anteriores
+} config_t;
+
+_Static_assert(sizeof(config_t) <= 256, "config_t deve caber em uma página de flash");
+
+// Tipos de campo aceitos pela tabela de descritores
+typedef enum
+{
+    CAMPO_U8,
+    CAMPO_I16,
+    CAMPO_U16,
+    CAMPO_U32
+} config_tipo_t;
+
+typedef struct
+{
+    const char *nome;
+    uint16_t deslocamento;
+    config_tipo_t tipo;
+    int32_t min;
+    int32_t max;
+} config_campo_t;
+
+extern const config_campo_t config_campos[];
+extern const uint8_t config_num_campos;
+
+// Seleciona o slot válido mais recente (ou os padrões) — chamado uma vez no boot
+void config_carregar(void);
+
+// Configuração em vigor (flash via XIP, ou a cópia em RAM após uma edição)
+const config_t *config_atual(void);
+
+// Altera um campo na cópia em RAM e passa a usá-la imediatamente
+bool config_definir(const char *nome, int32_t valor);
+
+// Restaura os valores de fábrica na cópia em RAM
+void config_restaurar_padrao(void);
+
+// Grava a configuração em vigor no slot livre; retorna false se já estiver salva
+// ou se o slot livre precisar ser apagado fora de config_manutencao_flash(true)
+// (a gravação fica pendente e é feita lá)
+bool config_salvar(void);
+bool config_salvar_pendente(void);
+
+// Chamada a cada iteração da interface. Com 'permitido' (sistema em NORMAL),
+// conclui um "salvar" pendente, já que apagar um setor desliga as interrupções
+// por dezenas de ms (até ~400 ms). O slot livre guarda a versão anterior e só é
+// apagado logo antes de receber a nova: uma queda de energia nesse meio tempo
+// ainda deixa a versão em uso válida.
+void config_manutencao_flash(bool permitido);
+
+// Slot em uso: 'A', 'B', 'R' (RAM, não salva) ou 'P' (padrão de fábrica)
+char config_origem(void);
+
+int32_t config_ler_campo(const config_t *cfg, const config_campo_t *campo);
+
+// Lê a serial sem bloquear e executa comandos "cfg", "set <campo> <valor>",
+// "salvar" e "padrao". Retorna true se a configuração em vigor mudou.
+bool config_processar_console(void);
+
+// Comandos extras de outros módulos no mesmo console ("nome [argumento]").
+// Hoje são 6 (ritmo, tela, rede, lat, xip, hist); a tabela tem folga, e um
+// registro além dela é recusado com aviso na serial.
+#define CONFIG_CONSOLE_EXTRAS 12
+typedef void (*console_comando_t)(const char *argumento);
+bool config_console_registrar(const char *nome, console_comando_t executar);
+
+#endif // CONFIG_H
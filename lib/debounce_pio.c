@@ -0,0 +1,107 @@
+#include "debounce_pio.h"
+
+#include "hardware/pio.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "debounce.pio.h"
+#include "latencia.h"
+#include "secao_critica.h"
+
+#define PIO_ENTRADAS pio1   // pio0 fica com a matriz WS2812
+
+static uint offset_programa;
+static uint pinos_sm[DEBOUNCE_MAX_ENTRADAS];
+static uint sms[DEBOUNCE_MAX_ENTRADAS];
+static bool nivel_sm[DEBOUNCE_MAX_ENTRADAS];   // Último nível entregue por cada máquina
+static uint num_entradas = 0;
+static uint32_t tempo_integracao_us;
+static debounce_callback_t callback_eventos;
+
+// Cada amostra consome 2 ciclos do SM; "jmp x--" faz x + 1 amostras
+static uint32_t contagem_para_tempo(uint32_t tempo_us)
+{
+    uint32_t amostras = (uint32_t)((tempo_us * (uint64_t)DEBOUNCE_FREQ_SM) / 2000000u);
+    return amostras > 1 ? amostras - 1 : 0;
+}
+
+// A máquina começa no nível já conhecido da entrada: um reinício não gera borda
+static void iniciar_sm(uint i)
+{
+    debounce_program_init(PIO_ENTRADAS, sms[i], offset_programa, pinos_sm[i], DEBOUNCE_FREQ_SM, nivel_sm[i]);
+    pio_sm_put(PIO_ENTRADAS, sms[i], contagem_para_tempo(tempo_integracao_us));
+    pio_sm_set_enabled(PIO_ENTRADAS, sms[i], true);
+}
+
+// Entrega os eventos pendentes nos FIFOs, um por transição já estabilizada
+static void CRITICO_FUNC(drenar_eventos)(uint64_t agora)
+{
+    for (uint i = 0; i < num_entradas; i++)
+    {
+        while (!pio_sm_is_rx_fifo_empty(PIO_ENTRADAS, sms[i]))
+        {
+            uint32_t nivel = pio_sm_get(PIO_ENTRADAS, sms[i]);
+            uint32_t eventos = nivel ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+            nivel_sm[i] = nivel != 0;
+
+            // Estimativa: o nível está estável desde uma janela de integração
+            // antes da entrada nesta IRQ (ver debounce_pio.h sobre o erro)
+            callback_eventos(pinos_sm[i], eventos, agora - tempo_integracao_us);
+        }
+    }
+}
+
+// Interrupção do PIO
+static void CRITICO_FUNC(tratar_irq_pio)(void)
+{
+    uint32_t inicio = latencia_ciclos();
+    drenar_eventos(latencia_agora_us());
+    latencia_fim(LAT_IRQ_ENTRADAS, inicio);
+}
+
+void debounce_pio_iniciar(const uint *pinos, uint quantidade, uint32_t tempo_us, debounce_callback_t callback)
+{
+    callback_eventos = callback;
+    tempo_integracao_us = tempo_us;
+    offset_programa = pio_add_program(PIO_ENTRADAS, &debounce_program);
+
+    for (uint i = 0; i < quantidade && i < DEBOUNCE_MAX_ENTRADAS; i++)
+    {
+        pinos_sm[i] = pinos[i];
+        nivel_sm[i] = gpio_get(pinos[i]);   // Nível no boot não é uma borda
+        sms[i] = (uint)pio_claim_unused_sm(PIO_ENTRADAS, true);
+        pio_set_irq0_source_enabled(PIO_ENTRADAS, pio_get_rx_fifo_not_empty_interrupt_source(sms[i]), true);
+        num_entradas++;
+        iniciar_sm(i);
+    }
+
+    irq_set_exclusive_handler(PIO1_IRQ_0, tratar_irq_pio);
+    irq_set_enabled(PIO1_IRQ_0, true);
+}
+
+void debounce_pio_definir_tempo(uint32_t tempo_us)
+{
+    if (tempo_us == tempo_integracao_us)
+        return;
+
+    // Com a IRQ mascarada, entrega o que já estava no FIFO (atualizando o nível
+    // de cada máquina) e reinicia as máquinas nesse nível. Uma transição ainda
+    // em integração recomeça com o novo tempo e gera o evento normalmente.
+    irq_set_enabled(PIO1_IRQ_0, false);
+    for (uint i = 0; i < num_entradas; i++)
+        pio_sm_set_enabled(PIO_ENTRADAS, sms[i], false);
+    drenar_eventos(latencia_agora_us());
+
+    tempo_integracao_us = tempo_us;
+    for (uint i = 0; i < num_entradas; i++)
+    {
+        pio_sm_restart(PIO_ENTRADAS, sms[i]);
+        iniciar_sm(i);
+    }
+    irq_set_enabled(PIO1_IRQ_0, true);
+}
+
+void debounce_pio_ajustar_clock(void)
+{
+    for (uint i = 0; i < num_entradas; i++)
+        pio_sm_set_clkdiv(PIO_ENTRADAS, sms[i], clock_get_hz(clk_sys) / DEBOUNCE_FREQ_SM);
+}
@@ -0,0 +1,36 @@
+#ifndef DEBOUNCE_PIO_H
+#define DEBOUNCE_PIO_H
+
+#include "pico/stdlib.h"
+
+// ===============================
+// === DEBOUNCE DE ENTRADAS EM PIO ===
+// ===============================
+// Cada entrada é amostrada por uma máquina de estado do PIO1, que integra o
+// nível em hardware e só gera um evento após o tempo de estabilidade. A CPU
+// recebe uma interrupção por transição real.
+//
+// O instante entregue é estimado, não medido pelo PIO: entrada na IRQ menos o
+// tempo de integração, ou seja, o início do nível estável (o último repique,
+// não a primeira borda). Ele sai atrasado pela latência de entrada na IRQ
+// (alguns µs; mais se as interrupções estiverem desligadas, como ao apagar a
+// flash). Eventos acumulados no FIFO e lidos na mesma IRQ recebem todos o
+// instante do mais recente, que é só um limite superior para os anteriores.
+
+#define DEBOUNCE_MAX_ENTRADAS 4
+#define DEBOUNCE_FREQ_SM      1000000.0f   // 1 MHz: 2 µs por amostra
+
+// Chamado em contexto de interrupção; 'eventos' usa GPIO_IRQ_EDGE_FALL/RISE
+typedef void (*debounce_callback_t)(uint gpio, uint32_t eventos, uint64_t instante_us);
+
+void debounce_pio_iniciar(const uint *pinos, uint quantidade, uint32_t tempo_us, debounce_callback_t callback);
+
+// Altera o tempo de integração em tempo de execução. As máquinas são
+// reiniciadas no último nível entregue, sem gerar bordas.
+void debounce_pio_definir_tempo(uint32_t tempo_us);
+
+// Recalcula o divisor das máquinas após mudar clk_sys, sem reiniciá-las (a
+// integração em curso e o nível atual são preservados)
+void debounce_pio_ajustar_clock(void);
+
+#endif // DEBOUNCE_PIO_H
@@ -0,0 +1,80 @@
+#include "economia.h"
+
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "pico/time.h"
+
+static uint32_t clk_normal_hz;
+static uint vco_hz, pos_div1, pos_div2;   // Parâmetros do PLL do sistema no boot
+
+static bool ativa = false;
+static uint32_t entradas = 0;
+static uint64_t inicio_us;
+static uint64_t acumulado_us = 0;
+static uint32_t pior_saida_us = 0;
+
+void economia_iniciar(void)
+{
+    clk_normal_hz = clock_get_hz(clk_sys);
+    if (!check_sys_clock_khz(clk_normal_hz / 1000u, &vco_hz, &pos_div1, &pos_div2))
+    {
+        // Clock do boot fora da grade do PLL: repouso desabilitado (economia_entrar não faz nada)
+        vco_hz = 0;
+    }
+
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB,
+                    ECONOMIA_PERI_HZ, ECONOMIA_PERI_HZ);
+}
+
+void economia_entrar(void)
+{
+    if (ativa || vco_hz == 0)
+        return;
+
+    // Troca sem glitch pelo multiplexador auxiliar; só então o PLL pode parar
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, ECONOMIA_CLK_HZ, ECONOMIA_CLK_HZ);
+    pll_deinit(pll_sys);
+
+    ativa = true;
+    entradas++;
+    inicio_us = time_us_64();
+}
+
+void economia_sair(void)
+{
+    if (!ativa)
+        return;
+
+    uint64_t inicio_saida = time_us_64();
+    pll_init(pll_sys, 1, vco_hz, pos_div1, pos_div2);
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, clk_normal_hz, clk_normal_hz);
+
+    uint64_t agora = time_us_64();
+    uint32_t saida_us = (uint32_t)(agora - inicio_saida);
+    if (saida_us > pior_saida_us)
+        pior_saida_us = saida_us;
+    acumulado_us += agora - inicio_us;
+    ativa = false;
+}
+
+bool economia_ativa(void)
+{
+    return ativa;
+}
+
+uint32_t economia_entradas(void)
+{
+    return entradas;
+}
+
+uint64_t economia_tempo_us(void)
+{
+    return acumulado_us + (ativa ? time_us_64() - inicio_us : 0);
+}
+
+uint32_t economia_pior_saida_us(void)
+{
+    return pior_saida_us;
+}
@@ -0,0 +1,34 @@
+#ifndef ECONOMIA_H
+#define ECONOMIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ===============================
+// === ECONOMIA DE ENERGIA (REPOUSO) ===
+// ===============================
+// À noite a string box roda da bateria do auxiliar. Com o sistema em NORMAL
+// estável, clk_sys passa do PLL do sistema para o PLL da USB (48 MHz, o mínimo
+// que mantém a USB) e o PLL do sistema é desligado; na saída ele é religado e
+// clk_sys volta ao valor do boot. clk_peri fica no PLL da USB desde o boot, de
+// modo que console, Modbus e SPI não percebem a troca; PIO, PWM e I2C são
+// reajustados por quem os usa. O timer e o watchdog vêm do cristal e não mudam.
+
+#define ECONOMIA_CLK_HZ  48000000u   // clk_sys em repouso (PLL da USB)
+#define ECONOMIA_PERI_HZ 48000000u   // clk_peri fixo (UART e SPI)
+
+// Fixa clk_peri no PLL da USB: chamar antes de iniciar UARTs e SPI
+void economia_iniciar(void);
+
+void economia_entrar(void);
+
+// Religa o PLL do sistema (espera o travamento) e devolve clk_sys ao valor do boot
+void economia_sair(void);
+
+bool economia_ativa(void);
+
+uint32_t economia_entradas(void);          // Vezes que entrou em repouso
+uint64_t economia_tempo_us(void);          // Tempo total em repouso (inclui o período em curso)
+uint32_t economia_pior_saida_us(void);     // Religar o PLL e trocar o clock
+
+#endif // ECONOMIA_H
@@ -0,0 +1,133 @@
+#include "efeitos_led.h"
+
+#include "hardware/pwm.h"
+#include "hardware/dma.h"
+
+// Cada linha ocupa EFEITOS_AMOSTRAS * 4 bytes e fica alinhada a esse tamanho,
+// permitindo que o DMA percorra a forma de onda em anel indefinidamente
+#define EFEITOS_ANEL_BITS 8
+_Static_assert((EFEITOS_AMOSTRAS * 4) == (1 << EFEITOS_ANEL_BITS), "anel de DMA deve ter EFEITOS_AMOSTRAS palavras");
+
+static uint32_t forma_onda[EFEITOS_MAX_SLICES][EFEITOS_AMOSTRAS] __attribute__((aligned(EFEITOS_AMOSTRAS * 4)));
+
+typedef struct
+{
+    uint slice;
+    int canal_dma;
+} efeito_slice_t;
+
+static efeito_slice_t slices[EFEITOS_MAX_SLICES];
+static uint num_slices = 0;
+
+static uint pinos[3];                 // R, G, B
+static uint8_t slice_do_pino[3];      // Índice em 'slices' de cada cor
+static uint16_t topo_pwm;
+
+static efeito_led_t efeito_atual = EFEITO_FIXO;
+static uint8_t cor_atual[3] = {0, 0, 0};
+static bool ativo = false;
+
+// Intensidade relativa (0–255) da amostra i de cada efeito
+static uint8_t intensidade_efeito(efeito_led_t efeito, uint i)
+{
+    const uint meio = EFEITOS_AMOSTRAS / 2;
+    uint triangulo = (i < meio) ? (i * 255) / (meio - 1) : ((EFEITOS_AMOSTRAS - 1 - i) * 255) / (meio - 1);
+
+    switch (efeito)
+    {
+    case EFEITO_PISCAR:
+        return i < meio ? 255 : 0;
+    case EFEITO_FADE:
+        return (uint8_t)triangulo;
+    case EFEITO_RESPIRAR:
+        return (uint8_t)((triangulo * triangulo) / 255);
+    default:
+        return 255;
+    }
+}
+
+static void parar_dma(void)
+{
+    for (uint s = 0; s < num_slices; s++)
+        dma_channel_abort(slices[s].canal_dma);
+}
+
+void efeitos_led_iniciar(uint pino_r, uint pino_g, uint pino_b, uint16_t wrap)
+{
+    pinos[0] = pino_r;
+    pinos[1] = pino_g;
+    pinos[2] = pino_b;
+    topo_pwm = wrap;
+
+    // Agrupa os pinos por slice: um canal DMA atualiza os dois canais (A/B) do slice
+    for (uint c = 0; c < 3; c++)
+    {
+        uint slice = pwm_gpio_to_slice_num(pinos[c]);
+        uint s = 0;
+        while (s < num_slices && slices[s].slice != slice)
+            s++;
+
+        if (s == num_slices)
+        {
+            slices[s].slice = slice;
+            slices[s].canal_dma = dma_claim_unused_channel(true);
+            num_slices++;
+        }
+        slice_do_pino[c] = (uint8_t)s;
+    }
+}
+
+void efeitos_led_aplicar(efeito_led_t efeito, uint8_t r, uint8_t g, uint8_t b)
+{
+    const uint8_t cor[3] = {r, g, b};
+
+    if (efeito == efeito_atual && cor[0] == cor_atual[0] && cor[1] == cor_atual[1] && cor[2] == cor_atual[2] && ativo)
+        return;
+
+    parar_dma();
+    efeito_atual = efeito;
+    cor_atual[0] = r;
+    cor_atual[1] = g;
+    cor_atual[2] = b;
+    ativo = true;
+
+    if (efeito == EFEITO_FIXO)
+    {
+        for (uint c = 0; c < 3; c++)
+            pwm_set_gpio_level(pinos[c], (uint16_t)((cor[c] * topo_pwm) / 255));
+        return;
+    }
+
+    // --- Pré-cálculo das formas de onda (palavras do registrador CC: B << 16 | A) ---
+    for (uint i = 0; i < EFEITOS_AMOSTRAS; i++)
+    {
+        uint32_t nivel = intensidade_efeito(efeito, i);
+        for (uint s = 0; s < num_slices; s++)
+            forma_onda[s][i] = 0;
+
+        for (uint c = 0; c < 3; c++)
+        {
+            uint32_t duty = (cor[c] * nivel * topo_pwm) / (255u * 255u);
+            uint deslocamento = pwm_gpio_to_channel(pinos[c]) == PWM_CHAN_B ? 16 : 0;
+            forma_onda[slice_do_pino[c]][i] |= duty << deslocamento;
+        }
+    }
+
+    // --- Um canal DMA por slice, em anel, disparado a cada wrap do PWM ---
+    for (uint s = 0; s < num_slices; s++)
+    {
+        dma_channel_config cfg = dma_channel_get_default_config(slices[s].canal_dma);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+        channel_config_set_read_increment(&cfg, true);
+        channel_config_set_write_increment(&cfg, false);
+        channel_config_set_ring(&cfg, false, EFEITOS_ANEL_BITS);
+        channel_config_set_dreq(&cfg, pwm_get_dreq(slices[s].slice));
+
+        // Contagem máxima: a ~50 Hz o anel roda por anos sem reprogramação
+        dma_channel_configure(slices[s].canal_dma, &cfg,
+                              &pwm_hw->slice[slices[s].slice].cc,
+                              forma_onda[s],
+                              0xFFFFFFFFu,
+                              true);
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef EFEITOS_LED_H
+#define EFEITOS_LED_H
+
+#include "pico/stdlib.h"
+
+// ===============================
+// === EFEITOS DO LED RGB (PWM + DMA) ===
+// ===============================
+// As formas de onda (piscar, fade, respirar) são pré-calculadas apenas quando o
+// efeito muda. Um canal DMA por slice PWM copia um valor por período para o
+// registrador de comparação (CC), cadenciado pelo DREQ de wrap do próprio slice,
+// sem nenhuma participação da CPU durante a animação.
+
+#define EFEITOS_AMOSTRAS   64   // Amostras por ciclo (potência de 2: anel de DMA)
+#define EFEITOS_MAX_SLICES 3    // No pior caso, cada cor em um slice diferente
+
+typedef enum
+{
+    EFEITO_FIXO,        // Cor constante (sem DMA)
+    EFEITO_PISCAR,      // Metade do ciclo acesa, metade apagada
+    EFEITO_FADE,        // Rampa linear de subida e descida
+    EFEITO_RESPIRAR     // Rampa com correção quadrática (mais suave aos olhos)
+} efeito_led_t;
+
+// Associa os pinos (já configurados como PWM) ao motor de efeitos; 'wrap' é o TOP do PWM
+void efeitos_led_iniciar(uint pino_r, uint pino_g, uint pino_b, uint16_t wrap);
+
+// Aplica um efeito com a cor de pico (0–255). Não faz nada se já estiver ativo.
+void efeitos_led_aplicar(efeito_led_t efeito, uint8_t r, uint8_t g, uint8_t b);
+
+#endif // EFEITOS_LED_H
@@ -0,0 +1,76 @@
+#include "fusao.h"
+
+#include <string.h>
+
+#include "secao_critica.h"
+
+const char *const fusao_nomes[FUSAO_FONTES] = {"chama", "fumaca", "temperatura", "taxa"};
+
+void fusao_iniciar(fusao_t *f, const fusao_config_t *config)
+{
+    f->config = *config;
+    memset(f->evidencia, 0, sizeof(f->evidencia));
+    f->pontuacao = 0;
+    f->votos = 0;
+    f->suspeita = false;
+    f->inicio_suspeita_ms = 0;
+    f->incendio = false;
+}
+
+uint8_t CRITICO_FUNC(fusao_evidencia)(int32_t valor, int32_t zero, int32_t pleno)
+{
+    if (pleno <= zero)
+        return valor >= zero ? 100 : 0;   // Faixa degenerada: degrau
+    if (valor <= zero)
+        return 0;
+    if (valor >= pleno)
+        return 100;
+    return (uint8_t)((valor - zero) * 100 / (pleno - zero));
+}
+
+bool CRITICO_FUNC(fusao_avaliar)(fusao_t *f, uint32_t agora_ms, const uint8_t *evidencia)
+{
+    const fusao_config_t *c = &f->config;
+    uint32_t pontuacao = 0;
+    uint8_t votos = 0;
+
+    for (uint8_t i = 0; i < FUSAO_FONTES; i++)
+    {
+        f->evidencia[i] = evidencia[i];
+        if (c->peso[i] == 0)
+            continue;
+        pontuacao += (uint32_t)c->peso[i] * evidencia[i];
+        if (evidencia[i] >= FUSAO_VOTO_PCT)
+            votos |= (uint8_t)(1u << i);
+    }
+    f->pontuacao = (uint16_t)((pontuacao + 50) / 100);
+    f->votos = votos;
+
+    // Decidido, o incêndio não oscila com o ruído em torno do limiar
+    if (f->incendio && (uint32_t)f->pontuacao * 100 >= (uint32_t)c->limiar * FUSAO_HISTERESE_PCT)
+        return true;
+
+    if (f->pontuacao < c->limiar)
+    {
+        f->suspeita = false;
+        f->incendio = false;
+        return false;
+    }
+
+    // Evidência forte de várias fontes: sem esperar
+    if (fusao_num_votos(votos) >= c->votos_imediatos)
+    {
+        f->incendio = true;
+        return true;
+    }
+
+    // Poucas fontes: o incêndio só vale se a pontuação se mantiver
+    if (!f->suspeita)
+    {
+        f->suspeita = true;
+        f->inicio_suspeita_ms = agora_ms;
+    }
+    if (agora_ms - f->inicio_suspeita_ms >= c->confirmacao_ms)
+        f->incendio = true;
+    return f->incendio;
+}
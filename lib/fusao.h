@@ -0,0 +1,72 @@
+#ifndef FUSAO_H
+#define FUSAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ===============================
+// === FUSÃO DE SENSORES DE INCÊNDIO ===
+// ===============================
+// Cada fonte (chama IR, fumaça, temperatura e taxa de elevação) entrega uma
+// evidência de 0 a 100 % e vota quando passa de FUSAO_VOTO_PCT. A pontuação é
+// a soma das evidências ponderadas pelos pesos configurados. Pontuação no
+// limiar com 'votos_imediatos' fontes votando é incêndio na hora; com menos
+// fontes a pontuação precisa se manter por 'confirmacao_ms', o que descarta o
+// falso positivo de um sensor isolado. Número fixo de fontes e aritmética
+// inteira: o custo por avaliação é constante. Recebe o tempo por parâmetro,
+// como a proteção, e roda igual no firmware e no replay.
+
+#define FUSAO_VOTO_PCT 50         // Evidência mínima para uma fonte votar
+#define FUSAO_HISTERESE_PCT 80    // Incêndio decidido se mantém até a pontuação cair abaixo disto (% do limiar)
+
+typedef enum
+{
+    FUSAO_CHAMA,          // Sensor de chama IR (entrada digital)
+    FUSAO_FUMACA,         // Sensor de fumaça (entrada analógica)
+    FUSAO_TEMPERATURA,    // Entre os limiares de atenção e crítico
+    FUSAO_TAXA,           // Entre zero e a taxa crítica
+    FUSAO_FONTES
+} fusao_fonte_t;
+
+typedef struct
+{
+    uint8_t peso[FUSAO_FONTES];   // Contribuição de cada fonte com evidência plena (0 = ignorada)
+    uint16_t limiar;              // Pontuação que caracteriza incêndio
+    uint8_t votos_imediatos;      // Fontes votando para decidir sem confirmação
+    uint16_t confirmacao_ms;      // Persistência exigida com menos votos
+} fusao_config_t;
+
+#define FUSAO_CONFIG_PADRAO {.peso = {100, 60, 50, 50}, .limiar = 100, .votos_imediatos = 2, .confirmacao_ms = 1000}
+
+typedef struct
+{
+    fusao_config_t config;
+
+    uint8_t evidencia[FUSAO_FONTES];   // Última avaliação (%)
+    uint16_t pontuacao;
+    uint8_t votos;                     // Bit i: fonte i votando
+
+    bool suspeita;                     // Pontuação no limiar aguardando confirmação
+    uint32_t inicio_suspeita_ms;
+    bool incendio;
+} fusao_t;
+
+extern const char *const fusao_nomes[FUSAO_FONTES];
+
+void fusao_iniciar(fusao_t *f, const fusao_config_t *config);
+
+// Evidência (%) de uma leitura entre 'zero' (0 %) e 'pleno' (100 %), saturada
+uint8_t fusao_evidencia(int32_t valor, int32_t zero, int32_t pleno);
+
+// Combina as evidências do ciclo (%, na ordem de fusao_fonte_t) e devolve a decisão
+bool fusao_avaliar(fusao_t *f, uint32_t agora_ms, const uint8_t *evidencia);
+
+static inline uint8_t fusao_num_votos(uint8_t votos)
+{
+    uint8_t n = 0;
+    for (; votos; votos &= (uint8_t)(votos - 1))
+        n++;
+    return n;
+}
+
+#endif // FUSAO_H
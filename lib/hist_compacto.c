@@ -0,0 +1,412 @@
+#include "hist_compacto.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define VARINT_MAX 5
+#define AMOSTRA_MAX_BYTES (2 * VARINT_MAX)   // Diferença + salto
+
+// CRC-16/CCITT (0x1021) por nibble: tabela de 32 bytes, duas consultas por byte
+static const uint16_t crc_nibble[16] = {0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7, 0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+static uint16_t crc16(uint16_t crc, const uint8_t *dados, uint32_t tamanho)
+{
+    for (uint32_t i = 0; i < tamanho; i++)
+    {
+        crc = (uint16_t)((crc << 4) ^ crc_nibble[(crc >> 12) ^ (dados[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc_nibble[(crc >> 12) ^ (dados[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+static uint16_t crc_bloco(const uint8_t *bloco)
+{
+    const compacto_cabecalho_t *cab = (const compacto_cabecalho_t *)bloco;
+    uint16_t crc = crc16(0xFFFF, bloco, offsetof(compacto_cabecalho_t, crc));
+    return crc16(crc, bloco + COMPACTO_CABECALHO_BYTES, cab->bytes);
+}
+
+static inline const compacto_cabecalho_t *cabecalho(const uint8_t *bloco)
+{
+    return (const compacto_cabecalho_t *)bloco;
+}
+
+static inline const uint8_t *bloco_flash(const compacto_t *c, uint32_t i)
+{
+    return c->regiao.base + i * COMPACTO_BLOCO_BYTES;
+}
+
+// Cabeçalho plausível: basta para pular o bloco sem decodificá-lo
+static bool cabecalho_plausivel(const compacto_cabecalho_t *cab)
+{
+    return cab->minuto != COMPACTO_VAZIO && cab->amostras > 0 && cab->bytes <= COMPACTO_DADOS_BYTES;
+}
+
+static bool bloco_valido(const uint8_t *bloco)
+{
+    return cabecalho_plausivel(cabecalho(bloco)) && crc_bloco(bloco) == cabecalho(bloco)->crc;
+}
+
+static bool em_branco(const uint8_t *dados, uint32_t tamanho)
+{
+    const uint32_t *p = (const uint32_t *)dados;
+    for (uint32_t i = 0; i < tamanho / 4; i++)
+        if (p[i] != 0xFFFFFFFFu)
+            return false;
+    return true;
+}
+
+static uint8_t escrever_varint(uint8_t *p, uint32_t valor)
+{
+    uint8_t n = 0;
+    while (valor >= 0x80)
+    {
+        p[n++] = (uint8_t)(valor | 0x80);
+        valor >>= 7;
+    }
+    p[n++] = (uint8_t)valor;
+    return n;
+}
+
+static uint32_t ler_varint(const uint8_t **p, const uint8_t *fim)
+{
+    uint32_t valor = 0;
+    for (uint8_t deslocamento = 0; *p < fim && deslocamento < 7 * VARINT_MAX; deslocamento += 7)
+    {
+        uint8_t byte = *(*p)++;
+        valor |= (uint32_t)(byte & 0x7F) << deslocamento;
+        if (!(byte & 0x80))
+            break;
+    }
+    return valor;
+}
+
+static inline uint32_t zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t dezigzag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+void compacto_abrir(compacto_t *c, const compacto_regiao_t *regiao)
+{
+    memset(c, 0, sizeof(*c));
+    c->regiao = *regiao;
+    c->num_blocos = regiao->tamanho / COMPACTO_BLOCO_BYTES;
+
+    // O bloco mais recente tem o maior minuto; a gravação segue após ele
+    uint32_t mais_recente = 0;
+    for (uint32_t i = 0; i < c->num_blocos; i++)
+    {
+        const uint8_t *b = bloco_flash(c, i);
+        if (!bloco_valido(b))
+            continue;
+        const compacto_cabecalho_t *cab = cabecalho(b);
+        uint32_t fim = cab->minuto + cab->duracao;
+        if (!c->tem_dados || fim > c->ultimo_minuto)
+        {
+            c->tem_dados = true;
+            c->ultimo_minuto = fim;
+            mais_recente = i;
+        }
+    }
+    c->proximo = c->tem_dados ? (mais_recente + 1) % c->num_blocos : 0;
+}
+
+// Posição da próxima gravação: o início de um setor ou um bloco em branco no meio
+// dele (blocos não vazios no meio de um setor são restos de uma gravação interrompida)
+static uint32_t posicao_livre(const compacto_t *c)
+{
+    uint32_t i = c->proximo;
+    while (i % COMPACTO_BLOCOS_SETOR != 0 && !em_branco(bloco_flash(c, i), COMPACTO_BLOCO_BYTES))
+        i = (i + 1) % c->num_blocos;
+    return i;
+}
+
+static bool setor_em_branco(const compacto_t *c, uint32_t setor)
+{
+    return em_branco(c->regiao.base + setor * COMPACTO_SETOR_BYTES, COMPACTO_SETOR_BYTES);
+}
+
+static void apagar_setor(compacto_t *c, uint32_t setor)
+{
+    c->regiao.apagar(setor * COMPACTO_SETOR_BYTES, c->regiao.contexto);
+    c->setores_apagados++;
+}
+
+bool compacto_precisa_apagar(const compacto_t *c)
+{
+    uint32_t i = posicao_livre(c);
+    return i % COMPACTO_BLOCOS_SETOR == 0 && !setor_em_branco(c, i / COMPACTO_BLOCOS_SETOR);
+}
+
+bool compacto_preparar(compacto_t *c)
+{
+    // Setor em que o anel entra a seguir: o da posição livre, se ela abre um setor, senão o seguinte
+    uint32_t setores = c->num_blocos / COMPACTO_BLOCOS_SETOR;
+    uint32_t setor = (posicao_livre(c) + COMPACTO_BLOCOS_SETOR - 1) / COMPACTO_BLOCOS_SETOR % setores;
+    if (setor_em_branco(c, setor))
+        return false;
+    apagar_setor(c, setor);
+    return true;
+}
+
+// Grava o bloco em montagem na próxima posição livre do anel
+static void gravar_bloco(compacto_t *c)
+{
+    // Início de setor ainda não preparado: apaga os blocos mais antigos aqui mesmo
+    c->proximo = posicao_livre(c);
+    if (c->proximo % COMPACTO_BLOCOS_SETOR == 0 && !setor_em_branco(c, c->proximo / COMPACTO_BLOCOS_SETOR))
+        apagar_setor(c, c->proximo / COMPACTO_BLOCOS_SETOR);
+
+    // A página leva o bloco na sua metade; o resto em 0xFF não altera o que já foi gravado
+    static uint8_t pagina[COMPACTO_PAGINA_BYTES];
+    uint32_t deslocamento = c->proximo * COMPACTO_BLOCO_BYTES;
+    uint32_t inicio_pagina = deslocamento & ~(uint32_t)(COMPACTO_PAGINA_BYTES - 1);
+    memset(pagina, 0xFF, sizeof(pagina));
+    memcpy(pagina + (deslocamento - inicio_pagina), c->bloco, COMPACTO_BLOCO_BYTES);
+    c->regiao.gravar(inicio_pagina, pagina, c->regiao.contexto);
+
+    c->proximo = (c->proximo + 1) % c->num_blocos;
+    c->blocos_gravados++;
+}
+
+void compacto_descarregar(compacto_t *c)
+{
+    compacto_cabecalho_t *cab = (compacto_cabecalho_t *)c->bloco;
+    if (cab->amostras == 0)
+        return;
+
+    memset(c->bloco + COMPACTO_CABECALHO_BYTES + cab->bytes, 0xFF, COMPACTO_DADOS_BYTES - cab->bytes);
+    cab->crc = crc_bloco(c->bloco);
+    gravar_bloco(c);
+    memset(c->bloco, 0, sizeof(c->bloco));
+}
+
+bool compacto_adicionar(compacto_t *c, uint32_t minuto, int16_t temp_dc)
+{
+    if (c->tem_dados && minuto <= c->ultimo_minuto)
+        return false;
+
+    compacto_cabecalho_t *cab = (compacto_cabecalho_t *)c->bloco;
+    if (cab->amostras > 0)
+    {
+        // Diferença em zigzag com o bit de salto; o salto (> 1 minuto) segue em varint
+        uint8_t codigo[AMOSTRA_MAX_BYTES];
+        uint32_t salto = minuto - c->ultimo_minuto;
+        uint32_t valor = zigzag((int32_t)temp_dc - c->anterior) << 1 | (salto > 1);
+        uint8_t n = escrever_varint(codigo, valor);
+        if (salto > 1)
+            n += escrever_varint(codigo + n, salto - 2);
+
+        bool cabe = cab->bytes + n <= COMPACTO_DADOS_BYTES && cab->amostras < UINT8_MAX &&
+                    minuto - cab->minuto <= UINT16_MAX;
+        if (cabe)
+        {
+            memcpy(c->bloco + COMPACTO_CABECALHO_BYTES + cab->bytes, codigo, n);
+            cab->bytes += n;
+            cab->amostras++;
+            cab->duracao = (uint16_t)(minuto - cab->minuto);
+            if (temp_dc < cab->min)
+                cab->min = temp_dc;
+            if (temp_dc > cab->max)
+                cab->max = temp_dc;
+            c->anterior = temp_dc;
+            c->ultimo_minuto = minuto;
+            return true;
+        }
+        compacto_descarregar(c);
+    }
+
+    // Primeira amostra do bloco vai inteira no cabeçalho
+    cab->minuto = minuto;
+    cab->duracao = 0;
+    cab->primeira = temp_dc;
+    cab->min = temp_dc;
+    cab->max = temp_dc;
+    cab->amostras = 1;
+    cab->bytes = 0;
+    c->anterior = temp_dc;
+    c->ultimo_minuto = minuto;
+    c->tem_dados = true;
+    return true;
+}
+
+// Decodifica as amostras do intervalo; false quando a varredura deve parar
+static bool decodificar(const uint8_t *bloco, const compacto_consulta_t *q, compacto_visitar_t visitar, void *contexto,
+                        uint32_t *amostras)
+{
+    const compacto_cabecalho_t *cab = cabecalho(bloco);
+    const uint8_t *p = bloco + COMPACTO_CABECALHO_BYTES;
+    const uint8_t *fim = p + cab->bytes;
+    uint32_t minuto = cab->minuto;
+    int32_t temp = cab->primeira;
+
+    for (uint8_t i = 0;; i++)
+    {
+        if (minuto > q->ate)
+            return false;
+        if (minuto >= q->de && temp >= q->acima_dc)
+        {
+            (*amostras)++;
+            if (!visitar(minuto, (int16_t)temp, contexto))
+                return false;
+        }
+        if (i + 1 >= cab->amostras)
+            return true;
+
+        uint32_t valor = ler_varint(&p, fim);
+        minuto += (valor & 1) ? ler_varint(&p, fim) + 2 : 1;
+        temp += dezigzag(valor >> 1);
+    }
+}
+
+// Aplica 'tratar' aos blocos válidos em ordem cronológica: anel a partir do mais
+// antigo e, por último, o bloco em montagem
+typedef bool (*tratar_bloco_t)(const uint8_t *bloco, bool na_flash, void *contexto);
+
+static void percorrer(const compacto_t *c, tratar_bloco_t tratar, void *contexto)
+{
+    for (uint32_t n = 0; n < c->num_blocos; n++)
+    {
+        const uint8_t *b = bloco_flash(c, (c->proximo + n) % c->num_blocos);
+        if (cabecalho_plausivel(cabecalho(b)) && !tratar(b, true, contexto))
+            return;
+    }
+    if (cabecalho(c->bloco)->amostras > 0)
+        tratar(c->bloco, false, contexto);
+}
+
+typedef struct
+{
+    const compacto_consulta_t *consulta;
+    compacto_visitar_t visitar;
+    void *contexto;
+    compacto_varredura_t *estatisticas;
+} varredura_t;
+
+static bool varrer_bloco(const uint8_t *bloco, bool na_flash, void *contexto)
+{
+    varredura_t *v = contexto;
+    const compacto_cabecalho_t *cab = cabecalho(bloco);
+    const compacto_consulta_t *q = v->consulta;
+
+    // Fora do intervalo ou abaixo do limiar: decide pelo cabeçalho
+    bool antes = cab->minuto + cab->duracao < q->de;
+    bool depois = cab->minuto > q->ate;
+    if (antes || (!depois && cab->max < q->acima_dc))
+    {
+        v->estatisticas->blocos_pulados++;
+        return true;
+    }
+    if (na_flash && !bloco_valido(bloco))
+        return true;   // Gravação interrompida
+    if (depois)
+        return false;
+
+    v->estatisticas->blocos_lidos++;
+    return decodificar(bloco, q, v->visitar, v->contexto, &v->estatisticas->amostras);
+}
+
+void compacto_varrer(const compacto_t *c, const compacto_consulta_t *consulta, compacto_visitar_t visitar,
+                     void *contexto, compacto_varredura_t *estatisticas)
+{
+    memset(estatisticas, 0, sizeof(*estatisticas));
+    varredura_t v = {consulta, visitar, contexto, estatisticas};
+    percorrer(c, varrer_bloco, &v);
+}
+
+typedef struct
+{
+    uint32_t de;
+    uint32_t ate;
+    bool achou;
+    int16_t min;
+    int16_t max;
+    compacto_varredura_t *estatisticas;
+} resumo_t;
+
+static void resumir(resumo_t *r, int16_t min, int16_t max)
+{
+    if (!r->achou || min < r->min)
+        r->min = min;
+    if (!r->achou || max > r->max)
+        r->max = max;
+    r->achou = true;
+}
+
+static bool resumir_amostra(uint32_t minuto, int16_t temp_dc, void *contexto)
+{
+    (void)minuto;
+    resumir(contexto, temp_dc, temp_dc);
+    return true;
+}
+
+static bool resumir_bloco(const uint8_t *bloco, bool na_flash, void *contexto)
+{
+    resumo_t *r = contexto;
+    const compacto_cabecalho_t *cab = cabecalho(bloco);
+    uint32_t fim = cab->minuto + cab->duracao;
+
+    if (fim < r->de)
+    {
+        r->estatisticas->blocos_pulados++;
+        return true;
+    }
+    if (na_flash && !bloco_valido(bloco))
+        return true;
+    if (cab->minuto > r->ate)
+        return false;
+
+    // Bloco inteiro no intervalo: o cabeçalho já traz mín/máx
+    if (cab->minuto >= r->de && fim <= r->ate)
+    {
+        r->estatisticas->blocos_pulados++;
+        r->estatisticas->amostras += cab->amostras;
+        resumir(r, cab->min, cab->max);
+        return true;
+    }
+
+    compacto_consulta_t q = {r->de, r->ate, INT16_MIN};
+    r->estatisticas->blocos_lidos++;
+    return decodificar(bloco, &q, resumir_amostra, r, &r->estatisticas->amostras);
+}
+
+bool compacto_resumo(const compacto_t *c, uint32_t de, uint32_t ate, int16_t *min, int16_t *max,
+                     compacto_varredura_t *estatisticas)
+{
+    memset(estatisticas, 0, sizeof(*estatisticas));
+    resumo_t r = {.de = de, .ate = ate, .estatisticas = estatisticas};
+    percorrer(c, resumir_bloco, &r);
+    *min = r.min;
+    *max = r.max;
+    return r.achou;
+}
+
+static bool contar_bloco(const uint8_t *bloco, bool na_flash, void *contexto)
+{
+    compacto_ocupacao_t *o = contexto;
+    const compacto_cabecalho_t *cab = cabecalho(bloco);
+    if (na_flash && !bloco_valido(bloco))
+        return true;
+
+    if (o->amostras == 0)
+        o->primeiro_minuto = cab->minuto;
+    o->ultimo_minuto = cab->minuto + cab->duracao;
+    o->amostras += cab->amostras;
+    if (na_flash)
+    {
+        o->blocos++;
+        o->bytes += COMPACTO_BLOCO_BYTES;
+    }
+    return true;
+}
+
+void compacto_ocupacao(const compacto_t *c, compacto_ocupacao_t *ocupacao)
+{
+    memset(ocupacao, 0, sizeof(*ocupacao));
+    percorrer(c, contar_bloco, ocupacao);
+}
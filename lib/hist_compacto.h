@@ -0,0 +1,134 @@
+#ifndef HIST_COMPACTO_H
+#define HIST_COMPACTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ===============================
+// === HISTÓRICO COMPACTO EM FLASH ===
+// ===============================
+// Série de médias por minuto (décimos de °C) gravada em blocos de 128 bytes.
+// Cada bloco tem um cabeçalho de 16 bytes: minuto inicial, duração, primeira
+// amostra, mín/máx e CRC16. Depois vêm as demais amostras, cada uma com a
+// diferença para a anterior em zigzag + varint. O bit baixo marca um salto de
+// mais de um minuto, e o salto segue em varint. Em regime uma amostra ocupa
+// 1 byte, contra 4 do float de SystemStatus.current_temp.
+//
+// A região é um anel de setores de 4 KB gravado em ordem cronológica. Quando
+// o anel dá a volta, o setor mais antigo é apagado inteiro, de preferência com
+// antecedência (compacto_preparar), no momento que o chamador escolher. Na
+// consulta, o cabeçalho basta para pular blocos fora do intervalo ou abaixo do
+// limiar procurado. O resumo usa só o mín/máx do cabeçalho dos blocos inteiramente
+// dentro do intervalo e decodifica apenas os das pontas.
+//
+// Independente de hardware: leitura direta por ponteiro (XIP no firmware) e
+// apagamento/gravação por callbacks (lib/hist_flash.c no firmware, RAM em
+// tools/bench_hist_compacto.c).
+
+#define COMPACTO_BLOCO_BYTES     128
+#define COMPACTO_CABECALHO_BYTES 16
+#define COMPACTO_DADOS_BYTES     (COMPACTO_BLOCO_BYTES - COMPACTO_CABECALHO_BYTES)
+#define COMPACTO_PAGINA_BYTES    256    // Unidade de gravação da flash
+#define COMPACTO_SETOR_BYTES     4096   // Unidade de apagamento da flash
+#define COMPACTO_BLOCOS_SETOR    (COMPACTO_SETOR_BYTES / COMPACTO_BLOCO_BYTES)
+#define COMPACTO_VAZIO           0xFFFFFFFFu   // 'minuto' de um bloco apagado
+
+typedef struct
+{
+    uint32_t minuto;     // Minuto da primeira amostra (COMPACTO_VAZIO: bloco apagado)
+    uint16_t duracao;    // Último minuto do bloco menos o primeiro
+    int16_t primeira;    // Primeira amostra (décimos de °C)
+    int16_t min;
+    int16_t max;
+    uint8_t amostras;
+    uint8_t bytes;       // Bytes de dados após o cabeçalho
+    uint16_t crc;        // CRC16 do cabeçalho (sem este campo) e dos dados
+} compacto_cabecalho_t;
+
+_Static_assert(sizeof(compacto_cabecalho_t) == COMPACTO_CABECALHO_BYTES, "cabeçalho do bloco com padding");
+
+// Região da flash: tamanho múltiplo de COMPACTO_SETOR_BYTES
+typedef struct
+{
+    const uint8_t *base;   // Leitura direta
+    uint32_t tamanho;
+    void (*apagar)(uint32_t deslocamento, void *contexto);                        // Um setor
+    void (*gravar)(uint32_t deslocamento, const uint8_t *pagina, void *contexto);  // Uma página
+    void *contexto;
+} compacto_regiao_t;
+
+typedef struct
+{
+    compacto_regiao_t regiao;
+    uint32_t num_blocos;
+    uint32_t proximo;                        // Posição do próximo bloco a gravar
+
+    _Alignas(4) uint8_t bloco[COMPACTO_BLOCO_BYTES];   // Bloco em montagem na RAM
+    bool tem_dados;                          // Alguma amostra registrada (gravada ou em montagem)
+    uint32_t ultimo_minuto;
+    int16_t anterior;
+
+    uint32_t blocos_gravados;                // Desde compacto_abrir
+    uint32_t setores_apagados;
+} compacto_t;
+
+// Intervalo [de, ate] em minutos; só amostras >= acima_dc (INT16_MIN: todas)
+typedef struct
+{
+    uint32_t de;
+    uint32_t ate;
+    int16_t acima_dc;
+} compacto_consulta_t;
+
+typedef struct
+{
+    uint32_t blocos_lidos;     // Decodificados
+    uint32_t blocos_pulados;   // Resolvidos só pelo cabeçalho, sem decodificar
+    uint32_t amostras;
+} compacto_varredura_t;
+
+typedef struct
+{
+    uint32_t blocos;           // Blocos válidos na flash
+    uint32_t amostras;         // Incluindo as do bloco em montagem
+    uint32_t bytes;            // Ocupação na flash
+    uint32_t primeiro_minuto;
+    uint32_t ultimo_minuto;
+} compacto_ocupacao_t;
+
+// Retorna false para encerrar a varredura
+typedef bool (*compacto_visitar_t)(uint32_t minuto, int16_t temp_dc, void *contexto);
+
+// Localiza o bloco mais recente e continua a gravação após ele
+void compacto_abrir(compacto_t *c, const compacto_regiao_t *regiao);
+
+// Acrescenta a amostra do minuto (crescente); grava o bloco quando ele enche
+bool compacto_adicionar(compacto_t *c, uint32_t minuto, int16_t temp_dc);
+
+// Grava o bloco em montagem mesmo incompleto (o restante dele fica sem uso)
+void compacto_descarregar(compacto_t *c);
+
+// A próxima gravação de bloco começaria apagando um setor
+bool compacto_precisa_apagar(const compacto_t *c);
+
+// Apaga com antecedência o setor em que o anel entra a seguir, para que as
+// próximas COMPACTO_BLOCOS_SETOR gravações só programem páginas. O anel perde
+// um setor de capacidade (o mais antigo). Retorna true se apagou.
+bool compacto_preparar(compacto_t *c);
+
+// Amostras do intervalo em ordem cronológica, da flash e do bloco em montagem
+void compacto_varrer(const compacto_t *c, const compacto_consulta_t *consulta, compacto_visitar_t visitar,
+                     void *contexto, compacto_varredura_t *estatisticas);
+
+// Mín/máx do intervalo; retorna false se não houver amostras nele
+bool compacto_resumo(const compacto_t *c, uint32_t de, uint32_t ate, int16_t *min, int16_t *max,
+                     compacto_varredura_t *estatisticas);
+
+void compacto_ocupacao(const compacto_t *c, compacto_ocupacao_t *ocupacao);
+
+static inline uint32_t compacto_amostras_em_montagem(const compacto_t *c)
+{
+    return ((const compacto_cabecalho_t *)c->bloco)->amostras;
+}
+
+#endif // HIST_COMPACTO_H
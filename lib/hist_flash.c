@@ -0,0 +1,192 @@
+#include "hist_flash.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "config.h"
+
+// Abaixo dos slots A/B da configuração (os dois últimos setores, lib/config.c)
+#define HIST_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - 2 * FLASH_SECTOR_SIZE - HIST_FLASH_BYTES)
+
+_Static_assert(FLASH_SECTOR_SIZE == COMPACTO_SETOR_BYTES && FLASH_PAGE_SIZE == COMPACTO_PAGINA_BYTES,
+               "geometria da flash diferente da do histórico compacto");
+
+extern char __flash_binary_end;   // Fim do programa na flash (script de link do SDK)
+
+static compacto_t hc;
+static bool ativo = false;
+static uint32_t minuto_base;          // Minuto da série no boot
+static uint32_t ultimo_periodo;       // Último período de 1 min passado à flash
+static bool algum_periodo = false;
+static bool apagar_permitido = false; // Último 'pode_apagar' recebido
+static uint32_t minutos_recusados;    // compacto_adicionar fora de ordem (não deveria ocorrer)
+
+// XIP fica indisponível durante apagamento/gravação: nada pode rodar da flash
+static void apagar(uint32_t deslocamento, void *contexto)
+{
+    uint32_t estado_irq = save_and_disable_interrupts();
+    flash_range_erase(HIST_FLASH_OFFSET + deslocamento, FLASH_SECTOR_SIZE);
+    restore_interrupts(estado_irq);
+}
+
+static void gravar(uint32_t deslocamento, const uint8_t *pagina, void *contexto)
+{
+    uint32_t estado_irq = save_and_disable_interrupts();
+    flash_range_program(HIST_FLASH_OFFSET + deslocamento, pagina, FLASH_PAGE_SIZE);
+    restore_interrupts(estado_irq);
+}
+
+uint32_t hist_flash_minuto(uint32_t periodo_boot)
+{
+    return minuto_base + periodo_boot;
+}
+
+// Mesmo relógio dos períodos de 1 min do histórico em RAM (time_us_64), então
+// gravações e consultas ficam na mesma linha do tempo
+static uint32_t minuto_agora(void)
+{
+    return hist_flash_minuto((uint32_t)(time_us_64() / 60000000u));
+}
+
+const compacto_t *hist_flash(void)
+{
+    return &hc;
+}
+
+void hist_flash_atualizar(const historico_t *h, bool pode_apagar)
+{
+    apagar_permitido = pode_apagar;
+    hist_bloco_t minuto;
+    if (!ativo || !hist_bloco(h, HIST_MINUTO, 0, &minuto))
+        return;
+    if (algum_periodo && minuto.periodo == ultimo_periodo)
+        return;
+
+    // Setor apagado antes de ser necessário: as gravações seguintes só programam páginas
+    if (pode_apagar)
+        compacto_preparar(&hc);
+
+    // Minutos pendentes do mais antigo ao mais recente
+    uint16_t idx = 0;
+    while (algum_periodo && hist_bloco(h, HIST_MINUTO, idx + 1, &minuto) && minuto.periodo > ultimo_periodo)
+        idx++;
+    for (;;)
+    {
+        if (!pode_apagar && compacto_precisa_apagar(&hc))
+            return;   // Fica no histórico em RAM até a volta a NORMAL
+        hist_bloco(h, HIST_MINUTO, idx, &minuto);
+        algum_periodo = true;
+        ultimo_periodo = minuto.periodo;
+        if (!compacto_adicionar(&hc, hist_flash_minuto(minuto.periodo), minuto.media) && minutos_recusados++ == 0)
+            printf("hist: minuto %lu recusado (anterior ao último gravado, %lu)\n",
+                   (unsigned long)hist_flash_minuto(minuto.periodo), (unsigned long)hc.ultimo_minuto);
+        if (idx == 0)
+            break;
+        idx--;
+    }
+}
+
+static void imprimir_resumo(uint32_t horas)
+{
+    uint32_t agora = minuto_agora();
+    uint32_t de = agora >= horas * 60u ? agora - horas * 60u : 0;
+    int16_t min, max;
+    compacto_varredura_t v;
+    uint64_t inicio = time_us_64();
+    bool achou = compacto_resumo(&hc, de, agora, &min, &max, &v);
+    uint32_t duracao_us = (uint32_t)(time_us_64() - inicio);
+
+    if (!achou)
+    {
+        printf("  últimas %lu h: sem amostras\n", (unsigned long)horas);
+        return;
+    }
+    printf("  últimas %lu h: mín %.1f °C, máx %.1f °C em %lu minutos (%lu blocos lidos, %lu pelo cabeçalho, %lu µs)\n",
+           (unsigned long)horas, min / 10.0f, max / 10.0f, (unsigned long)v.amostras, (unsigned long)v.blocos_lidos,
+           (unsigned long)v.blocos_pulados, (unsigned long)duracao_us);
+}
+
+typedef struct
+{
+    uint32_t primeiro;
+    uint32_t ultimo;
+} ocorrencias_t;
+
+static bool registrar_ocorrencia(uint32_t minuto, int16_t temp_dc, void *contexto)
+{
+    ocorrencias_t *o = contexto;
+    if (o->primeiro == COMPACTO_VAZIO)
+        o->primeiro = minuto;
+    o->ultimo = minuto;
+    return true;
+}
+
+static void imprimir_acima(int16_t limiar_dc)
+{
+    uint32_t agora = minuto_agora();
+    compacto_consulta_t consulta = {0, UINT32_MAX, limiar_dc};
+    compacto_varredura_t v;
+    ocorrencias_t o = {COMPACTO_VAZIO, 0};
+    compacto_varrer(&hc, &consulta, registrar_ocorrencia, &o, &v);
+
+    printf("hist: %lu minutos >= %.1f °C (%lu blocos lidos, %lu pulados)\n", (unsigned long)v.amostras,
+           limiar_dc / 10.0f, (unsigned long)v.blocos_lidos, (unsigned long)v.blocos_pulados);
+    if (v.amostras > 0)
+        printf("  primeiro há %lu min, último há %lu min\n", (unsigned long)(agora - o.primeiro),
+               (unsigned long)(agora - o.ultimo));
+}
+
+static void comando_hist(const char *argumento)
+{
+    if (!ativo)
+    {
+        printf("hist: região da flash ocupada pelo programa, histórico compacto desligado\n");
+        return;
+    }
+    if (argumento && strcmp(argumento, "gravar") == 0)
+    {
+        if (compacto_precisa_apagar(&hc) && !apagar_permitido)
+        {
+            printf("hist: gravar exige apagar um setor; aguarde o sistema voltar a NORMAL\n");
+            return;
+        }
+        compacto_descarregar(&hc);
+        printf("OK bloco em montagem gravado\n");
+        return;
+    }
+    if (argumento && strcmp(argumento, "acima") == 0)
+    {
+        imprimir_acima(config_atual()->limiar_atencao_dc);
+        return;
+    }
+
+    compacto_ocupacao_t o;
+    compacto_ocupacao(&hc, &o);
+    uint32_t amostras_flash = o.amostras - compacto_amostras_em_montagem(&hc);
+    printf("hist: %lu blocos (%lu de %u KB), %lu minutos (%.1f dias), %.2f B/minuto\n", (unsigned long)o.blocos,
+           (unsigned long)(o.bytes / 1024), HIST_FLASH_BYTES / 1024, (unsigned long)o.amostras, o.amostras / 1440.0f,
+           amostras_flash ? (float)o.bytes / amostras_flash : 0.0f);
+    printf("  %lu minutos no bloco em montagem; %lu blocos gravados e %lu setores apagados desde o boot\n",
+           (unsigned long)compacto_amostras_em_montagem(&hc), (unsigned long)hc.blocos_gravados,
+           (unsigned long)hc.setores_apagados);
+    if (minutos_recusados)
+        printf("  AVISO: %lu minutos recusados por estarem fora de ordem\n", (unsigned long)minutos_recusados);
+    imprimir_resumo(argumento && argumento[0] ? (uint32_t)atoi(argumento) : 24);
+}
+
+bool hist_flash_iniciar(void)
+{
+    config_console_registrar("hist", comando_hist);
+    if ((uintptr_t)&__flash_binary_end > XIP_BASE + HIST_FLASH_OFFSET)
+        return false;
+
+    compacto_regiao_t regiao = {(const uint8_t *)(XIP_BASE + HIST_FLASH_OFFSET), HIST_FLASH_BYTES, apagar, gravar, NULL};
+    compacto_abrir(&hc, &regiao);
+    minuto_base = hc.tem_dados ? hc.ultimo_minuto + 1 : 0;
+    ativo = true;
+    return true;
+}
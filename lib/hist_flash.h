@@ -0,0 +1,39 @@
+#ifndef HIST_FLASH_H
+#define HIST_FLASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "historico.h"
+#include "hist_compacto.h"
+
+// ===============================
+// === HISTÓRICO COMPACTO NA FLASH (FIRMWARE) ===
+// ===============================
+// Região de HIST_FLASH_BYTES logo abaixo dos slots A/B da configuração,
+// alimentada pelas médias por minuto do histórico em RAM. Sem RTC, o tempo é
+// contado em minutos de operação: após um reinício a série continua do último
+// minuto gravado. Gravar uma página (a cada ~110 minutos) para as interrupções
+// por ~0,4 ms (até 3 ms); apagar um setor, por dezenas de ms (até ~400 ms).
+// Por isso o setor seguinte do anel é apagado com antecedência, só em NORMAL,
+// e fora de NORMAL os minutos que exigiriam apagar esperam no histórico em RAM
+// (3 h), como o "salvar" da configuração. O bloco em montagem fica na RAM até
+// encher; "hist gravar" o descarrega antes de um desligamento planejado.
+
+#define HIST_FLASH_BYTES (128 * 1024)   // 32 setores: ~11 semanas de médias por minuto
+
+// Abre a região e registra o comando "hist"; false se o programa a invadir
+bool hist_flash_iniciar(void);
+
+// Passa para a flash os minutos fechados do histórico em RAM que ainda não foram.
+// Com 'pode_apagar' (sistema em NORMAL) também prepara o próximo setor do anel.
+void hist_flash_atualizar(const historico_t *h, bool pode_apagar);
+
+// Minuto da série compacta correspondente a um período de 1 min desde o boot,
+// contado em 64 bits (time_us_64 / 60 s, o mesmo de hist_adicionar): não volta
+// a zero com o relógio de 32 bits em ms e é o que as consultas do "hist" usam
+uint32_t hist_flash_minuto(uint32_t periodo_boot);
+
+const compacto_t *hist_flash(void);
+
+#endif // HIST_FLASH_H
@@ -0,0 +1,199 @@
+#include "historico.h"
+
+#include <string.h>
+
+// Duração de cada nível em milissegundos
+static const uint32_t duracao_nivel_ms[HIST_NUM_NIVEIS] = {1000u, 60000u, 3600000u};
+
+static const uint16_t capacidade_nivel[HIST_NUM_NIVEIS] = {HIST_CAP_SEGUNDO, HIST_CAP_MINUTO, HIST_CAP_HORA};
+
+static hist_bloco_t *buffer_nivel(historico_t *h, hist_nivel_t nivel)
+{
+    switch (nivel)
+    {
+    case HIST_SEGUNDO:
+        return h->segundos;
+    case HIST_MINUTO:
+        return h->minutos;
+    default:
+        return h->horas;
+    }
+}
+
+// Posição física do elemento idx (0 = mais recente) num anel de capacidade cap
+static uint16_t posicao_anel(const hist_anel_t *anel, uint16_t cap, uint16_t idx)
+{
+    uint16_t pos = anel->cabeca + cap - 1 - idx;
+    return pos >= cap ? pos - cap : pos;
+}
+
+static void avancar_anel(hist_anel_t *anel, uint16_t cap)
+{
+    anel->cabeca = (anel->cabeca + 1 == cap) ? 0 : anel->cabeca + 1;
+    if (anel->total < cap)
+        anel->total++;
+}
+
+static void acumular(hist_acumulador_t *acc, uint32_t periodo, int32_t soma, uint32_t n, int16_t min, int16_t max)
+{
+    if (acc->n == 0)
+    {
+        acc->periodo = periodo;
+        acc->min = min;
+        acc->max = max;
+    }
+    else
+    {
+        if (min < acc->min)
+            acc->min = min;
+        if (max > acc->max)
+            acc->max = max;
+    }
+    acc->soma += soma;
+    acc->n += n;
+}
+
+// Fecha o período em andamento do nível e propaga o agregado ao nível acima
+static void fechar_nivel(historico_t *h, hist_nivel_t nivel)
+{
+    hist_acumulador_t *acc = &h->acumuladores[nivel];
+    if (acc->n == 0)
+        return;
+
+    hist_bloco_t *bloco = &buffer_nivel(h, nivel)[h->aneis[nivel].cabeca];
+    bloco->periodo = acc->periodo;
+    bloco->amostras = acc->n;
+    bloco->min = acc->min;
+    bloco->max = acc->max;
+    bloco->media = (int16_t)(acc->soma / (int32_t)acc->n);
+    avancar_anel(&h->aneis[nivel], capacidade_nivel[nivel]);
+
+    if (nivel + 1 < HIST_NUM_NIVEIS)
+    {
+        hist_nivel_t acima = (hist_nivel_t)(nivel + 1);
+        uint32_t periodo_acima = (uint32_t)(((uint64_t)acc->periodo * duracao_nivel_ms[nivel]) / duracao_nivel_ms[acima]);
+        hist_acumulador_t *acc_acima = &h->acumuladores[acima];
+
+        if (acc_acima->n != 0 && acc_acima->periodo != periodo_acima)
+            fechar_nivel(h, acima);
+        acumular(acc_acima, periodo_acima, acc->soma, acc->n, acc->min, acc->max);
+    }
+
+    acc->soma = 0;
+    acc->n = 0;
+}
+
+void hist_iniciar(historico_t *h)
+{
+    memset(h, 0, sizeof(*h));
+}
+
+void hist_adicionar(historico_t *h, uint64_t tempo_ms, int16_t temp_dc)
+{
+    // --- Amostra bruta ---
+    h->brutas[h->anel_brutas.cabeca] = temp_dc;
+    h->brutas_tempo_ms[h->anel_brutas.cabeca] = (uint32_t)tempo_ms;
+    avancar_anel(&h->anel_brutas, HIST_AMOSTRAS_BRUTAS);
+
+    // --- Nível de 1 s (os demais são alimentados em cascata) ---
+    uint32_t periodo = (uint32_t)(tempo_ms / duracao_nivel_ms[HIST_SEGUNDO]);   // 136 anos em 32 bits
+    hist_acumulador_t *acc = &h->acumuladores[HIST_SEGUNDO];
+    if (acc->n != 0 && acc->periodo != periodo)
+        fechar_nivel(h, HIST_SEGUNDO);
+    acumular(acc, periodo, temp_dc, 1, temp_dc, temp_dc);
+}
+
+uint16_t hist_quantidade_brutas(const historico_t *h)
+{
+    return h->anel_brutas.total;
+}
+
+bool hist_bruta(const historico_t *h, uint16_t idx, int16_t *temp_dc, uint32_t *tempo_ms)
+{
+    if (idx >= h->anel_brutas.total)
+        return false;
+
+    uint16_t pos = posicao_anel(&h->anel_brutas, HIST_AMOSTRAS_BRUTAS, idx);
+    if (temp_dc)
+        *temp_dc = h->brutas[pos];
+    if (tempo_ms)
+        *tempo_ms = h->brutas_tempo_ms[pos];
+    return true;
+}
+
+uint16_t hist_quantidade(const historico_t *h, hist_nivel_t nivel)
+{
+    return h->aneis[nivel].total;
+}
+
+bool hist_bloco(const historico_t *h, hist_nivel_t nivel, uint16_t idx, hist_bloco_t *saida)
+{
+    if (idx >= h->aneis[nivel].total)
+        return false;
+
+    uint16_t pos = posicao_anel(&h->aneis[nivel], capacidade_nivel[nivel], idx);
+    *saida = buffer_nivel((historico_t *)h, nivel)[pos];
+    return true;
+}
+
+// Acumula um bloco no resumo; a média é ponderada pelas amostras do bloco
+static void resumir_bloco(hist_bloco_t *saida, int64_t *soma, const hist_bloco_t *bloco)
+{
+    if (saida->amostras == 0)
+    {
+        saida->min = bloco->min;
+        saida->max = bloco->max;
+    }
+    else
+    {
+        if (bloco->min < saida->min)
+            saida->min = bloco->min;
+        if (bloco->max > saida->max)
+            saida->max = bloco->max;
+    }
+    saida->periodo = bloco->periodo;   // Percorrido do mais recente ao mais antigo
+    saida->amostras += bloco->amostras;
+    *soma += (int64_t)bloco->media * bloco->amostras;
+}
+
+static bool fechar_resumo(hist_bloco_t *saida, int64_t soma)
+{
+    if (saida->amostras == 0)
+        return false;
+    saida->media = (int16_t)(soma / saida->amostras);
+    return true;
+}
+
+bool hist_resumo(const historico_t *h, hist_nivel_t nivel, uint16_t quantidade, hist_bloco_t *saida)
+{
+    if (quantidade > h->aneis[nivel].total)
+        quantidade = h->aneis[nivel].total;
+
+    int64_t soma = 0;
+    hist_bloco_t bloco;
+    memset(saida, 0, sizeof(*saida));
+    for (uint16_t i = 0; i < quantidade; i++)
+    {
+        hist_bloco(h, nivel, i, &bloco);
+        resumir_bloco(saida, &soma, &bloco);
+    }
+    return fechar_resumo(saida, soma);
+}
+
+bool hist_resumo_intervalo(const historico_t *h, hist_nivel_t nivel, uint64_t de_ms, uint64_t ate_ms,
+                           hist_bloco_t *saida)
+{
+    // Blocos em ordem cronológica: do mais recente para trás até sair do intervalo.
+    // Períodos da base de 64 bits, então a comparação direta não sofre com a volta do relógio.
+    uint64_t de = de_ms / duracao_nivel_ms[nivel];
+    uint64_t ate = ate_ms / duracao_nivel_ms[nivel];
+    int64_t soma = 0;
+    hist_bloco_t bloco;
+    memset(saida, 0, sizeof(*saida));
+    for (uint16_t i = 0; hist_bloco(h, nivel, i, &bloco) && bloco.periodo >= de; i++)
+    {
+        if (bloco.periodo <= ate)
+            resumir_bloco(saida, &soma, &bloco);
+    }
+    return fechar_resumo(saida, soma);
+}
@@ -0,0 +1,98 @@
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ===============================
+// === HISTÓRICO DE TEMPERATURA ===
+// ===============================
+// Série temporal em RAM com memória fixa: amostras brutas recentes e
+// agregados (mín/máx/média) em três níveis de resolução (1 s, 1 min, 1 h).
+// Temperaturas em décimos de grau Celsius (ex: 253 = 25.3 °C). O tempo é de
+// 64 bits desde o boot: os índices de período (segundos, minutos e horas) só
+// crescem, e o relógio de 32 bits em ms, que volta a zero em ~49,7 dias, não
+// embaralha a ordem dos blocos nem as consultas por intervalo.
+
+// --- Capacidade de cada buffer circular ---
+#define HIST_AMOSTRAS_BRUTAS 600   // ~60 s de amostras brutas (laço de 100 ms)
+#define HIST_CAP_SEGUNDO     300   // 5 minutos em blocos de 1 s
+#define HIST_CAP_MINUTO      180   // 3 horas em blocos de 1 min
+#define HIST_CAP_HORA        72    // 3 dias em blocos de 1 h
+
+// Orçamento máximo de RAM para o histórico (verificado em tempo de compilação)
+#define HIST_ORCAMENTO_BYTES (13 * 1024)
+
+typedef enum
+{
+    HIST_SEGUNDO,
+    HIST_MINUTO,
+    HIST_HORA,
+    HIST_NUM_NIVEIS
+} hist_nivel_t;
+
+// Bloco agregado de um período (segundo, minuto ou hora)
+typedef struct
+{
+    uint32_t periodo;   // Índice do período (tempo_ms de 64 bits / duração do nível)
+    uint32_t amostras;  // Amostras brutas agregadas (peso da média nos resumos)
+    int16_t min;
+    int16_t max;
+    int16_t media;
+} hist_bloco_t;
+
+// Acumulador do período em andamento de cada nível
+typedef struct
+{
+    uint32_t periodo;
+    int32_t soma;
+    uint32_t n;
+    int16_t min;
+    int16_t max;
+} hist_acumulador_t;
+
+// Controle de um buffer circular (cabeça = próxima posição de escrita)
+typedef struct
+{
+    uint16_t cabeca;
+    uint16_t total;
+} hist_anel_t;
+
+typedef struct
+{
+    int16_t brutas[HIST_AMOSTRAS_BRUTAS];
+    uint32_t brutas_tempo_ms[HIST_AMOSTRAS_BRUTAS];   // 32 bits baixos do tempo (diferenças entre amostras)
+    hist_anel_t anel_brutas;
+
+    hist_bloco_t segundos[HIST_CAP_SEGUNDO];
+    hist_bloco_t minutos[HIST_CAP_MINUTO];
+    hist_bloco_t horas[HIST_CAP_HORA];
+    hist_anel_t aneis[HIST_NUM_NIVEIS];
+
+    hist_acumulador_t acumuladores[HIST_NUM_NIVEIS];
+} historico_t;
+
+_Static_assert(sizeof(historico_t) <= HIST_ORCAMENTO_BYTES,
+               "historico_t excede HIST_ORCAMENTO_BYTES");
+
+void hist_iniciar(historico_t *h);
+
+// Insere uma amostra (O(1)); fecha e propaga os blocos dos níveis superiores
+void hist_adicionar(historico_t *h, uint64_t tempo_ms, int16_t temp_dc);
+
+// Consultas: idx 0 = mais recente. Retornam false se idx não existir.
+uint16_t hist_quantidade_brutas(const historico_t *h);
+bool hist_bruta(const historico_t *h, uint16_t idx, int16_t *temp_dc, uint32_t *tempo_ms);
+uint16_t hist_quantidade(const historico_t *h, hist_nivel_t nivel);
+bool hist_bloco(const historico_t *h, hist_nivel_t nivel, uint16_t idx, hist_bloco_t *saida);
+
+// Resume os últimos 'quantidade' blocos fechados do nível: mín/máx e média
+// ponderada pelas amostras de cada bloco. saida->periodo é o do bloco mais antigo.
+bool hist_resumo(const historico_t *h, hist_nivel_t nivel, uint16_t quantidade, hist_bloco_t *saida);
+
+// Resume os blocos fechados do nível cujo período começa em [de_ms, ate_ms].
+// Retorna false se nenhum bloco retido cair no intervalo.
+bool hist_resumo_intervalo(const historico_t *h, hist_nivel_t nivel, uint64_t de_ms, uint64_t ate_ms,
+                           hist_bloco_t *saida);
+
+#endif // HISTORICO_H
@@ -0,0 +1,132 @@
+#include "latencia.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "config.h"
+
+#define CONTENCAO_PERIODO_US 1000
+#define CONTENCAO_PALAVRAS   256   // 1 KiB sem cache por disparo (~60 µs de QSPI)
+
+static latencia_t medidas[LAT_NUM_PONTOS][2];   // [ponto][sem/com contenção]
+static volatile bool contencao = false;
+static repeating_timer_t timer_contencao;
+static uint32_t posicao_leitura = 0;
+static volatile uint32_t descarte;
+
+static const char *const nomes[LAT_NUM_PONTOS] = {"IRQ entradas", "Proteção", "Borda->CRÍTICO", "Repouso->decisão"};
+
+void __not_in_flash_func(latencia_registrar)(latencia_ponto_t ponto, uint32_t valor)
+{
+    latencia_t *l = &medidas[ponto][contencao];
+    l->ultimo = valor;
+    if (valor > l->pior)
+        l->pior = valor;
+    l->amostras++;
+}
+
+// Esvazia a cache do XIP e faz uma rajada de leituras sem cache: o próximo
+// código executado da flash volta a pagar o acesso QSPI, agora disputado
+static bool __not_in_flash_func(gerar_contencao)(repeating_timer_t *t)
+{
+    xip_ctrl_hw->flush = 1;
+    (void)xip_ctrl_hw->flush;   // A leitura espera o fim do flush
+
+    const volatile uint32_t *flash = (const volatile uint32_t *)XIP_NOCACHE_NOALLOC_BASE;
+    uint32_t soma = 0;
+    for (uint32_t i = 0; i < CONTENCAO_PALAVRAS; i++)
+        soma += flash[(posicao_leitura + i) % (PICO_FLASH_SIZE_BYTES / 4)];
+    posicao_leitura = (posicao_leitura + 4099u) % (PICO_FLASH_SIZE_BYTES / 4);
+    descarte = soma;
+    return true;
+}
+
+void latencia_contencao_xip(bool ativa)
+{
+    if (ativa == contencao)
+        return;
+    if (ativa)
+        add_repeating_timer_us(-CONTENCAO_PERIODO_US, gerar_contencao, NULL, &timer_contencao);
+    else
+        cancel_repeating_timer(&timer_contencao);
+    contencao = ativa;
+}
+
+bool latencia_contencao_ativa(void)
+{
+    return contencao;
+}
+
+const latencia_t *latencia_medida(latencia_ponto_t ponto, bool com_contencao)
+{
+    return &medidas[ponto][com_contencao ? 1 : 0];
+}
+
+void latencia_zerar(void)
+{
+    memset(medidas, 0, sizeof(medidas));
+}
+
+// Ciclos de clk_sys em µs (precisão de centésimos)
+static void imprimir_ciclos(const latencia_t *l, uint32_t mhz)
+{
+    uint32_t cent = (l->pior * 100u) / mhz;
+    printf(" %7lu cic %4lu.%02lu µs |", (unsigned long)l->pior,
+           (unsigned long)(cent / 100), (unsigned long)(cent % 100));
+}
+
+void latencia_imprimir(void)
+{
+    uint32_t mhz = clock_get_hz(clk_sys) / 1000000u;
+
+    printf("\n--- LATÊNCIA (pior caso; contenção XIP %s) ---\n", contencao ? "LIGADA" : "desligada");
+    printf("%-16s | %-26s | %-26s\n", "", "sem contenção", "com contenção");
+    for (int p = 0; p < LAT_NUM_PONTOS; p++)
+    {
+        printf("%-16s |", nomes[p]);
+        for (int c = 0; c < 2; c++)
+        {
+            const latencia_t *l = &medidas[p][c];
+            if (l->amostras == 0)
+                printf(" %-25s |", "-");
+            else if (p == LAT_BORDA_DISPARO || p == LAT_DESPERTAR)
+                printf(" %10lu µs (%5lu)      |", (unsigned long)l->pior, (unsigned long)l->amostras);
+            else
+                imprimir_ciclos(l, mhz);
+        }
+        printf("\n");
+    }
+}
+
+static void comando_lat(const char *argumento)
+{
+    if (argumento && strcmp(argumento, "zerar") == 0)
+    {
+        latencia_zerar();
+        printf("OK medidas de latência zeradas\n");
+        return;
+    }
+    latencia_imprimir();
+}
+
+static void comando_xip(const char *argumento)
+{
+    latencia_contencao_xip(argumento && atoi(argumento) != 0);
+    printf("OK contenção no XIP %s\n", contencao ? "ligada" : "desligada");
+}
+
+void latencia_iniciar(void)
+{
+    // SysTick livre de 24 bits no clock do processador
+    systick_hw->csr = 0;
+    systick_hw->rvr = 0x00FFFFFFu;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+
+    config_console_registrar("lat", comando_lat);
+    config_console_registrar("xip", comando_xip);
+}
@@ -0,0 +1,75 @@
+#ifndef LATENCIA_H
+#define LATENCIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "hardware/structs/systick.h"
+#include "hardware/structs/timer.h"
+
+// ===============================
+// === MEDIÇÃO DE LATÊNCIA ===
+// ===============================
+// Pior caso da IRQ das entradas e do caminho de proteção em ciclos de clk_sys
+// (SysTick de 24 bits, núcleo 0), e da borda do sensor de fogo até o estado
+// CRÍTICO publicado e do despertar do repouso até a decisão, em µs. Cada
+// medida é guardada separadamente com e sem contenção no XIP: o comando
+// "xip 1" liga um gerador que esvazia a cache e ocupa o barramento QSPI a cada
+// milissegundo, como uma gravação de log.
+
+typedef enum
+{
+    LAT_IRQ_ENTRADAS,    // Duração da IRQ do PIO1 (ciclos)
+    LAT_PROTECAO,        // NTC + taxa + decisão (ciclos)
+    LAT_BORDA_DISPARO,   // Borda do fogo até CRÍTICO publicado (µs)
+    LAT_DESPERTAR,       // Evento em repouso (fogo ou limiar) até a decisão da proteção (µs)
+    LAT_NUM_PONTOS
+} latencia_ponto_t;
+
+typedef struct
+{
+    uint32_t ultimo;
+    uint32_t pior;
+    uint32_t amostras;
+} latencia_t;
+
+// Liga o SysTick e registra os comandos "lat" e "xip" no console
+void latencia_iniciar(void);
+
+// Contador decrescente do SysTick: só lê um registrador, seguro em código na RAM
+static inline uint32_t latencia_ciclos(void)
+{
+    return systick_hw->cvr;
+}
+
+void latencia_registrar(latencia_ponto_t ponto, uint32_t valor);
+
+static inline void latencia_fim(latencia_ponto_t ponto, uint32_t inicio)
+{
+    latencia_registrar(ponto, (inicio - systick_hw->cvr) & 0x00FFFFFFu);
+}
+
+// Relógio de 64 bits lido direto do timer (time_us_64 do SDK executa da flash)
+static inline uint64_t latencia_agora_us(void)
+{
+    uint32_t alto = timer_hw->timerawh;
+    uint32_t baixo;
+    while (true)
+    {
+        baixo = timer_hw->timerawl;
+        uint32_t alto2 = timer_hw->timerawh;
+        if (alto2 == alto)
+            break;
+        alto = alto2;
+    }
+    return ((uint64_t)alto << 32) | baixo;
+}
+
+void latencia_contencao_xip(bool ativa);
+bool latencia_contencao_ativa(void);
+
+const latencia_t *latencia_medida(latencia_ponto_t ponto, bool com_contencao);
+void latencia_zerar(void);
+void latencia_imprimir(void);
+
+#endif // LATENCIA_H
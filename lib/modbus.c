@@ -0,0 +1,211 @@
+#include "modbus.h"
+
+#include <string.h>
+
+#define FC_LER_HOLDING   0x03
+#define FC_LER_ENTRADA   0x04
+#define FC_ESCREVER_UM   0x06
+#define FC_ESCREVER_VARIOS 0x10
+
+#define LEITURA_MAX      125   // Registradores por leitura (limite do protocolo)
+#define ESCRITA_MAX      123
+
+uint16_t modbus_crc16(const uint8_t *dados, uint16_t tamanho)
+{
+    uint16_t crc = 0xFFFF;
+    while (tamanho--)
+    {
+        crc ^= *dados++;
+        for (int i = 0; i < 8; i++)
+            crc = (crc >> 1) ^ (0xA001u & -(crc & 1u));
+    }
+    return crc;
+}
+
+uint32_t modbus_silencio_us(uint32_t baud)
+{
+    return baud > 19200 ? 1750 : (38500000u + baud - 1) / baud;
+}
+
+uint32_t modbus_tempo_quadro_us(uint32_t baud, uint16_t bytes)
+{
+    return (uint32_t)(((uint64_t)bytes * 11000000u + baud - 1) / baud);
+}
+
+uint16_t modbus_montar_leitura(uint8_t *quadro, uint8_t escravo, bool holding, uint16_t inicio, uint16_t quantidade)
+{
+    quadro[0] = escravo;
+    quadro[1] = holding ? FC_LER_HOLDING : FC_LER_ENTRADA;
+    quadro[2] = (uint8_t)(inicio >> 8);
+    quadro[3] = (uint8_t)inicio;
+    quadro[4] = (uint8_t)(quantidade >> 8);
+    quadro[5] = (uint8_t)quantidade;
+    uint16_t crc = modbus_crc16(quadro, 6);
+    quadro[6] = (uint8_t)crc;   // CRC sai com o byte baixo primeiro
+    quadro[7] = (uint8_t)(crc >> 8);
+    return 8;
+}
+
+static uint16_t ler_u16_be(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+// Bloco que contém todo o intervalo [inicio, inicio + quantidade)
+static const modbus_bloco_t *achar_bloco(const modbus_mapa_t *mapa, bool holding, uint16_t inicio, uint16_t quantidade)
+{
+    for (uint8_t i = 0; i < mapa->num_blocos; i++)
+    {
+        const modbus_bloco_t *b = &mapa->blocos[i];
+        if (b->holding == holding && inicio >= b->primeiro &&
+            (uint32_t)inicio + quantidade <= (uint32_t)b->primeiro + b->quantidade)
+            return b;
+    }
+    return NULL;
+}
+
+static uint16_t codificar(const uint8_t *base, const modbus_reg_t *reg)
+{
+    const uint8_t *p = base + reg->deslocamento;
+    uint32_t u32;
+
+    switch (reg->tipo)
+    {
+    case MB_U8:
+        return *p;
+    case MB_I8:
+        return (uint16_t)(int16_t)*(const int8_t *)p;
+    case MB_U16:
+    case MB_I16:
+        return *(const uint16_t *)p;
+    case MB_U32_ALTO:
+        memcpy(&u32, p, sizeof(u32));
+        return (uint16_t)(u32 >> 16);
+    case MB_U32_BAIXO:
+        memcpy(&u32, p, sizeof(u32));
+        return (uint16_t)u32;
+    default:
+    {
+        float f = *(const float *)p * 10.0f;
+        return (uint16_t)(int16_t)(f >= 0 ? f + 0.5f : f - 0.5f);
+    }
+    }
+}
+
+// Codifica os registradores direto do dado vivo para o quadro de resposta
+static void ler_bloco(const modbus_bloco_t *b, uint16_t inicio, uint16_t quantidade, uint8_t *saida)
+{
+    uint32_t marca = 0;
+    const modbus_reg_t *regs = &b->regs[inicio - b->primeiro];
+
+    do
+    {
+        const uint8_t *base = b->abrir ? b->abrir(&marca) : b->base;
+        for (uint16_t i = 0; i < quantidade; i++)
+        {
+            uint16_t valor = codificar(base, &regs[i]);
+            saida[2 * i] = (uint8_t)(valor >> 8);
+            saida[2 * i + 1] = (uint8_t)valor;
+        }
+    } while (b->confirmar && !b->confirmar(marca));
+}
+
+static uint16_t fechar_quadro(uint8_t *resp, uint16_t tamanho)
+{
+    uint16_t crc = modbus_crc16(resp, tamanho);
+    resp[tamanho] = (uint8_t)crc;           // CRC vai com o byte baixo primeiro
+    resp[tamanho + 1] = (uint8_t)(crc >> 8);
+    return tamanho + 2;
+}
+
+static uint16_t excecao(uint8_t *resp, uint8_t codigo, modbus_contadores_t *contadores)
+{
+    contadores->excecoes++;
+    resp[1] |= 0x80;
+    resp[2] = codigo;
+    return fechar_quadro(resp, 3);
+}
+
+uint16_t modbus_processar(const modbus_mapa_t *mapa, uint8_t escravo,
+                          const uint8_t *req, uint16_t tamanho,
+                          uint8_t *resp, modbus_contadores_t *contadores)
+{
+    if (tamanho < 4 || (req[0] != escravo && req[0] != MODBUS_ENDERECO_BROADCAST))
+        return 0;
+
+    if (modbus_crc16(req, tamanho - 2) != (uint16_t)(req[tamanho - 2] | (req[tamanho - 1] << 8)))
+    {
+        contadores->erros_crc++;
+        return 0;
+    }
+
+    contadores->quadros++;
+    bool broadcast = req[0] == MODBUS_ENDERECO_BROADCAST;
+    uint8_t funcao = req[1];
+    resp[0] = escravo;
+    resp[1] = funcao;
+
+    if (tamanho < 8)
+        return broadcast ? 0 : excecao(resp, MODBUS_EXC_VALOR, contadores);
+
+    uint16_t inicio = ler_u16_be(&req[2]);
+    uint16_t n = ler_u16_be(&req[4]);
+    const modbus_bloco_t *b;
+    uint16_t tam_resp;
+
+    switch (funcao)
+    {
+    case FC_LER_HOLDING:
+    case FC_LER_ENTRADA:
+        if (broadcast)
+            return 0;
+        if (n == 0 || n > LEITURA_MAX)
+            return excecao(resp, MODBUS_EXC_VALOR, contadores);
+        b = achar_bloco(mapa, funcao == FC_LER_HOLDING, inicio, n);
+        if (!b)
+            return excecao(resp, MODBUS_EXC_ENDERECO, contadores);
+
+        resp[2] = (uint8_t)(2 * n);
+        ler_bloco(b, inicio, n, &resp[3]);
+        return fechar_quadro(resp, 3 + 2 * n);
+
+    case FC_ESCREVER_UM:
+    {
+        uint16_t valor = n;
+        b = achar_bloco(mapa, true, inicio, 1);
+        if (!b || !b->escrever)
+            return broadcast ? 0 : excecao(resp, MODBUS_EXC_ENDERECO, contadores);
+        if (!b->escrever(inicio - b->primeiro, &valor, 1))
+            return broadcast ? 0 : excecao(resp, MODBUS_EXC_VALOR, contadores);
+
+        // Resposta ecoa a requisição
+        tam_resp = 6;
+        memcpy(&resp[2], &req[2], 4);
+        break;
+    }
+
+    case FC_ESCREVER_VARIOS:
+    {
+        if (n == 0 || n > ESCRITA_MAX || tamanho != (uint16_t)(9 + 2 * n) || req[6] != 2 * n)
+            return broadcast ? 0 : excecao(resp, MODBUS_EXC_VALOR, contadores);
+        b = achar_bloco(mapa, true, inicio, n);
+        if (!b || !b->escrever)
+            return broadcast ? 0 : excecao(resp, MODBUS_EXC_ENDERECO, contadores);
+
+        uint16_t valores[ESCRITA_MAX];
+        for (uint16_t i = 0; i < n; i++)
+            valores[i] = ler_u16_be(&req[7 + 2 * i]);
+        if (!b->escrever(inicio - b->primeiro, valores, n))
+            return broadcast ? 0 : excecao(resp, MODBUS_EXC_VALOR, contadores);
+
+        tam_resp = 6;
+        memcpy(&resp[2], &req[2], 4);
+        break;
+    }
+
+    default:
+        return broadcast ? 0 : excecao(resp, MODBUS_EXC_FUNCAO, contadores);
+    }
+
+    return broadcast ? 0 : fechar_quadro(resp, tam_resp);
+}
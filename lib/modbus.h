@@ -0,0 +1,89 @@
+#ifndef MODBUS_H
+#define MODBUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ===============================
+// === MODBUS RTU (ESCRAVO) ===
+// ===============================
+// Núcleo do protocolo, independente de hardware: valida o quadro (endereço e
+// CRC16), executa as funções 03/04/06/16 e monta a resposta. O mapa de
+// registradores descreve onde cada valor vive (tipo + deslocamento sobre uma
+// base); a leitura codifica direto do dado vivo para o quadro de resposta, sem
+// cópias intermediárias. Blocos com 'abrir'/'confirmar' são lidos como um
+// seqlock: se o dado mudou durante a codificação, a leitura é refeita.
+// Para o lado mestre (lib/agregador.c) há só a montagem da requisição de
+// leitura e os tempos de quadro do barramento.
+
+#define MODBUS_QUADRO_MAX    256
+#define MODBUS_ENDERECO_BROADCAST 0
+
+// Códigos de exceção
+#define MODBUS_EXC_FUNCAO    0x01
+#define MODBUS_EXC_ENDERECO  0x02
+#define MODBUS_EXC_VALOR     0x03
+
+typedef enum
+{
+    MB_U8,          // uint8_t / bool / enum de 1 byte
+    MB_I8,
+    MB_U16,
+    MB_I16,
+    MB_U32_ALTO,    // Palavra alta de um uint32_t (ocupa o registrador seguinte com MB_U32_BAIXO)
+    MB_U32_BAIXO,
+    MB_FLOAT_DC     // float em °C exposto como int16 em décimos
+} modbus_tipo_t;
+
+typedef struct
+{
+    uint16_t deslocamento;   // Deslocamento do campo sobre a base do bloco
+    uint8_t tipo;            // modbus_tipo_t
+} modbus_reg_t;
+
+typedef struct
+{
+    uint16_t primeiro;       // Endereço do primeiro registrador do bloco
+    uint16_t quantidade;
+    bool holding;            // true: FC03/06/16 (holding); false: FC04 (entrada)
+    const modbus_reg_t *regs;
+
+    const void *base;                              // Dado vivo (NULL: usa 'abrir')
+    const void *(*abrir)(uint32_t *marca);         // Base consistente para uma leitura
+    bool (*confirmar)(uint32_t marca);             // false: mudou durante a leitura (repetir)
+
+    // Escrita de 'quantidade' registradores a partir de 'indice' (NULL: somente leitura)
+    bool (*escrever)(uint16_t indice, const uint16_t *valores, uint16_t quantidade);
+} modbus_bloco_t;
+
+typedef struct
+{
+    const modbus_bloco_t *blocos;
+    uint8_t num_blocos;
+} modbus_mapa_t;
+
+typedef struct
+{
+    uint32_t quadros;        // Quadros válidos endereçados a este escravo
+    uint32_t erros_crc;
+    uint32_t excecoes;
+} modbus_contadores_t;
+
+uint16_t modbus_crc16(const uint8_t *dados, uint16_t tamanho);
+
+// t3,5 em µs (3,5 caracteres de 11 bits, 8E1); acima de 19200 baud a norma fixa 1,75 ms
+uint32_t modbus_silencio_us(uint32_t baud);
+
+// Duração de 'bytes' caracteres de 11 bits no barramento
+uint32_t modbus_tempo_quadro_us(uint32_t baud, uint16_t bytes);
+
+// Requisição FC03 (holding) ou FC04 (entrada) com CRC; retorna o tamanho (8 bytes)
+uint16_t modbus_montar_leitura(uint8_t *quadro, uint8_t escravo, bool holding, uint16_t inicio, uint16_t quantidade);
+
+// Processa um quadro RTU completo (incluindo CRC). Retorna o tamanho da resposta
+// escrita em 'resp' (0 = sem resposta: outro endereço, CRC inválido ou broadcast).
+uint16_t modbus_processar(const modbus_mapa_t *mapa, uint8_t escravo,
+                          const uint8_t *req, uint16_t tamanho,
+                          uint8_t *resp, modbus_contadores_t *contadores);
+
+#endif // MODBUS_H
@@ -0,0 +1,290 @@
+#include "modbus_mapa.h"
+
+#include <stddef.h>
+
+#include "config.h"
+
+#define CONFIG_MAX_REGS 48
+#define FILA_ESCRITAS   64   // Potência de 2, maior que uma FC16 com todos os campos
+#define NUM_REGS(t) (uint16_t)(sizeof(t) / sizeof((t)[0]))
+
+static const status_publicado_t *status_pub;
+
+// --- Estado do sistema: lido da cópia estável do seqlock, sem copiar ---
+static const modbus_reg_t regs_status[] = {
+    {offsetof(SystemStatus, state), MB_U8},   // enum: byte baixo (little-endian)
+    {offsetof(SystemStatus, current_temp), MB_FLOAT_DC},
+    {offsetof(SystemStatus, fire_detected), MB_U8},
+    {offsetof(SystemStatus, taxa_subida), MB_I16},
+    {offsetof(SystemStatus, countdown), MB_I8},
+    {offsetof(SystemStatus, relatorio), MB_U8},
+    {offsetof(SystemStatus, canais_quentes), MB_U32_ALTO},
+    {offsetof(SystemStatus, canais_quentes), MB_U32_BAIXO},
+    {offsetof(SystemStatus, fusao_pontuacao), MB_U16},
+    {offsetof(SystemStatus, fusao_votos), MB_U8},
+};
+
+static const void *abrir_status(uint32_t *marca)
+{
+    *marca = status_leitura_inicio(status_pub);
+    return status_estavel(status_pub, *marca);
+}
+
+static bool confirmar_status(uint32_t marca)
+{
+    return status_leitura_valida(status_pub, marca);
+}
+
+// --- Histórico: resumo dos acumuladores em andamento e ocupação dos anéis ---
+// Publicado pelo laço principal em buffer duplo, como lib/status.c: a IRQ do
+// Modbus pode interromper hist_adicionar, então ler o historico_t direto
+// misturaria o mínimo de uma amostra com a contagem da seguinte.
+typedef struct
+{
+    int16_t min_minuto;
+    int16_t max_minuto;
+    uint32_t amostras_minuto;
+    int16_t min_hora;
+    int16_t max_hora;
+    uint16_t minutos;
+    uint16_t horas;
+} resumo_historico_t;
+
+static struct
+{
+    volatile uint32_t sequencia;   // Paridade indica a cópia estável para leitura
+    resumo_historico_t copias[2];
+} historico_pub;
+
+static const modbus_reg_t regs_historico[] = {
+    {offsetof(resumo_historico_t, min_minuto), MB_I16},
+    {offsetof(resumo_historico_t, max_minuto), MB_I16},
+    {offsetof(resumo_historico_t, amostras_minuto), MB_U32_ALTO},
+    {offsetof(resumo_historico_t, amostras_minuto), MB_U32_BAIXO},
+    {offsetof(resumo_historico_t, min_hora), MB_I16},
+    {offsetof(resumo_historico_t, max_hora), MB_I16},
+    {offsetof(resumo_historico_t, minutos), MB_U16},
+    {offsetof(resumo_historico_t, horas), MB_U16},
+};
+
+static const void *abrir_historico(uint32_t *marca)
+{
+    *marca = __atomic_load_n(&historico_pub.sequencia, __ATOMIC_ACQUIRE);
+    return &historico_pub.copias[*marca & 1u];
+}
+
+static bool confirmar_historico(uint32_t marca)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&historico_pub.sequencia, __ATOMIC_RELAXED) == marca;
+}
+
+void modbus_mapa_publicar_historico(const historico_t *historico)
+{
+    const hist_acumulador_t *minuto = &historico->acumuladores[HIST_MINUTO];
+    const hist_acumulador_t *hora = &historico->acumuladores[HIST_HORA];
+    resumo_historico_t r = {
+        .min_minuto = minuto->min,
+        .max_minuto = minuto->max,
+        .amostras_minuto = minuto->n,
+        .min_hora = hora->min,
+        .max_hora = hora->max,
+        .minutos = hist_quantidade(historico, HIST_MINUTO),
+        .horas = hist_quantidade(historico, HIST_HORA),
+    };
+
+    // Sequência ímpar: leitores usam copias[1] enquanto copias[0] é escrita
+    uint32_t seq = historico_pub.sequencia;
+    __atomic_store_n(&historico_pub.sequencia, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    historico_pub.copias[0] = r;
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&historico_pub.sequencia, seq + 2, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    historico_pub.copias[1] = r;
+}
+
+// --- Contadores do próprio escravo ---
+static const modbus_reg_t regs_contadores[] = {
+    {offsetof(modbus_contadores_t, quadros), MB_U32_ALTO},
+    {offsetof(modbus_contadores_t, quadros), MB_U32_BAIXO},
+    {offsetof(modbus_contadores_t, erros_crc), MB_U32_ALTO},
+    {offsetof(modbus_contadores_t, erros_crc), MB_U32_BAIXO},
+    {offsetof(modbus_contadores_t, excecoes), MB_U32_ALTO},
+    {offsetof(modbus_contadores_t, excecoes), MB_U32_BAIXO},
+};
+
+// --- Configuração: montada a partir da tabela de descritores de config_campos ---
+static modbus_reg_t regs_config[CONFIG_MAX_REGS];
+static uint8_t campo_do_reg[CONFIG_MAX_REGS];
+static uint16_t num_regs_config = 0;
+
+static const void *abrir_config(uint32_t *marca)
+{
+    (void)marca;
+    return config_atual();
+}
+
+// Escrita de um campo na fila; palavras isoladas de um campo de 32 bits são
+// combinadas com o valor em vigor só na hora de aplicar
+typedef enum
+{
+    ESCRITA_INTEIRA,
+    ESCRITA_ALTA,
+    ESCRITA_BAIXA
+} parte_escrita_t;
+
+typedef struct
+{
+    uint8_t campo;     // Índice em config_campos
+    uint8_t parte;     // parte_escrita_t
+    int32_t valor;
+} escrita_t;
+
+// Fila de um produtor (IRQ de serviço do Modbus) e um consumidor (laço principal)
+static escrita_t fila[FILA_ESCRITAS];
+static volatile uint8_t fila_inicio = 0;
+static volatile uint8_t fila_fim = 0;
+
+static int32_t combinar(const config_campo_t *campo, const escrita_t *e)
+{
+    uint32_t atual = (uint32_t)config_ler_campo(config_atual(), campo);
+    switch (e->parte)
+    {
+    case ESCRITA_ALTA:
+        return (int32_t)(((uint32_t)e->valor << 16) | (atual & 0xFFFFu));
+    case ESCRITA_BAIXA:
+        return (int32_t)((atual & 0xFFFF0000u) | (uint32_t)e->valor);
+    default:
+        return e->valor;
+    }
+}
+
+// Na IRQ de serviço do Modbus: valida a requisição inteira e só então a coloca na fila
+static bool escrever_config(uint16_t indice, const uint16_t *valores, uint16_t quantidade)
+{
+    static escrita_t novas[CONFIG_MAX_REGS];
+    uint8_t num_novas = 0;
+    uint16_t i = 0;
+    while (i < quantidade)
+    {
+        uint16_t r = indice + i;
+        escrita_t *e = &novas[num_novas++];
+        e->campo = campo_do_reg[r];
+        e->parte = ESCRITA_INTEIRA;
+        uint16_t usados = 1;
+
+        switch (regs_config[r].tipo)
+        {
+        case MB_U32_ALTO:
+            // Com as duas palavras na mesma escrita, o valor é aplicado de uma vez
+            if (i + 1 < quantidade)
+            {
+                e->valor = (int32_t)(((uint32_t)valores[i] << 16) | valores[i + 1]);
+                usados = 2;
+            }
+            else
+            {
+                e->valor = valores[i];
+                e->parte = ESCRITA_ALTA;
+            }
+            break;
+        case MB_U32_BAIXO:
+            e->valor = valores[i];
+            e->parte = ESCRITA_BAIXA;
+            break;
+        case MB_I16:
+            e->valor = (int16_t)valores[i];
+            break;
+        default:
+            e->valor = valores[i];
+            break;
+        }
+
+        const config_campo_t *campo = &config_campos[e->campo];
+        int32_t valor = combinar(campo, e);
+        if (valor < campo->min || valor > campo->max)
+            return false;
+        i += usados;
+    }
+
+    // Sem espaço para a requisição inteira: rejeitada, o SCADA repete
+    uint8_t fim = fila_fim;
+    if ((uint8_t)(FILA_ESCRITAS - (uint8_t)(fim - fila_inicio)) < num_novas)
+        return false;
+    for (uint8_t k = 0; k < num_novas; k++)
+        fila[(uint8_t)(fim + k) % FILA_ESCRITAS] = novas[k];
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    fila_fim = (uint8_t)(fim + num_novas);
+    return true;
+}
+
+static uint8_t tipo_do_campo(config_tipo_t tipo)
+{
+    switch (tipo)
+    {
+    case CAMPO_U8:
+        return MB_U8;
+    case CAMPO_I16:
+        return MB_I16;
+    case CAMPO_U16:
+        return MB_U16;
+    default:
+        return MB_U32_ALTO;
+    }
+}
+
+static void montar_regs_config(void)
+{
+    for (uint8_t c = 0; c < config_num_campos; c++)
+    {
+        const config_campo_t *campo = &config_campos[c];
+        uint8_t tipo = tipo_do_campo(campo->tipo);
+        if (num_regs_config + (tipo == MB_U32_ALTO ? 2 : 1) > CONFIG_MAX_REGS)
+            break;
+
+        regs_config[num_regs_config] = (modbus_reg_t){campo->deslocamento, tipo};
+        campo_do_reg[num_regs_config++] = c;
+        if (tipo == MB_U32_ALTO)
+        {
+            regs_config[num_regs_config] = (modbus_reg_t){campo->deslocamento, MB_U32_BAIXO};
+            campo_do_reg[num_regs_config++] = c;
+        }
+    }
+}
+
+static modbus_bloco_t blocos[4];
+static modbus_mapa_t mapa = {blocos, 4};
+
+const modbus_mapa_t *modbus_mapa_iniciar(const status_publicado_t *status,
+                                         const modbus_contadores_t *contadores)
+{
+    status_pub = status;
+    montar_regs_config();
+
+    blocos[0] = (modbus_bloco_t){.primeiro = MB_REG_STATUS, .quantidade = NUM_REGS(regs_status), .regs = regs_status,
+                                 .abrir = abrir_status, .confirmar = confirmar_status};
+    blocos[1] = (modbus_bloco_t){.primeiro = MB_REG_HISTORICO, .quantidade = NUM_REGS(regs_historico), .regs = regs_historico,
+                                 .abrir = abrir_historico, .confirmar = confirmar_historico};
+    blocos[2] = (modbus_bloco_t){.primeiro = MB_REG_CONTADORES, .quantidade = NUM_REGS(regs_contadores), .regs = regs_contadores,
+                                 .base = contadores};
+    blocos[3] = (modbus_bloco_t){.primeiro = MB_REG_CONFIG, .quantidade = num_regs_config, .holding = true, .regs = regs_config,
+                                 .abrir = abrir_config, .escrever = escrever_config};
+    return &mapa;
+}
+
+bool modbus_mapa_aplicar_escritas(void)
+{
+    bool alterada = false;
+    uint8_t fim = fila_fim;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    for (uint8_t i = fila_inicio; i != fim; i++)
+    {
+        const escrita_t *e = &fila[i % FILA_ESCRITAS];
+        const config_campo_t *campo = &config_campos[e->campo];
+        alterada |= config_definir(campo->nome, combinar(campo, e));
+    }
+    fila_inicio = fim;
+    return alterada;
+}
@@ -0,0 +1,45 @@
+#ifndef MODBUS_MAPA_H
+#define MODBUS_MAPA_H
+
+#include "modbus.h"
+#include "status.h"
+#include "historico.h"
+
+// ===============================
+// === MAPA DE REGISTRADORES MODBUS ===
+// ===============================
+// Registradores de entrada (FC04), lidos direto dos dados vivos:
+//   0   estado (0 normal, 1 atenção, 2 crítico)    100 mín. do minuto atual (décimos °C)
+//   1   temperatura (décimos de °C)                101 máx. do minuto atual
+//   2   incêndio decidido pela fusão (0/1)         102–103 amostras no minuto atual
+//   3   taxa de elevação (décimos °C/min)          104 mín. da hora atual
+//   4   contagem regressiva                        105 máx. da hora atual
+//   5   relatório emitido (0/1)                    106 minutos no histórico
+//   6–7 máscara de pontos quentes por canal        107 horas no histórico
+//   8   pontuação da fusão dos sensores de incêndio
+//   9   votos da fusão (bit i: fusao_fonte_t i)
+//   200–201 quadros válidos   202–203 erros de CRC   204–205 exceções
+// Registradores holding (FC03/06/16) a partir de 1000: os campos de config_campos
+// na mesma ordem (campos de 32 bits ocupam dois registradores, palavra alta primeiro).
+//
+// O histórico é servido de um resumo publicado pelo laço principal no mesmo
+// seqlock de buffer duplo do status, nunca dos acumuladores em andamento. As
+// escritas chegam na IRQ de serviço do Modbus: a requisição inteira é validada
+// contra as faixas de config_campos (nada é aplicado se um valor for rejeitado)
+// e entra numa fila que o laço principal aplica com modbus_mapa_aplicar_escritas().
+
+#define MB_REG_STATUS      0
+#define MB_REG_HISTORICO   100
+#define MB_REG_CONTADORES  200
+#define MB_REG_CONFIG      1000
+
+const modbus_mapa_t *modbus_mapa_iniciar(const status_publicado_t *status,
+                                         const modbus_contadores_t *contadores);
+
+// Publica o resumo do histórico lido pelo SCADA (laço principal, após hist_adicionar)
+void modbus_mapa_publicar_historico(const historico_t *historico);
+
+// Aplica as escritas do SCADA na fila (laço principal); true se a configuração mudou
+bool modbus_mapa_aplicar_escritas(void);
+
+#endif // MODBUS_MAPA_H
@@ -0,0 +1,168 @@
+#include "modbus_rtu.h"
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+static uart_inst_t *uart_mb;
+static const modbus_mapa_t *mapa_mb;
+static uint8_t escravo_mb;
+static uint32_t baud_mb;
+static uint32_t silencio_us;
+static int canal_tx;
+static uint irq_servico;                  // IRQ de software, prioridade mínima
+
+static uint8_t quadro_rx[MODBUS_QUADRO_MAX];
+static volatile uint16_t tam_rx = 0;
+static volatile bool rx_estouro = false;
+static volatile bool quadro_pronto = false;   // Quadro completo à espera da IRQ de serviço
+static volatile bool transmitindo = false;    // Resposta saindo (DMA ou registrador de deslocamento)
+static volatile uint32_t baud_pendente = 0;   // Nova velocidade, aplicada com a linha parada
+static uint8_t quadro_tx[MODBUS_QUADRO_MAX];
+static alarm_id_t alarme_silencio = 0;
+static modbus_contadores_t contadores;
+
+static void drenar_fifo(void)
+{
+    while (uart_is_readable(uart_mb))
+    {
+        uint8_t c = (uint8_t)uart_get_hw(uart_mb)->dr;
+        // Com um quadro à espera de resposta o buffer é dele: o que chegar é descartado
+        if (!quadro_pronto && tam_rx < MODBUS_QUADRO_MAX)
+            quadro_rx[tam_rx++] = c;
+        else
+            rx_estouro = true;
+    }
+}
+
+static void aplicar_baud_pendente(void)
+{
+    baud_mb = baud_pendente;
+    silencio_us = modbus_silencio_us(baud_mb);
+    uart_set_baudrate(uart_mb, baud_mb);
+    baud_pendente = 0;
+}
+
+// Fim da resposta: o último bit saiu do registrador de deslocamento. Só então
+// uma troca de velocidade pedida durante a transmissão é aplicada.
+static int64_t fim_de_transmissao(alarm_id_t id, void *dados)
+{
+    if (dma_channel_is_busy(canal_tx) || (uart_get_hw(uart_mb)->fr & UART_UARTFR_BUSY_BITS))
+        return 20;
+    if (baud_pendente)
+        aplicar_baud_pendente();
+    transmitindo = false;
+    return 0;
+}
+
+// Alarme de silêncio: o quadro terminou. O alarme de hardware é o mesmo da
+// amostragem de 1 kHz e dos prazos do debounce/concentrador, então aqui só o
+// quadro é fechado; decodificar e responder fica com a IRQ de serviço.
+static int64_t fim_de_quadro(alarm_id_t id, void *dados)
+{
+    // Bytes que chegaram abaixo do limiar da FIFO: o quadro ainda não acabou
+    if (uart_is_readable(uart_mb))
+    {
+        drenar_fifo();
+        return silencio_us;
+    }
+
+    alarme_silencio = 0;
+    if (rx_estouro || quadro_pronto || transmitindo)
+    {
+        if (!quadro_pronto)
+            tam_rx = 0;
+        rx_estouro = false;
+        return 0;
+    }
+    quadro_pronto = true;
+    irq_set_pending(irq_servico);
+    return 0;
+}
+
+// IRQ de serviço (prioridade mínima): qualquer outra interrupção a preempta.
+// Processa o quadro fechado, dispara a resposta por DMA e aplica uma troca de
+// velocidade pedida com a linha parada.
+static void servico_modbus(void)
+{
+    if (baud_pendente && !transmitindo)
+        aplicar_baud_pendente();
+    if (!quadro_pronto)
+        return;
+
+    uint16_t n = modbus_processar(mapa_mb, escravo_mb, quadro_rx, tam_rx, quadro_tx, &contadores);
+    if (n > 0)
+    {
+        transmitindo = true;
+        dma_channel_transfer_from_buffer_now(canal_tx, quadro_tx, n);
+        add_alarm_in_us(modbus_tempo_quadro_us(baud_mb, n), fim_de_transmissao, NULL, true);
+    }
+    tam_rx = 0;
+    quadro_pronto = false;
+}
+
+// Interrupção de recepção (limiar da FIFO ou timeout): reinicia a contagem do silêncio
+static void tratar_irq_uart(void)
+{
+    drenar_fifo();
+
+    if (alarme_silencio > 0)
+        cancel_alarm(alarme_silencio);
+    alarme_silencio = add_alarm_in_us(silencio_us, fim_de_quadro, NULL, true);
+}
+
+void modbus_rtu_iniciar(uart_inst_t *uart, uint pino_tx, uint pino_rx,
+                        uint8_t escravo, uint32_t baud, const modbus_mapa_t *mapa)
+{
+    uart_mb = uart;
+    mapa_mb = mapa;
+    escravo_mb = escravo;
+    baud_mb = baud;
+    silencio_us = modbus_silencio_us(baud);
+
+    uart_init(uart, baud);
+    gpio_set_function(pino_tx, GPIO_FUNC_UART);
+    gpio_set_function(pino_rx, GPIO_FUNC_UART);
+    uart_set_format(uart, 8, 1, UART_PARITY_EVEN);
+    uart_set_fifo_enabled(uart, true);
+
+    // --- Transmissão: DMA da resposta para o registrador de dados, cadenciado pela UART ---
+    canal_tx = dma_claim_unused_channel(true);
+    dma_channel_config cfg = dma_channel_get_default_config(canal_tx);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, uart_get_dreq(uart, true));
+    dma_channel_configure(canal_tx, &cfg, &uart_get_hw(uart)->dr, quadro_tx, 0, false);
+
+    // --- Processamento dos quadros fora do alarme compartilhado ---
+    irq_servico = (uint)user_irq_claim_unused(true);
+    irq_set_exclusive_handler(irq_servico, servico_modbus);
+    irq_set_priority(irq_servico, PICO_LOWEST_IRQ_PRIORITY);
+    irq_set_enabled(irq_servico, true);
+
+    // --- Recepção por interrupção ---
+    uint irq = uart == uart0 ? UART0_IRQ : UART1_IRQ;
+    irq_set_exclusive_handler(irq, tratar_irq_uart);
+    irq_set_enabled(irq, true);
+    uart_set_irq_enables(uart, true, false);
+}
+
+void modbus_rtu_configurar(uint8_t escravo, uint32_t baud)
+{
+    if (!uart_mb)
+        return;
+
+    escravo_mb = escravo;
+    if (baud == baud_mb && !baud_pendente)
+        return;
+
+    // Sem esperar a linha: a IRQ de serviço aplica já se não houver resposta
+    // saindo, senão o fim da transmissão aplica depois do último bit
+    baud_pendente = baud;
+    irq_set_pending(irq_servico);
+}
+
+const modbus_contadores_t *modbus_rtu_contadores(void)
+{
+    return &contadores;
+}
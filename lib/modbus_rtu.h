@@ -0,0 +1,29 @@
+#ifndef MODBUS_RTU_H
+#define MODBUS_RTU_H
+
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#include "modbus.h"
+
+// ===============================
+// === TRANSPORTE MODBUS RTU (UART) ===
+// ===============================
+// Recepção por interrupção da UART e fim de quadro detectado por um alarme de
+// hardware após 3,5 caracteres de silêncio. O alarme só fecha o quadro: ele é
+// decodificado numa IRQ de software de prioridade mínima, que qualquer outra
+// interrupção (amostragem de 1 kHz, debounce) preempta, e a resposta sai por
+// DMA direto para a UART. O laço de proteção nunca espera pelo mestre,
+// qualquer que seja a taxa de consulta.
+
+// Configura UART (8E1), interrupção de recepção e canal DMA de transmissão
+void modbus_rtu_iniciar(uart_inst_t *uart, uint pino_tx, uint pino_rx,
+                        uint8_t escravo, uint32_t baud, const modbus_mapa_t *mapa);
+
+// Altera endereço e velocidade em tempo de execução, sem bloquear: a nova
+// velocidade vale quando não houver resposta saindo (após o último bit)
+void modbus_rtu_configurar(uint8_t escravo, uint32_t baud);
+
+// Contadores de diagnóstico (expostos no próprio mapa de registradores)
+const modbus_contadores_t *modbus_rtu_contadores(void);
+
+#endif // MODBUS_RTU_H
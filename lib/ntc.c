@@ -0,0 +1,18 @@
+#include "ntc.h"
+#include "secao_critica.h"
+
+#define NTC_TABELA_SECAO CRITICO_DADOS("ntc_tabela")
+#include "ntc_tabela.h"     // Gerado no diretório de build
+
+int16_t CRITICO_FUNC(ntc_adc_para_dc)(uint16_t adc)
+{
+    if (adc > 4095)
+        adc = 4095;
+
+    uint16_t idx = adc >> NTC_PASSO_BITS;
+    int32_t frac = adc & ((1u << NTC_PASSO_BITS) - 1);
+    int32_t a = ntc_tabela[idx];
+    int32_t b = ntc_tabela[idx + 1];
+
+    return (int16_t)(a + (((b - a) * frac) >> NTC_PASSO_BITS));
+}
@@ -0,0 +1,15 @@
+#ifndef NTC_H
+#define NTC_H
+
+#include <stdint.h>
+
+// ===============================
+// === LINEARIZAÇÃO DO NTC ===
+// ===============================
+// Converte a leitura do ADC (0–4095) em temperatura (décimos de °C) usando a
+// tabela gerada em tempo de compilação por tools/gerar_tabela_ntc.py
+// (parâmetros NTC_* no CMakeLists.txt) com interpolação linear inteira.
+
+int16_t ntc_adc_para_dc(uint16_t adc);
+
+#endif // NTC_H
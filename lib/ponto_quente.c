@@ -0,0 +1,93 @@
+#include "ponto_quente.h"
+#include "secao_critica.h"
+
+#include <string.h>
+
+void ponto_quente_iniciar(ponto_quente_t *pq, const ponto_quente_config_t *config)
+{
+    memset(pq, 0, sizeof(*pq));
+    pq->config = *config;
+}
+
+// Seleção de Hoare: k-ésimo menor elemento, reordenando 'v' no lugar (O(n) médio)
+static int16_t CRITICO_FUNC(selecionar)(int16_t *v, uint8_t n, uint8_t k)
+{
+    int esq = 0, dir = n - 1;
+    while (esq < dir)
+    {
+        int16_t pivo = v[(esq + dir) / 2];
+        int i = esq, j = dir;
+        while (i <= j)
+        {
+            while (v[i] < pivo)
+                i++;
+            while (v[j] > pivo)
+                j--;
+            if (i <= j)
+            {
+                int16_t t = v[i];
+                v[i++] = v[j];
+                v[j--] = t;
+            }
+        }
+        if (k <= j)
+            dir = j;
+        else if (k >= i)
+            esq = i;
+        else
+            break;
+    }
+    return v[k];
+}
+
+uint32_t CRITICO_FUNC(ponto_quente_avaliar)(ponto_quente_t *pq, uint32_t agora_ms, const int16_t *temps_dc, uint8_t n)
+{
+    if (n > PONTO_QUENTE_MAX_CANAIS)
+        n = PONTO_QUENTE_MAX_CANAIS;
+    if (n < PONTO_QUENTE_MIN_CANAIS)
+    {
+        pq->acima = 0;
+        pq->confirmados = 0;
+        return 0;
+    }
+
+    // --- Referência robusta: mediana e MAD sobre uma cópia na pilha ---
+    // Cópia em laço: no máximo 32 elementos, sem chamar memcpy
+    int16_t copia[PONTO_QUENTE_MAX_CANAIS];
+    for (uint8_t i = 0; i < n; i++)
+        copia[i] = temps_dc[i];
+    int16_t mediana = selecionar(copia, n, n / 2);
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        int32_t d = (int32_t)temps_dc[i] - mediana;
+        d = d < 0 ? -d : d;
+        copia[i] = (int16_t)(d > INT16_MAX ? INT16_MAX : d);
+    }
+    int16_t mad = selecionar(copia, n, n / 2);
+
+    int32_t limite = (int32_t)mad * pq->config.fator_mad;
+    if (limite < pq->config.excesso_min_dc)
+        limite = pq->config.excesso_min_dc;
+
+    // --- Comparação de todos os canais contra o mesmo limite (sem desvios) ---
+    uint32_t acima = 0;
+    for (uint8_t i = 0; i < n; i++)
+        acima |= (uint32_t)(((int32_t)temps_dc[i] - mediana) > limite) << i;
+
+    // --- Confirmação por canal: acima do limite sem interrupção por confirmacao_ms ---
+    uint32_t confirmados = 0;
+    uint32_t novos = acima & ~pq->acima;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        if ((novos >> i) & 1u)
+            pq->acima_desde_ms[i] = agora_ms;
+        confirmados |= (uint32_t)(((acima >> i) & 1u) && agora_ms - pq->acima_desde_ms[i] >= pq->config.confirmacao_ms) << i;
+    }
+    pq->acima = acima;
+
+    pq->mediana_dc = mediana;
+    pq->mad_dc = mad;
+    pq->confirmados = confirmados;
+    return confirmados;
+}
@@ -0,0 +1,46 @@
+#ifndef PONTO_QUENTE_H
+#define PONTO_QUENTE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ===============================
+// === PONTO QUENTE ENTRE STRINGS ===
+// ===============================
+// Compara cada canal de temperatura com os demais a cada avaliação: um porta-
+// fusível ou conector com defeito fica bem acima dos vizinhos muito antes de
+// chegar ao limiar absoluto (ex: 35 °C contra 20 °C numa manhã fria). A
+// referência é a mediana dos canais e a dispersão é o desvio absoluto mediano
+// (MAD), ambos robustos ao próprio canal defeituoso. Tudo opera sobre vetores
+// contíguos de tamanho fixo, sem alocação por canal.
+
+#define PONTO_QUENTE_MAX_CANAIS 32   // Cabe em uma máscara de 32 bits
+#define PONTO_QUENTE_MIN_CANAIS 3    // Com menos canais não há vizinhos suficientes
+
+typedef struct
+{
+    int16_t excesso_min_dc;   // Excesso mínimo sobre a mediana (décimos de °C)
+    uint8_t fator_mad;        // Excesso também precisa superar fator_mad × MAD
+    uint16_t confirmacao_ms;  // Tempo contínuo acima do limite para confirmar o canal
+} ponto_quente_config_t;
+
+typedef struct
+{
+    ponto_quente_config_t config;
+    uint32_t acima_desde_ms[PONTO_QUENTE_MAX_CANAIS];
+    uint32_t acima;           // Bit i: canal i acima do limite na última avaliação
+    int16_t mediana_dc;       // Última referência calculada
+    int16_t mad_dc;
+    uint32_t confirmados;     // Bit i: canal i confirmado como ponto quente
+} ponto_quente_t;
+
+// 10 °C acima da mediana e 5 × MAD (~3,4 desvios-padrão), por 1 s. A confirmação
+// é por tempo porque o ciclo de proteção varia de 5 a 500 ms com o ritmo.
+#define PONTO_QUENTE_CONFIG_PADRAO {.excesso_min_dc = 100, .fator_mad = 5, .confirmacao_ms = 1000}
+
+void ponto_quente_iniciar(ponto_quente_t *pq, const ponto_quente_config_t *config);
+
+// Avalia 'n' canais (contíguos) e devolve a máscara dos pontos quentes confirmados
+uint32_t ponto_quente_avaliar(ponto_quente_t *pq, uint32_t agora_ms, const int16_t *temps_dc, uint8_t n);
+
+#endif // PONTO_QUENTE_H
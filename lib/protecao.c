@@ -0,0 +1,135 @@
+#include "protecao.h"
+#include "secao_critica.h"
+
+void protecao_iniciar(protecao_t *p, const protecao_config_t *config, const taxa_config_t *config_taxa,
+                     const fusao_config_t *config_fusao)
+{
+    p->config = *config;
+    taxa_iniciar(&p->taxa, config_taxa);
+    fusao_iniciar(&p->fusao, config_fusao);
+    const ponto_quente_config_t config_ponto_quente = PONTO_QUENTE_CONFIG_PADRAO;
+    ponto_quente_iniciar(&p->ponto_quente, &config_ponto_quente);
+    p->contando = false;
+    p->inicio_contagem_ms = 0;
+    p->ultimo_ciclo_ms = 0;
+    p->desligado = false;
+    p->retendo = false;
+    p->retencao_ate_ms = 0;
+}
+
+SystemState CRITICO_FUNC(protecao_avaliar)(const protecao_config_t *config, int16_t temp_dc, taxa_nivel_t nivel_taxa, bool fogo)
+{
+    if (fogo || temp_dc >= config->limiar_critico_dc || nivel_taxa == TAXA_CRITICA)
+        return SYSTEM_CRITICAL;
+    if (temp_dc >= config->limiar_atencao_dc || nivel_taxa == TAXA_ATENCAO)
+        return SYSTEM_ATTENTION;
+    return SYSTEM_NORMAL;
+}
+
+bool CRITICO_FUNC(protecao_ciclo)(protecao_t *p, SystemStatus *status, uint32_t agora_ms, int16_t temp_dc,
+                                  const protecao_sensores_t *sensores)
+{
+    taxa_nivel_t nivel_taxa = taxa_adicionar(&p->taxa, agora_ms, temp_dc);
+    int16_t taxa = taxa_atual(&p->taxa);
+
+    // Evidência de cada fonte na escala da própria proteção
+    uint8_t evidencia[FUSAO_FONTES];
+    evidencia[FUSAO_CHAMA] = sensores->chama ? 100 : 0;
+    evidencia[FUSAO_FUMACA] = fusao_evidencia(sensores->fumaca_adc, p->config.fumaca_base_adc, p->config.fumaca_alarme_adc);
+    evidencia[FUSAO_TEMPERATURA] = fusao_evidencia(temp_dc, p->config.limiar_atencao_dc, p->config.limiar_critico_dc);
+    evidencia[FUSAO_TAXA] = fusao_evidencia(taxa, 0, p->taxa.config.critica_dc_min);
+    bool fogo = fusao_avaliar(&p->fusao, agora_ms, evidencia);
+
+    status->fire_detected = fogo;
+    status->taxa_subida = taxa;
+    status->fusao_pontuacao = p->fusao.pontuacao;
+    status->fusao_votos = p->fusao.votos;
+
+    // Disparo restaurado após reset: conta como fogo até a taxa voltar a ser confiável
+    if (p->retendo && (int32_t)(agora_ms - p->retencao_ate_ms) >= 0)
+        p->retendo = false;
+    status->state = protecao_avaliar(&p->config, temp_dc, nivel_taxa, fogo || p->retendo);
+    if (p->fusao.suspeita && status->state == SYSTEM_NORMAL)
+        status->state = SYSTEM_ATTENTION;
+
+    // Contagem regressiva: travada da primeira entrada em CRÍTICO até a volta a
+    // NORMAL. Em ATENÇÃO ela pausa no dígito atual e um desligamento já feito
+    // não se repete, então CRÍTICO/ATENÇÃO alternando não disparam de novo.
+    uint32_t desde_ultimo = agora_ms - p->ultimo_ciclo_ms;
+    p->ultimo_ciclo_ms = agora_ms;
+    if (status->state == SYSTEM_NORMAL)
+    {
+        p->contando = false;
+        p->desligado = false;
+        status->countdown = 9;
+        return false;
+    }
+    if (status->state != SYSTEM_CRITICAL)
+    {
+        if (p->contando && !p->desligado)
+            p->inicio_contagem_ms += desde_ultimo;
+        return false;
+    }
+
+    if (!p->contando)
+    {
+        p->contando = true;
+        p->inicio_contagem_ms = agora_ms;
+    }
+
+    uint32_t decorrido = agora_ms - p->inicio_contagem_ms;
+    if (decorrido < PROTECAO_CONTAGEM_MS)
+    {
+        status->countdown = (int8_t)(9 - decorrido / 1000);
+        return false;
+    }
+
+    status->countdown = 0;
+    if (p->desligado)
+        return false;
+    p->desligado = true;
+    return true;
+}
+
+uint32_t CRITICO_FUNC(protecao_canais)(protecao_t *p, SystemStatus *status, uint32_t agora_ms, const int16_t *temps_dc,
+                                       uint8_t n)
+{
+    uint32_t quentes = ponto_quente_avaliar(&p->ponto_quente, agora_ms, temps_dc, n);
+    status->canais_quentes = quentes;
+    if (quentes && status->state == SYSTEM_NORMAL)
+        status->state = SYSTEM_ATTENTION;
+    return quentes;
+}
+
+void protecao_reter(const protecao_t *p, const SystemStatus *status, uint32_t agora_ms, protecao_retida_t *r)
+{
+    uint32_t decorrido = p->contando ? agora_ms - p->inicio_contagem_ms : 0;
+    if (decorrido > PROTECAO_CONTAGEM_MS)
+        decorrido = PROTECAO_CONTAGEM_MS;
+
+    r->estado = (uint8_t)status->state;
+    r->contando = p->contando;
+    r->desligado = p->desligado;
+    r->decorrido_ms = (uint16_t)decorrido;
+}
+
+void protecao_retomar(protecao_t *p, SystemStatus *status, uint32_t agora_ms, const protecao_retida_t *r)
+{
+    if (r->estado != SYSTEM_CRITICAL && !r->contando && !r->desligado)
+        return;
+
+    uint16_t decorrido = r->decorrido_ms > PROTECAO_CONTAGEM_MS ? PROTECAO_CONTAGEM_MS : r->decorrido_ms;
+    p->contando = r->contando || r->desligado;
+    p->inicio_contagem_ms = agora_ms - (r->desligado ? PROTECAO_CONTAGEM_MS : decorrido);
+    p->desligado = r->desligado;
+    p->ultimo_ciclo_ms = agora_ms;
+    status->countdown = p->desligado ? 0 : (int8_t)(9 - decorrido / 1000);
+
+    // Em ATENÇÃO volta só a trava da contagem; a avaliação decide o estado
+    if (r->estado != SYSTEM_CRITICAL)
+        return;
+
+    p->retendo = true;
+    p->retencao_ate_ms = agora_ms + PROTECAO_RETENCAO_MS;
+    status->state = SYSTEM_CRITICAL;
+}
@@ -0,0 +1,93 @@
+#ifndef PROTECAO_H
+#define PROTECAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "status.h"
+#include "taxa_subida.h"
+#include "ponto_quente.h"
+#include "fusao.h"
+
+// ===============================
+// === LÓGICA DE PROTEÇÃO ===
+// ===============================
+// Decisão independente de hardware: limiares absolutos, taxa de elevação,
+// fusão dos sensores de incêndio (lib/fusao.h) e a contagem regressiva até o
+// desligamento. Recebe o tempo
+// como parâmetro, então o mesmo código roda no firmware (relógio real) e na
+// ferramenta de replay do host (tempo simulado, mais rápido que o real).
+
+#define PROTECAO_CONTAGEM_MS 9000   // Dígitos 9 a 0, um por segundo
+
+// Após um reset em CRÍTICO o disparo é mantido até a janela da taxa encher de
+// novo; só então a avaliação completa decide se o sistema pode sair de CRÍTICO
+#define PROTECAO_RETENCAO_MS (TAXA_JANELA * TAXA_INTERVALO_MS)
+
+typedef struct
+{
+    int16_t limiar_atencao_dc;   // Décimos de °C
+    int16_t limiar_critico_dc;
+    uint16_t fumaca_base_adc;    // Sensor de fumaça em ar limpo (evidência 0 %)
+    uint16_t fumaca_alarme_adc;  // Fumaça densa (evidência 100 %)
+} protecao_config_t;
+
+// Sensores de incêndio além da temperatura, lidos a cada ciclo
+typedef struct
+{
+    bool chama;                  // Sensor de chama IR (true = chama vista)
+    uint16_t fumaca_adc;         // Sensor de fumaça (0–4095; 0 sem sensor)
+} protecao_sensores_t;
+
+typedef struct
+{
+    protecao_config_t config;
+    taxa_subida_t taxa;
+    ponto_quente_t ponto_quente;   // Comparação entre canais (config PONTO_QUENTE_CONFIG_PADRAO)
+    fusao_t fusao;
+
+    bool contando;               // Contagem iniciada em CRÍTICO (pausada em ATENÇÃO, até NORMAL)
+    uint32_t inicio_contagem_ms;
+    uint32_t ultimo_ciclo_ms;    // Para descontar da contagem o tempo em ATENÇÃO
+    bool desligado;              // Contagem chegou a zero (até voltar a NORMAL)
+
+    bool retendo;                // CRÍTICO restaurado após reset, mantido até retencao_ate_ms
+    uint32_t retencao_ate_ms;
+} protecao_t;
+
+// Mínimo para retomar o disparo após um reset (o histórico da taxa se perde)
+typedef struct
+{
+    uint8_t estado;              // SystemState no último ciclo
+    bool contando;
+    bool desligado;
+    uint16_t decorrido_ms;       // Parte da contagem regressiva já cumprida
+} protecao_retida_t;
+
+void protecao_iniciar(protecao_t *p, const protecao_config_t *config, const taxa_config_t *config_taxa,
+                     const fusao_config_t *config_fusao);
+
+// Estado a partir da temperatura, do nível de taxa e da decisão da fusão
+SystemState protecao_avaliar(const protecao_config_t *config, int16_t temp_dc, taxa_nivel_t nivel_taxa, bool fogo);
+
+// Processa uma amostra e atualiza state, fire_detected, taxa_subida, fusão e
+// countdown em 'status' (current_temp, em float, fica com quem chama: a
+// aritmética é inteira para não depender das rotinas de ponto flutuante). Uma suspeita de incêndio ainda não confirmada
+// leva NORMAL a ATENÇÃO. Retorna true no ciclo em que o desligamento ocorre.
+bool protecao_ciclo(protecao_t *p, SystemStatus *status, uint32_t agora_ms, int16_t temp_dc,
+                    const protecao_sensores_t *sensores);
+
+// Chamada após protecao_ciclo com todos os canais de temperatura: um canal muito
+// acima dos vizinhos leva NORMAL a ATENÇÃO e fica marcado em canais_quentes.
+// Com menos de PONTO_QUENTE_MIN_CANAIS canais não tem efeito.
+uint32_t protecao_canais(protecao_t *p, SystemStatus *status, uint32_t agora_ms, const int16_t *temps_dc, uint8_t n);
+
+// Copia em 'r' o estado a preservar através de um reset (após protecao_ciclo)
+void protecao_reter(const protecao_t *p, const SystemStatus *status, uint32_t agora_ms, protecao_retida_t *r);
+
+// Logo após protecao_iniciar: se o estado retido era CRÍTICO, volta a CRÍTICO
+// com a contagem de onde parou (ou já desligado) e o mantém por PROTECAO_RETENCAO_MS.
+// Em ATENÇÃO com a contagem travada, restaura só a trava.
+void protecao_retomar(protecao_t *p, SystemStatus *status, uint32_t agora_ms, const protecao_retida_t *r);
+
+#endif // PROTECAO_H
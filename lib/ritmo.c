@@ -0,0 +1,79 @@
+#include "ritmo.h"
+
+#include <string.h>
+
+#include "secao_critica.h"
+
+const char *const ritmo_nomes[RITMO_NIVEIS] = {"REPOUSO", "NORMAL", "VIGILANCIA", "ALERTA"};
+
+void ritmo_iniciar(ritmo_t *r, const ritmo_config_t *config)
+{
+    r->config = *config;
+    r->nivel = RITMO_NORMAL;
+    r->risco_ms = 0;
+    ritmo_zerar(r);
+}
+
+void ritmo_zerar(ritmo_t *r)
+{
+    r->iniciado = false;
+    memset(r->tempo_ms, 0, sizeof(r->tempo_ms));
+    memset(r->ciclos, 0, sizeof(r->ciclos));
+    memset(r->intervalo_max_ms, 0, sizeof(r->intervalo_max_ms));
+    memset(r->atrasados, 0, sizeof(r->atrasados));
+}
+
+// Nível pedido pela situação atual, sem histerese
+static ritmo_nivel_t CRITICO_FUNC(ritmo_alvo)(const ritmo_config_t *c, const SystemStatus *status, int16_t temp_dc,
+                                             const protecao_config_t *limiares)
+{
+    if (status->state != SYSTEM_NORMAL || temp_dc >= limiares->limiar_critico_dc - c->margem_dc)
+        return RITMO_ALERTA;
+    if (temp_dc >= limiares->limiar_atencao_dc - c->margem_dc || status->taxa_subida >= c->taxa_dc_min ||
+        status->fusao_votos)
+        return RITMO_VIGILANCIA;
+    return RITMO_REPOUSO;
+}
+
+ritmo_nivel_t CRITICO_FUNC(ritmo_atualizar)(ritmo_t *r, uint32_t agora_ms, const SystemStatus *status, int16_t temp_dc,
+                                           const protecao_config_t *limiares)
+{
+    // O intervalo desde o ciclo anterior foi cumprido no nível que estava em vigor
+    if (r->iniciado)
+    {
+        uint32_t intervalo = agora_ms - r->ultimo_ms;
+        r->tempo_ms[r->nivel] += intervalo;
+        if (intervalo > r->intervalo_max_ms[r->nivel])
+            r->intervalo_max_ms[r->nivel] = intervalo;
+        if (intervalo > r->config.periodo_ms[r->nivel] + 1u)
+            r->atrasados[r->nivel]++;
+    }
+    r->iniciado = true;
+    r->ultimo_ms = agora_ms;
+    r->ciclos[r->nivel]++;
+
+    ritmo_nivel_t alvo = ritmo_alvo(&r->config, status, temp_dc, limiares);
+    if (alvo >= r->nivel)
+    {
+        r->nivel = alvo;
+        r->risco_ms = agora_ms;
+    }
+    else if (agora_ms - r->risco_ms >= r->config.estavel_ms)
+    {
+        r->nivel = (ritmo_nivel_t)(r->nivel - 1);
+        r->risco_ms = agora_ms;
+    }
+    return r->nivel;
+}
+
+float ritmo_ciclos_por_s(const ritmo_t *r)
+{
+    uint64_t tempo = 0;
+    uint32_t ciclos = 0;
+    for (int n = 0; n < RITMO_NIVEIS; n++)
+    {
+        tempo += r->tempo_ms[n];
+        ciclos += r->ciclos[n];
+    }
+    return tempo ? ciclos * 1000.0f / (float)tempo : 0.0f;
+}
@@ -0,0 +1,80 @@
+#ifndef RITMO_H
+#define RITMO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "status.h"
+#include "protecao.h"
+
+// ===============================
+// === AMOSTRAGEM ADAPTATIVA AO RISCO ===
+// ===============================
+// Escolhe o período do ciclo de proteção pelo risco do momento: devagar com
+// o sistema em NORMAL e estável, mais rápido quando a temperatura se aproxima
+// dos limiares ou começa a subir. A subida de nível é imediata; a descida é
+// um nível por vez, depois de 'estavel_ms' sem risco no nível atual. Como a
+// proteção, recebe o tempo por parâmetro e roda igual no firmware e no replay.
+
+typedef enum
+{
+    RITMO_REPOUSO,      // NORMAL há mais de estavel_ms, longe dos limiares
+    RITMO_NORMAL,       // NORMAL
+    RITMO_VIGILANCIA,   // A menos de margem_dc do limiar de atenção, subindo ou com voto de incêndio
+    RITMO_ALERTA,       // ATENÇÃO/CRÍTICO ou a menos de margem_dc do limiar crítico
+    RITMO_NIVEIS
+} ritmo_nivel_t;
+
+typedef struct
+{
+    uint16_t periodo_ms[RITMO_NIVEIS];   // Período do ciclo de proteção em cada nível
+    int16_t margem_dc;                   // Antecipação em relação aos limiares
+    int16_t taxa_dc_min;                 // Taxa de elevação que já conta como risco
+    uint32_t estavel_ms;                 // Tempo sem risco para descer um nível
+} ritmo_config_t;
+
+#define RITMO_CONFIG_PADRAO {.periodo_ms = {500, 100, 20, 5}, .margem_dc = 50, .taxa_dc_min = 20, .estavel_ms = 60000}
+
+typedef struct
+{
+    ritmo_config_t config;
+    ritmo_nivel_t nivel;
+    uint32_t risco_ms;                   // Último instante com risco do nível atual (ou acima)
+
+    // Métricas desde ritmo_iniciar/ritmo_zerar
+    bool iniciado;
+    uint32_t ultimo_ms;
+    uint64_t tempo_ms[RITMO_NIVEIS];     // Tempo passado em cada nível
+    uint32_t ciclos[RITMO_NIVEIS];       // Ciclos de proteção em cada nível
+    uint32_t intervalo_max_ms[RITMO_NIVEIS];   // Maior intervalo atingido entre dois ciclos no nível
+    uint32_t atrasados[RITMO_NIVEIS];    // Intervalos acima do período configurado (+1 ms de arredondamento)
+} ritmo_t;
+
+extern const char *const ritmo_nomes[RITMO_NIVEIS];
+
+void ritmo_iniciar(ritmo_t *r, const ritmo_config_t *config);
+
+// Após protecao_ciclo/protecao_canais: contabiliza o ciclo e escolhe o nível
+// (e o período) até o próximo
+ritmo_nivel_t ritmo_atualizar(ritmo_t *r, uint32_t agora_ms, const SystemStatus *status, int16_t temp_dc,
+                              const protecao_config_t *limiares);
+
+static inline uint16_t ritmo_periodo_ms(const ritmo_t *r)
+{
+    return r->config.periodo_ms[r->nivel];
+}
+
+// Pior atraso para um degrau além do limiar aparecer na média de um intervalo
+// e ser avaliado: até dois intervalos do nível, pelo maior intervalo atingido
+// (não pelo configurado); 0 enquanto não houver intervalo medido no nível
+static inline uint32_t ritmo_pior_latencia_ms(const ritmo_t *r, ritmo_nivel_t nivel)
+{
+    return 2u * r->intervalo_max_ms[nivel];
+}
+
+// Ciclos de proteção por segundo, em média, desde o início das métricas
+float ritmo_ciclos_por_s(const ritmo_t *r);
+
+void ritmo_zerar(ritmo_t *r);
+
+#endif // RITMO_H
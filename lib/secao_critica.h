@@ -0,0 +1,25 @@
+#ifndef SECAO_CRITICA_H
+#define SECAO_CRITICA_H
+
+// ===============================
+// === CAMINHO CRÍTICO EM RAM ===
+// ===============================
+// Funções e tabelas do caminho de proteção (IRQ das entradas, conversão do NTC,
+// taxa de elevação e decisão de desligamento) marcadas com CRITICO_FUNC e
+// CRITICO_DADOS vão para as seções .time_critical.*, copiadas para a SRAM no
+// boot: uma falha de cache do XIP não atrasa mais a proteção. Essas funções
+// usam só aritmética inteira e não chamam memcpy; divisão, ponto flutuante e
+// mem* do SDK também ficam na SRAM (PICO_*_IN_RAM no CMakeLists.txt). A opção
+// CAMINHO_CRITICO_RAM do CMake (ligada por padrão) permite compilar tudo na
+// flash para comparar as latências; nas ferramentas de host não tem efeito.
+
+#if defined(CAMINHO_CRITICO_RAM) && CAMINHO_CRITICO_RAM
+#include "pico/platform.h"
+#define CRITICO_FUNC(nome) __not_in_flash_func(nome)
+#define CRITICO_DADOS(grupo) __not_in_flash(grupo)
+#else
+#define CRITICO_FUNC(nome) nome
+#define CRITICO_DADOS(grupo)
+#endif
+
+#endif // SECAO_CRITICA_H
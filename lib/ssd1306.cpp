@@ -0,0 +1,175 @@
+#include "ssd1306.hpp"
+
+#include <new>
+
+// ===============================
+// === INVÓLUCRO EM C ===
+// ===============================
+// Cada função da API em C escolhe a instanciação pelo 'modelo' gravado na
+// inicialização e chama o método correspondente; os laços de desenho rodam
+// dentro do template, com largura, altura e páginas constantes.
+
+typedef Ssd1306_128x64<Ssd1306I2c> Painel64I2c;
+typedef Ssd1306_128x64<Ssd1306Spi> Painel64Spi;
+typedef Ssd1306_128x32<Ssd1306I2c> Painel32I2c;
+typedef Ssd1306_128x32<Ssd1306Spi> Painel32Spi;
+
+enum
+{
+  MODELO_64_I2C,
+  MODELO_64_SPI,
+  MODELO_32_I2C,
+  MODELO_32_SPI,
+};
+
+static_assert(sizeof(Painel64I2c) <= sizeof(ssd1306_t::objeto) && sizeof(Painel64Spi) <= sizeof(ssd1306_t::objeto) &&
+                  sizeof(Painel32I2c) <= sizeof(ssd1306_t::objeto) && sizeof(Painel32Spi) <= sizeof(ssd1306_t::objeto),
+              "SSD1306_OBJETO_BYTES menor que o objeto do painel");
+static_assert(alignof(Painel64Spi) <= alignof(uint64_t) && alignof(Painel64I2c) <= alignof(uint64_t),
+              "alinhamento do objeto do painel");
+
+static const ssd1306_transporte_t transporte_i2c = {Ssd1306I2c::nome};
+static const ssd1306_transporte_t transporte_spi = {Ssd1306Spi::nome};
+
+template <typename Painel>
+static inline Painel &painel(ssd1306_t *ssd)
+{
+  return *std::launder(reinterpret_cast<Painel *>(ssd->objeto.bytes));
+}
+
+template <typename Funcao>
+static inline void despachar(ssd1306_t *ssd, Funcao &&f)
+{
+  switch (ssd->modelo)
+  {
+  case MODELO_64_I2C:
+    f(painel<Painel64I2c>(ssd));
+    break;
+  case MODELO_64_SPI:
+    f(painel<Painel64Spi>(ssd));
+    break;
+  case MODELO_32_I2C:
+    f(painel<Painel32I2c>(ssd));
+    break;
+  case MODELO_32_SPI:
+    f(painel<Painel32Spi>(ssd));
+    break;
+  }
+}
+
+extern "C" {
+
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c)
+{
+  Ssd1306I2c transporte(i2c, address);
+  if (height == 32)
+  {
+    new (ssd->objeto.bytes) Painel32I2c(transporte, external_vcc);
+    ssd->modelo = MODELO_32_I2C;
+  }
+  else
+  {
+    new (ssd->objeto.bytes) Painel64I2c(transporte, external_vcc);
+    ssd->modelo = MODELO_64_I2C;
+  }
+  ssd->width = WIDTH;
+  ssd->height = height == 32 ? 32 : 64;
+  ssd->transporte = &transporte_i2c;
+  (void)width;
+}
+
+void ssd1306_init_spi(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, spi_inst_t *spi, uint pino_dc, uint pino_cs)
+{
+  Ssd1306Spi transporte(spi, pino_dc, pino_cs);
+  if (height == 32)
+  {
+    new (ssd->objeto.bytes) Painel32Spi(transporte, external_vcc);
+    ssd->modelo = MODELO_32_SPI;
+  }
+  else
+  {
+    new (ssd->objeto.bytes) Painel64Spi(transporte, external_vcc);
+    ssd->modelo = MODELO_64_SPI;
+  }
+  ssd->width = WIDTH;
+  ssd->height = height == 32 ? 32 : 64;
+  ssd->transporte = &transporte_spi;
+  (void)width;
+}
+
+void ssd1306_config(ssd1306_t *ssd)
+{
+  despachar(ssd, [](auto &p) { p.config(); });
+}
+
+void ssd1306_command(ssd1306_t *ssd, uint8_t command)
+{
+  despachar(ssd, [=](auto &p) { p.command(command); });
+}
+
+void ssd1306_commands(ssd1306_t *ssd, const uint8_t *cmds, size_t n)
+{
+  despachar(ssd, [=](auto &p) { p.commands(cmds, n); });
+}
+
+void ssd1306_send_data(ssd1306_t *ssd)
+{
+  despachar(ssd, [](auto &p) { p.send_data(); });
+}
+
+void ssd1306_send_data_parcial(ssd1306_t *ssd, uint8_t x0, uint8_t x1)
+{
+  despachar(ssd, [=](auto &p) { p.send_data_parcial(x0, x1); });
+}
+
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value)
+{
+  despachar(ssd, [=](auto &p) { p.pixel(x, y, value); });
+}
+
+void ssd1306_fill(ssd1306_t *ssd, bool value)
+{
+  despachar(ssd, [=](auto &p) { p.fill(value); });
+}
+
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill)
+{
+  despachar(ssd, [=](auto &p) { p.rect(top, left, width, height, value, fill); });
+}
+
+void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value)
+{
+  despachar(ssd, [=](auto &p) { p.line(x0, y0, x1, y1, value); });
+}
+
+void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value)
+{
+  despachar(ssd, [=](auto &p) { p.hline(x0, x1, y, value); });
+}
+
+void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value)
+{
+  despachar(ssd, [=](auto &p) { p.vline(x, y0, y1, value); });
+}
+
+void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+  despachar(ssd, [=](auto &p) { p.draw_char(c, x, y); });
+}
+
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+  despachar(ssd, [=](auto &p) { p.draw_string(str, x, y); });
+}
+
+void ssd1306_draw_char_large(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+  despachar(ssd, [=](auto &p) { p.draw_char_large(c, x, y); });
+}
+
+void ssd1306_draw_string_large(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+  despachar(ssd, [=](auto &p) { p.draw_string_large(str, x, y); });
+}
+
+} // extern "C"
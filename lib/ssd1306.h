@@ -4,10 +4,18 @@
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/spi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 #define WIDTH 128
 #define HEIGHT 64
 
+// Framebuffer estático: 1 byte de controle (0x40) + uma página de 8 linhas por byte
+#define SSD1306_BUFSIZE ((HEIGHT / 8) * WIDTH + 1)
+
 typedef enum
 {
   SET_CONTRAST = 0x81,
@@ -29,20 +37,42 @@ typedef enum
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+#define SSD1306_SPI_HZ (10 * 1000 * 1000)   // Máximo do datasheet (ciclo de 100 ns)
+
+// Transporte escolhido na inicialização: I2C ou SPI (DC/CS + DMA). O envio é
+// resolvido na instanciação de Ssd1306<> (lib/ssd1306.hpp); em C fica só o nome.
 typedef struct
 {
-  uint8_t width, height, pages, address;
-  i2c_inst_t *i2c_port;
-  bool external_vcc;
-  uint8_t *ram_buffer;
-  size_t bufsize;
-  uint8_t port_buffer[2];
+  const char *nome;
+} ssd1306_transporte_t;
+
+// Espaço para o maior Ssd1306<> atendido (128x64 pela SPI): framebuffer + transporte
+#define SSD1306_OBJETO_BYTES (SSD1306_BUFSIZE + 31)
+
+// Invólucro em C: o objeto Ssd1306<largura, altura, transporte> é construído
+// dentro de 'objeto' por ssd1306_init/ssd1306_init_spi (128x64 ou 128x32)
+typedef struct ssd1306
+{
+  uint8_t width, height;
+  uint8_t modelo;                           // Instanciação em uso (interno)
+  const ssd1306_transporte_t *transporte;
+  union
+  {
+    uint64_t alinhamento;
+    uint8_t bytes[SSD1306_OBJETO_BYTES];
+  } objeto;
 } ssd1306_t;
 
+// Altura 32 seleciona o painel 128x32; qualquer outra, o 128x64 (largura sempre 128)
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+// SPI já inicializada (SCK/MOSI configurados); DC e CS são controlados pelo driver
+void ssd1306_init_spi(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, spi_inst_t *spi, uint pino_dc, uint pino_cs);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_commands(ssd1306_t *ssd, const uint8_t *cmds, size_t n);
 void ssd1306_send_data(ssd1306_t *ssd);
+// Envia só as colunas x0..x1 (endereçamento vertical: trecho contíguo do buffer)
+void ssd1306_send_data_parcial(ssd1306_t *ssd, uint8_t x0, uint8_t x1);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -54,4 +84,9 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
 void ssd1306_draw_char_large(ssd1306_t *ssd, char c, uint8_t x, uint8_t y); 
 void ssd1306_draw_string_large(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // SSD1306_H
\ No newline at end of file
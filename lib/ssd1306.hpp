@@ -0,0 +1,393 @@
+#ifndef SSD1306_HPP
+#define SSD1306_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "font.h"
+#include "hardware/dma.h"
+
+// ===============================
+// === DRIVER SSD1306 EM TEMPLATE ===
+// ===============================
+// Ssd1306<Largura, Altura, Transporte>: tamanho do framebuffer, número de
+// páginas e limites dos laços são constantes de compilação, então o
+// compilador desenrola os laços e resolve o endereçamento sem ler campos.
+// Painéis 128x64 e 128x32 convivem no mesmo firmware como tipos distintos.
+// A API em C (lib/ssd1306.h) é um invólucro fino sobre estas instanciações.
+//
+// O Transporte fornece:
+//   static constexpr const char *nome;
+//   void comandos(const uint8_t *cmds, size_t n);
+//   void dados(uint8_t *quadro, uint16_t inicio, uint16_t n);   // quadro[inicio..inicio+n), inicio >= 1
+
+#define SSD1306_MAX_CMDS 8   // Comandos agrupados em uma única transação
+
+// --- Transporte I2C: byte de controle 0x00 (comandos) ou 0x40 (dados) ---
+class Ssd1306I2c
+{
+public:
+  static constexpr const char *nome = "I2C";
+
+  Ssd1306I2c(i2c_inst_t *porta, uint8_t endereco_i2c) : porta(porta), endereco_i2c(endereco_i2c) {}
+
+  void comandos(const uint8_t *cmds, size_t n)
+  {
+    uint8_t buf[1 + SSD1306_MAX_CMDS];
+    buf[0] = 0x00;
+    memcpy(buf + 1, cmds, n);
+    i2c_write_blocking(porta, endereco_i2c, buf, n + 1, false);
+  }
+
+  void dados(uint8_t *quadro, uint16_t inicio, uint16_t n)
+  {
+    // O byte anterior ao trecho vira o controle 0x40 durante a escrita (sem cópia);
+    // no quadro inteiro é o próprio quadro[0]
+    uint8_t *p = quadro + inicio - 1;
+    uint8_t salvo = *p;
+    *p = 0x40;
+    i2c_write_blocking(porta, endereco_i2c, p, n + 1, false);
+    *p = salvo;
+  }
+
+private:
+  i2c_inst_t *porta;
+  uint8_t endereco_i2c;
+};
+
+// --- Transporte SPI: DC baixo = comando, DC alto = dados; quadro por DMA ---
+// Construir depois de spi_init (SCK/MOSI configurados); DC e CS são controlados aqui
+class Ssd1306Spi
+{
+public:
+  static constexpr const char *nome = "SPI";
+
+  Ssd1306Spi(spi_inst_t *porta, uint pino_dc, uint pino_cs)
+      : porta(porta), pino_dc((uint8_t)pino_dc), pino_cs((uint8_t)pino_cs)
+  {
+    gpio_init(pino_dc);
+    gpio_set_dir(pino_dc, GPIO_OUT);
+    gpio_init(pino_cs);
+    gpio_set_dir(pino_cs, GPIO_OUT);
+    gpio_put(pino_cs, 1);
+
+    // DMA do framebuffer para a FIFO TX, cadenciado pelo DREQ da SPI
+    canal_dma = dma_claim_unused_channel(true);
+    dma_channel_config cfg = dma_channel_get_default_config(canal_dma);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, spi_get_dreq(porta, true));
+    dma_channel_configure(canal_dma, &cfg, &spi_get_hw(porta)->dr, NULL, 0, false);
+  }
+
+  void comandos(const uint8_t *cmds, size_t n)
+  {
+    gpio_put(pino_dc, 0);
+    gpio_put(pino_cs, 0);
+    spi_write_blocking(porta, cmds, n);
+    gpio_put(pino_cs, 1);
+  }
+
+  void dados(uint8_t *quadro, uint16_t inicio, uint16_t n)
+  {
+    gpio_put(pino_dc, 1);
+    gpio_put(pino_cs, 0);
+    dma_channel_transfer_from_buffer_now(canal_dma, quadro + inicio, n);
+    dma_channel_wait_for_finish_blocking(canal_dma);
+
+    // O DMA termina ao entregar o último byte à FIFO: espera ele sair no barramento
+    while (spi_is_busy(porta))
+      tight_loop_contents();
+
+    // Descarta o que foi recebido durante a escrita e limpa o estouro da FIFO RX
+    while (spi_is_readable(porta))
+      (void)spi_get_hw(porta)->dr;
+    spi_get_hw(porta)->icr = SPI_SSPICR_RORIC_BITS;
+    gpio_put(pino_cs, 1);
+  }
+
+private:
+  spi_inst_t *porta;
+  uint8_t pino_dc, pino_cs;
+  int canal_dma;
+};
+
+template <uint8_t Largura, uint8_t Altura, typename Transporte>
+class Ssd1306
+{
+  static_assert(Largura > 0 && Largura <= 128, "SSD1306 tem no máximo 128 colunas");
+  static_assert(Altura == 32 || Altura == 64, "painéis de 32 ou 64 linhas");
+
+public:
+  static constexpr uint8_t largura = Largura;
+  static constexpr uint8_t altura = Altura;
+  static constexpr uint8_t paginas = Altura / 8;
+  static constexpr uint16_t bufsize = paginas * Largura + 1;   // 1 byte de controle (0x40) + quadro
+
+  Transporte transporte;
+  bool external_vcc;
+  uint8_t ram_buffer[bufsize];
+
+  Ssd1306(const Transporte &transporte, bool external_vcc) : transporte(transporte), external_vcc(external_vcc)
+  {
+    memset(ram_buffer, 0, bufsize);
+    ram_buffer[0] = 0x40;
+  }
+
+  void config()
+  {
+    static constexpr uint8_t cmds[] = {
+        SET_DISP | 0x00,
+        SET_MEM_ADDR, 0x01,
+        SET_DISP_START_LINE | 0x00,
+        SET_SEG_REMAP | 0x01,
+        SET_MUX_RATIO, Altura - 1,
+        SET_COM_OUT_DIR | 0x08,
+        SET_DISP_OFFSET, 0x00,
+        SET_COM_PIN_CFG, Altura == 64 ? 0x12 : 0x02,   // COM alternados só no painel de 64 linhas
+        SET_DISP_CLK_DIV, 0x80,
+        SET_PRECHARGE, 0xF1,
+        SET_VCOM_DESEL, 0x30,
+        SET_CONTRAST, 0xFF,
+        SET_ENTIRE_ON,
+        SET_NORM_INV,
+        SET_CHARGE_PUMP, 0x14,
+        SET_DISP | 0x01};
+    commands(cmds, sizeof(cmds));
+  }
+
+  void command(uint8_t command)
+  {
+    transporte.comandos(&command, 1);
+  }
+
+  void commands(const uint8_t *cmds, size_t n)
+  {
+    while (n > 0)
+    {
+      size_t bloco = n > SSD1306_MAX_CMDS ? SSD1306_MAX_CMDS : n;
+      transporte.comandos(cmds, bloco);
+      cmds += bloco;
+      n -= bloco;
+    }
+  }
+
+  void send_data()
+  {
+    // Janela de endereçamento em uma única transação, depois o quadro inteiro
+    static constexpr uint8_t janela[] = {SET_COL_ADDR, 0, Largura - 1, SET_PAGE_ADDR, 0, paginas - 1};
+    transporte.comandos(janela, sizeof(janela));
+    transporte.dados(ram_buffer, 1, bufsize - 1);
+  }
+
+  // Só as colunas x0..x1 (endereçamento vertical: trecho contíguo do buffer)
+  void send_data_parcial(uint8_t x0, uint8_t x1)
+  {
+    if (x1 >= Largura)
+      x1 = Largura - 1;
+    if (x0 > x1)
+      return;
+
+    const uint8_t janela[] = {SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, 0, paginas - 1};
+    transporte.comandos(janela, sizeof(janela));
+    transporte.dados(ram_buffer, 1 + x0 * paginas, (x1 - x0 + 1) * paginas);
+  }
+
+  void pixel(uint8_t x, uint8_t y, bool value)
+  {
+    // Endereçamento vertical: cada coluna ocupa 'paginas' bytes consecutivos
+    uint16_t index = x * paginas + (y >> 3) + 1;
+    uint8_t bit = (y & 0b111);
+    if (value)
+      ram_buffer[index] |= (1 << bit);
+    else
+      ram_buffer[index] &= ~(1 << bit);
+  }
+
+  void fill(bool value)
+  {
+    // Preenche o buffer inteiro de uma vez (o byte 0 é o prefixo de dados 0x40)
+    memset(ram_buffer + 1, value ? 0xFF : 0x00, bufsize - 1);
+  }
+
+  void rect(uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill)
+  {
+    for (uint8_t x = left; x < left + width; ++x)
+    {
+      pixel(x, top, value);
+      pixel(x, top + height - 1, value);
+    }
+    for (uint8_t y = top; y < top + height; ++y)
+    {
+      pixel(left, y, value);
+      pixel(left + width - 1, y, value);
+    }
+
+    if (fill)
+    {
+      for (uint8_t x = left + 1; x < left + width - 1; ++x)
+      {
+        for (uint8_t y = top + 1; y < top + height - 1; ++y)
+        {
+          pixel(x, y, value);
+        }
+      }
+    }
+  }
+
+  void line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value)
+  {
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+
+    int err = dx - dy;
+
+    while (true)
+    {
+      pixel(x0, y0, value); // Desenha o pixel atual
+
+      if (x0 == x1 && y0 == y1)
+        break; // Termina quando alcança o ponto final
+
+      int e2 = err * 2;
+
+      if (e2 > -dy)
+      {
+        err -= dy;
+        x0 += sx;
+      }
+
+      if (e2 < dx)
+      {
+        err += dx;
+        y0 += sy;
+      }
+    }
+  }
+
+  void hline(uint8_t x0, uint8_t x1, uint8_t y, bool value)
+  {
+    for (uint8_t x = x0; x <= x1; ++x)
+      pixel(x, y, value);
+  }
+
+  void vline(uint8_t x, uint8_t y0, uint8_t y1, bool value)
+  {
+    for (uint8_t y = y0; y <= y1; ++y)
+      pixel(x, y, value);
+  }
+
+  void draw_char(char c, uint8_t x, uint8_t y)
+  {
+    uint16_t index = 0;
+    if (c >= 'A' && c <= 'Z')
+    {
+      index = (c - 'A' + 11) * 8; // Para letras maiúsculas
+    }
+    else if (c >= '0' && c <= '9')
+    {
+      index = (c - '0' + 1) * 8; // Adiciona o deslocamento necessário
+    }
+    else if (c >= 'a' && c <= 'z')
+    {
+      index = (c - 'a' + 37) * 8;
+    }
+    else if (c >= '!' && c <= '@')
+    {
+      index = (c - '>' + 67 + 25) * 8; // Posição do símbolo '>' na fonte
+    }
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+      uint8_t line = font[index + i];
+      for (uint8_t j = 0; j < 8; ++j)
+      {
+        pixel(x + i, y + j, line & (1 << j));
+      }
+    }
+  }
+
+  void draw_string(const char *str, uint8_t x, uint8_t y)
+  {
+    while (*str)
+    {
+      draw_char(*str++, x, y);
+      x += 8;
+      if (x + 8 >= Largura)
+      {
+        x = 0;
+        y += 8;
+      }
+      if (y + 8 >= Altura)
+      {
+        break;
+      }
+    }
+  }
+
+  void draw_char_large(char c, uint8_t x, uint8_t y)
+  {
+    uint16_t index = 0;
+    if (c >= 'A' && c <= 'Z')
+    {
+      index = (c - 'A' + 11) * 8; // Para letras maiúsculas
+    }
+    else if (c >= '0' && c <= '9')
+    {
+      index = (c - '0' + 1) * 8; // Adiciona o deslocamento necessário
+    }
+    else if (c >= 'a' && c <= 'z')
+    {
+      index = (c - 'a' + 37) * 8;
+    }
+    else if (c == '>')
+    {
+      index = c - '>' + 62 * 7; // Posição do símbolo '>' na fonte
+    }
+
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+      uint8_t line = font[index + i];
+      for (uint8_t j = 0; j < 8; ++j)
+      {
+        bool pixel_on = line & (1 << j);
+        // Expande cada pixel para um bloco 2x2
+        pixel(x + (i * 2), y + (j * 2), pixel_on);
+        pixel(x + (i * 2) + 1, y + (j * 2), pixel_on);
+        pixel(x + (i * 2), y + (j * 2) + 1, pixel_on);
+        pixel(x + (i * 2) + 1, y + (j * 2) + 1, pixel_on);
+      }
+    }
+  }
+
+  void draw_string_large(const char *str, uint8_t x, uint8_t y)
+  {
+    while (*str)
+    {
+      draw_char_large(*str++, x, y);
+      x += 16; // Ajuste para caracteres ampliados (antes era 8)
+      if (x + 16 >= Largura)
+      {
+        x = 0;
+        y += 16;
+      }
+      if (y + 16 >= Altura)
+      {
+        break;
+      }
+    }
+  }
+};
+
+// Painéis atendidos pela API em C
+template <typename Transporte>
+using Ssd1306_128x64 = Ssd1306<128, 64, Transporte>;
+template <typename Transporte>
+using Ssd1306_128x32 = Ssd1306<128, 32, Transporte>;
+
+#endif // SSD1306_HPP
@@ -0,0 +1,45 @@
+#include "status.h"
+
+#include <string.h>
+
+void status_publicar(status_publicado_t *pub, const SystemStatus *novo)
+{
+    uint32_t seq = pub->sequencia;
+
+    // Sequência ímpar: leitores usam copias[1] enquanto copias[0] é escrita
+    __atomic_store_n(&pub->sequencia, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&pub->copias[0], novo, sizeof(*novo));
+
+    // Sequência par: leitores usam copias[0] enquanto copias[1] é escrita
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&pub->sequencia, seq + 2, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&pub->copias[1], novo, sizeof(*novo));
+}
+
+uint32_t status_leitura_inicio(const status_publicado_t *pub)
+{
+    return __atomic_load_n(&pub->sequencia, __ATOMIC_ACQUIRE);
+}
+
+const SystemStatus *status_estavel(const status_publicado_t *pub, uint32_t sequencia)
+{
+    return &pub->copias[sequencia & 1u];
+}
+
+bool status_leitura_valida(const status_publicado_t *pub, uint32_t sequencia)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&pub->sequencia, __ATOMIC_RELAXED) == sequencia;
+}
+
+void status_ler(const status_publicado_t *pub, SystemStatus *copia)
+{
+    uint32_t seq;
+    do
+    {
+        seq = status_leitura_inicio(pub);
+        memcpy(copia, status_estavel(pub, seq), sizeof(*copia));
+    } while (!status_leitura_valida(pub, seq));
+}
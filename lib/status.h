@@ -0,0 +1,54 @@
+#ifndef STATUS_H
+#define STATUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ===============================
+// === ESTADO DO SISTEMA PUBLICADO ===
+// ===============================
+// O laço principal é o único escritor de SystemStatus e publica cópias
+// consistentes em um seqlock de buffer duplo: enquanto uma cópia é escrita, os
+// leitores (tela, relatório, telemetria, interrupções, outro núcleo) leem a
+// outra. Nenhum lado desabilita interrupções ou usa travas, e um leitor em
+// interrupção nunca fica preso esperando o escritor que ele interrompeu.
+
+// Enum que define os estados possíveis do sistema com base na temperatura
+typedef enum
+{
+    SYSTEM_NORMAL,    // Temperatura segura (< 40°C)
+    SYSTEM_ATTENTION, // Temperatura elevada (40–59°C)
+    SYSTEM_CRITICAL   // Temperatura crítica (≥ 60°C)
+} SystemState;
+
+typedef struct
+{
+    SystemState state;       // Estado atual (NORMAL, ATENÇÃO ou CRÍTICO)
+    float current_temp;      // Temperatura atual lida pelo sensor
+    bool fire_detected;      // Incêndio decidido pela fusão dos sensores (lib/fusao.h)
+    int16_t taxa_subida;     // Taxa de elevação estimada (décimos de °C por minuto)
+    int8_t countdown;        // Contagem regressiva para desligamento (9 a 0)
+    bool relatorio;          // Relatório de evento já emitido (evita repetição)
+    uint32_t canais_quentes; // Bit i: canal i bem acima dos vizinhos (lib/ponto_quente.h)
+    uint16_t fusao_pontuacao; // Soma ponderada das evidências de incêndio
+    uint8_t fusao_votos;     // Bit i: fonte i da fusão votando (fusao_fonte_t)
+} SystemStatus;
+
+typedef struct
+{
+    volatile uint32_t sequencia;   // Paridade indica a cópia estável para leitura
+    SystemStatus copias[2];
+} status_publicado_t;
+
+// Publica um novo estado (apenas um escritor)
+void status_publicar(status_publicado_t *pub, const SystemStatus *novo);
+
+// Obtém uma cópia consistente; pode ser chamada de qualquer contexto
+void status_ler(const status_publicado_t *pub, SystemStatus *copia);
+
+// Leitura sem cópia: acessa status_estavel() entre inicio/valida e repete se falhar
+uint32_t status_leitura_inicio(const status_publicado_t *pub);
+const SystemStatus *status_estavel(const status_publicado_t *pub, uint32_t sequencia);
+bool status_leitura_valida(const status_publicado_t *pub, uint32_t sequencia);
+
+#endif // STATUS_H
@@ -0,0 +1,134 @@
+#include "taxa_subida.h"
+#include "secao_critica.h"
+
+#include <string.h>
+
+void taxa_iniciar(taxa_subida_t *det, const taxa_config_t *config)
+{
+    memset(det, 0, sizeof(*det));
+    det->config = *config;
+    det->nivel = TAXA_NORMAL;
+}
+
+// Inclinação por mínimos quadrados: (nΣty - ΣtΣy) / (nΣt² - (Σt)²).
+// Tempos relativos à amostra mais antiga para manter os somatórios em int64.
+static int16_t CRITICO_FUNC(calcular_inclinacao)(const taxa_subida_t *det)
+{
+    uint8_t n = det->total;
+    uint8_t mais_antiga = (det->cabeca + TAXA_JANELA - n) % TAXA_JANELA;
+    uint32_t t0 = det->janela_tempo_ms[mais_antiga];
+
+    int64_t soma_t = 0, soma_y = 0, soma_tt = 0, soma_ty = 0;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        uint8_t pos = (mais_antiga + i) % TAXA_JANELA;
+        int64_t t = (int64_t)(det->janela_tempo_ms[pos] - t0);
+        int64_t y = det->janela_temp[pos];
+        soma_t += t;
+        soma_y += y;
+        soma_tt += t * t;
+        soma_ty += t * y;
+    }
+
+    int64_t denominador = n * soma_tt - soma_t * soma_t;
+    if (denominador <= 0)
+        return 0;
+
+    // (décimos << FRAC) por ms  ->  décimos por minuto
+    int64_t numerador = (n * soma_ty - soma_t * soma_y) * 60000;
+    int64_t taxa = numerador / (denominador << TAXA_FRAC_BITS);
+
+    if (taxa > INT16_MAX)
+        taxa = INT16_MAX;
+    if (taxa < INT16_MIN)
+        taxa = INT16_MIN;
+    return (int16_t)taxa;
+}
+
+taxa_nivel_t CRITICO_FUNC(taxa_adicionar)(taxa_subida_t *det, uint32_t tempo_ms, int16_t temp_dc)
+{
+    // --- Filtro exponencial em ponto fixo, a passo fixo ---
+    // O ciclo de proteção varia de 5 a 500 ms com o ritmo (lib/ritmo.h): as
+    // entradas de cada passo de TAXA_FILTRO_PASSO_MS são médias e cada passo
+    // decorrido aplica alfa uma vez, então a resposta em segundos não depende do ciclo.
+    int32_t entrada = (int32_t)temp_dc << TAXA_FRAC_BITS;
+    if (!det->filtro_iniciado)
+    {
+        det->filtrada = entrada;
+        det->filtro_tempo_ms = tempo_ms;
+        det->filtro_iniciado = true;
+    }
+    else
+    {
+        det->filtro_soma += entrada;
+        det->filtro_n++;
+        uint32_t decorrido = tempo_ms - det->filtro_tempo_ms;
+        if (decorrido >= TAXA_FILTRO_PASSO_MS)
+        {
+            uint32_t passos = decorrido / TAXA_FILTRO_PASSO_MS;
+            det->filtro_tempo_ms += passos * TAXA_FILTRO_PASSO_MS;
+            if (passos > 32)
+                passos = 32;   // Depois disso o filtro já convergiu para a entrada
+            int32_t media = det->filtro_soma / det->filtro_n;
+            for (uint32_t i = 0; i < passos; i++)
+                det->filtrada += (media - det->filtrada) >> TAXA_FILTRO_SHIFT;
+            det->filtro_soma = 0;
+            det->filtro_n = 0;
+        }
+    }
+
+    // --- Janela deslizante com espaçamento mínimo entre amostras ---
+    if (det->total > 0)
+    {
+        uint8_t ultima = (det->cabeca + TAXA_JANELA - 1) % TAXA_JANELA;
+        if (tempo_ms - det->janela_tempo_ms[ultima] < TAXA_INTERVALO_MS)
+            return det->nivel;
+    }
+
+    det->janela_temp[det->cabeca] = det->filtrada;
+    det->janela_tempo_ms[det->cabeca] = tempo_ms;
+    det->cabeca = (det->cabeca + 1) % TAXA_JANELA;
+    if (det->total < TAXA_JANELA)
+        det->total++;
+
+    if (det->total < TAXA_JANELA)
+        return det->nivel;
+
+    // --- Avaliação dos limites com confirmação ---
+    det->taxa_dc_min = calcular_inclinacao(det);
+
+    if (det->taxa_dc_min >= det->config.critica_dc_min)
+    {
+        if (det->contagem_critica < UINT8_MAX)
+            det->contagem_critica++;
+    }
+    else
+    {
+        det->contagem_critica = 0;
+    }
+
+    if (det->taxa_dc_min >= det->config.atencao_dc_min)
+    {
+        if (det->contagem_atencao < UINT8_MAX)
+            det->contagem_atencao++;
+    }
+    else
+    {
+        det->contagem_atencao = 0;
+    }
+
+    // Um nível já ativo se mantém até a taxa cair abaixo da liberação
+    bool manter_critica = det->nivel == TAXA_CRITICA &&
+                          det->taxa_dc_min >= det->config.critica_dc_min - det->config.histerese_dc_min;
+    bool manter_atencao = det->nivel != TAXA_NORMAL &&
+                          det->taxa_dc_min >= det->config.atencao_dc_min - det->config.histerese_dc_min;
+
+    if (det->contagem_critica >= det->config.confirmacoes || manter_critica)
+        det->nivel = TAXA_CRITICA;
+    else if (det->contagem_atencao >= det->config.confirmacoes || manter_atencao)
+        det->nivel = TAXA_ATENCAO;
+    else
+        det->nivel = TAXA_NORMAL;
+
+    return det->nivel;
+}
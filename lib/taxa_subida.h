@@ -0,0 +1,72 @@
+#ifndef TAXA_SUBIDA_H
+#define TAXA_SUBIDA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ===============================
+// === DETECTOR DE TAXA DE ELEVAÇÃO ===
+// ===============================
+// Estima dT/dt por mínimos quadrados (ponto fixo) sobre uma janela deslizante
+// de amostras filtradas e sinaliza ATENÇÃO/CRÍTICO quando a taxa ultrapassa os
+// limites configurados, antes que os limiares absolutos (40/60 °C) sejam atingidos.
+// Um nível só é liberado quando a taxa cai 'histerese_dc_min' abaixo do limite
+// de entrada, para que uma taxa oscilando em torno dele não alterne os estados.
+// Temperaturas em décimos de grau; taxas em décimos de grau por minuto.
+
+#define TAXA_JANELA          32    // Amostras na janela de regressão
+#define TAXA_INTERVALO_MS    500   // Intervalo mínimo entre amostras da janela (~16 s de janela)
+#define TAXA_FILTRO_SHIFT    3     // Filtro exponencial: alfa = 1/8 a cada TAXA_FILTRO_PASSO_MS
+#define TAXA_FILTRO_PASSO_MS 100   // Passo fixo do filtro, independente do ciclo de proteção
+#define TAXA_FRAC_BITS       4     // Bits fracionários da temperatura filtrada
+
+typedef enum
+{
+    TAXA_NORMAL,
+    TAXA_ATENCAO,
+    TAXA_CRITICA
+} taxa_nivel_t;
+
+typedef struct
+{
+    int16_t atencao_dc_min;   // Taxa que leva a ATENÇÃO (ex: 50 = 5.0 °C/min)
+    int16_t critica_dc_min;   // Taxa que leva a CRÍTICO (ex: 100 = 10.0 °C/min)
+    int16_t histerese_dc_min; // Liberação de cada nível abaixo do limite de entrada
+    uint8_t confirmacoes;     // Avaliações consecutivas acima do limite para disparar
+} taxa_config_t;
+
+typedef struct
+{
+    taxa_config_t config;
+
+    int32_t filtrada;                   // Temperatura filtrada (décimos << TAXA_FRAC_BITS)
+    uint32_t filtro_tempo_ms;           // Início do passo do filtro em andamento
+    int32_t filtro_soma;                // Entradas do passo em andamento
+    uint16_t filtro_n;
+    bool filtro_iniciado;
+
+    int32_t janela_temp[TAXA_JANELA];   // Amostras filtradas da janela
+    uint32_t janela_tempo_ms[TAXA_JANELA];
+    uint8_t cabeca;
+    uint8_t total;
+
+    int16_t taxa_dc_min;                // Última taxa estimada
+    uint8_t contagem_atencao;
+    uint8_t contagem_critica;
+    taxa_nivel_t nivel;
+} taxa_subida_t;
+
+#define TAXA_CONFIG_PADRAO {.atencao_dc_min = 50, .critica_dc_min = 100, .histerese_dc_min = 20, .confirmacoes = 3}
+
+void taxa_iniciar(taxa_subida_t *det, const taxa_config_t *config);
+
+// Alimenta uma amostra e devolve o nível de alarme atual
+taxa_nivel_t taxa_adicionar(taxa_subida_t *det, uint32_t tempo_ms, int16_t temp_dc);
+
+// Última taxa estimada (décimos de grau por minuto); 0 enquanto a janela não enche
+static inline int16_t taxa_atual(const taxa_subida_t *det)
+{
+    return det->taxa_dc_min;
+}
+
+#endif // TAXA_SUBIDA_H
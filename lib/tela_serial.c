@@ -0,0 +1,168 @@
+#include "tela_serial.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+    uint8_t linha, coluna, largura;
+    bool valido;          // Falso até o primeiro envio e após cada redesenho
+    uint64_t chave;
+} campo_tela_t;
+
+typedef struct
+{
+    uint8_t linha, coluna;
+    const char *texto;
+} rotulo_tela_t;
+
+static campo_tela_t campos[TELA_MAX_CAMPOS];
+static uint8_t num_campos = 0;
+static rotulo_tela_t rotulos[TELA_MAX_ROTULOS];
+static uint8_t num_rotulos = 0;
+static uint8_t linhas_tela = 0;
+
+static bool redesenho_pendente = true;
+static bool redesenhando = false;
+static bool cursor_salvo = false;   // ESC 7 já enviado neste quadro
+static uint32_t bytes_total = 0;
+static uint32_t inicio_redesenho = 0;
+static uint32_t bytes_redesenho = 0;
+
+static void enviar(const char *texto, size_t n)
+{
+    fwrite(texto, 1, n, stdout);
+    bytes_total += n;
+}
+
+static void enviarf(const char *fmt, ...)
+{
+    char buf[32];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n > 0)
+        enviar(buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
+
+void tela_iniciar(uint8_t linhas)
+{
+    linhas_tela = linhas;
+    num_campos = 0;
+    num_rotulos = 0;
+    redesenho_pendente = true;
+}
+
+void tela_rotulo(uint8_t linha, uint8_t coluna, const char *texto)
+{
+    if (num_rotulos < TELA_MAX_ROTULOS)
+        rotulos[num_rotulos++] = (rotulo_tela_t){linha, coluna, texto};
+}
+
+uint8_t tela_campo(uint8_t linha, uint8_t coluna, uint8_t largura)
+{
+    if (num_campos >= TELA_MAX_CAMPOS)
+        return TELA_MAX_CAMPOS - 1;
+    if (largura >= TELA_VALOR_MAX)
+        largura = TELA_VALOR_MAX - 1;
+    campos[num_campos] = (campo_tela_t){linha, coluna, largura, false, 0};
+    return num_campos++;
+}
+
+void tela_redesenhar(void)
+{
+    redesenho_pendente = true;
+}
+
+void tela_inicio_quadro(void)
+{
+    cursor_salvo = false;
+    if (!redesenho_pendente)
+        return;
+
+    redesenho_pendente = false;
+    redesenhando = true;
+    inicio_redesenho = bytes_total;
+
+    // Sem região de rolagem, limpa tudo e escreve os rótulos
+    enviar("\033[r\033[2J", 7);
+    for (uint8_t i = 0; i < num_rotulos; i++)
+    {
+        enviarf("\033[%u;%uH", rotulos[i].linha, rotulos[i].coluna);
+        enviar(rotulos[i].texto, strlen(rotulos[i].texto));
+    }
+    for (uint8_t i = 0; i < num_campos; i++)
+        campos[i].valido = false;
+
+    // Rolagem só abaixo da tela; o cursor do log começa na primeira linha dela
+    enviarf("\033[%u;r\033[%u;1H", linhas_tela + 1, linhas_tela + 1);
+}
+
+bool tela_pendente(uint8_t campo, uint64_t chave)
+{
+    return !campos[campo].valido || campos[campo].chave != chave;
+}
+
+bool tela_valor(uint8_t campo, uint64_t chave, const char *fmt, ...)
+{
+    campo_tela_t *c = &campos[campo];
+    if (!tela_pendente(campo, chave))
+        return false;
+    c->valido = true;
+    c->chave = chave;
+
+    if (!cursor_salvo)
+    {
+        enviar("\0337", 2);
+        cursor_salvo = true;
+    }
+
+    char buf[TELA_VALOR_MAX];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    size_t tamanho = n < 0 ? 0 : (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1;
+
+    enviarf("\033[%u;%uH", c->linha, c->coluna);
+    if (c->largura == 0)
+    {
+        enviar(buf, tamanho);
+        enviar("\033[K", 3);   // Apaga o que sobrou de um valor mais longo
+    }
+    else
+    {
+        // Largura fixa: não invade o rótulo seguinte na mesma linha
+        if (tamanho > c->largura)
+            tamanho = c->largura;
+        memset(buf + tamanho, ' ', c->largura - tamanho);
+        enviar(buf, c->largura);
+    }
+    return true;
+}
+
+void tela_fim_quadro(void)
+{
+    if (cursor_salvo)
+        enviar("\0338", 2);
+    cursor_salvo = false;
+    if (redesenhando)
+    {
+        redesenhando = false;
+        bytes_redesenho = bytes_total - inicio_redesenho;
+    }
+    fflush(stdout);
+}
+
+uint32_t tela_bytes(void)
+{
+    return bytes_total;
+}
+
+uint32_t tela_bytes_redesenho(void)
+{
+    return bytes_redesenho;
+}
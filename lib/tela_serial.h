@@ -0,0 +1,49 @@
+#ifndef TELA_SERIAL_H
+#define TELA_SERIAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ===============================
+// === TELA DIFERENCIAL NA SERIAL ===
+// ===============================
+// A tela de depuração ocupa as primeiras linhas do terminal com rótulos fixos
+// e campos posicionados; abaixo dela fica uma região de rolagem (DECSTBM) para
+// relatórios, exportações e respostas do console. Cada campo guarda uma chave
+// com o valor bruto exibido: se a chave não mudou o campo não é nem formatado,
+// e se mudou só ele é reescrito no lugar (cursor salvo e restaurado com
+// ESC 7 / ESC 8). O quadro completo só é enviado no início e sob demanda.
+
+#define TELA_MAX_CAMPOS  24
+#define TELA_MAX_ROTULOS 24
+#define TELA_VALOR_MAX   96   // Texto de um campo, já formatado
+
+// 'linhas': linhas reservadas para a tela (a rolagem começa na seguinte)
+void tela_iniciar(uint8_t linhas);
+
+// Texto fixo, enviado só nos redesenhos ('texto' deve ser estático)
+void tela_rotulo(uint8_t linha, uint8_t coluna, const char *texto);
+
+// Registra um campo (linha e coluna a partir de 1) e retorna seu índice.
+// Com 'largura' 0 o valor vai até o fim da linha; senão é completado com
+// espaços ou cortado nessa largura (só para valores ASCII, como números),
+// preservando os rótulos à direita
+uint8_t tela_campo(uint8_t linha, uint8_t coluna, uint8_t largura);
+
+// Agenda o quadro completo (limpa o terminal) para o próximo tela_inicio_quadro
+void tela_redesenhar(void);
+
+void tela_inicio_quadro(void);
+
+// Verdadeiro se o campo será reescrito com esta chave (para montar valores caros só quando preciso)
+bool tela_pendente(uint8_t campo, uint64_t chave);
+
+// Reescreve o campo se 'chave' mudou desde o último envio; retorna true se enviou
+bool tela_valor(uint8_t campo, uint64_t chave, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+void tela_fim_quadro(void);
+
+uint32_t tela_bytes(void);                // Bytes enviados pela tela desde o boot
+uint32_t tela_bytes_redesenho(void);      // Tamanho do último quadro completo
+
+#endif // TELA_SERIAL_H
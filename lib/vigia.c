@@ -0,0 +1,105 @@
+#include "vigia.h"
+
+#include "hardware/watchdog.h"
+
+// Layout dos registradores de rascunho 0–3
+//   scratch[0] = VIGIA_MAGICO
+//   scratch[1] = bits de estado | decorrido_ms << 16
+//   scratch[2] = resets por watchdog
+//   scratch[3] = verificação dos três anteriores
+#define VIGIA_MAGICO 0x56494731u   // "VIG1"
+
+#define BIT_CONTANDO   (1u << 0)
+#define BIT_DESLIGADO  (1u << 1)
+#define BIT_FOGO       (1u << 2)
+#define BIT_RELATORIO  (1u << 3)
+#define DESLOC_ESTADO  4            // 2 bits: SystemState
+#define DESLOC_DECORRIDO 16         // 16 bits: decorrido_ms
+
+static vigia_reset_t motivo = VIGIA_RESET_ENERGIA;
+static uint16_t resets_watchdog = 0;
+
+// Registradores zerados (energização) ou escrita interrompida não passam
+static inline uint32_t verificacao(uint32_t s0, uint32_t s1, uint32_t s2)
+{
+    return s0 ^ ((s1 << 7) | (s1 >> 25)) ^ s2 ^ 0xA5C3F00Fu;
+}
+
+bool vigia_restaurar(vigia_estado_t *estado)
+{
+    // watchdog_enable marca o scratch[4]; watchdog_reboot não
+    if (watchdog_enable_caused_reboot())
+        motivo = VIGIA_RESET_WATCHDOG;
+    else if (watchdog_caused_reboot())
+        motivo = VIGIA_RESET_SOFTWARE;
+    else
+        motivo = VIGIA_RESET_ENERGIA;
+
+    uint32_t s0 = watchdog_hw->scratch[0];
+    uint32_t s1 = watchdog_hw->scratch[1];
+    uint32_t s2 = watchdog_hw->scratch[2];
+    uint32_t s3 = watchdog_hw->scratch[3];
+
+    if (motivo == VIGIA_RESET_ENERGIA || s0 != VIGIA_MAGICO || s3 != verificacao(s0, s1, s2))
+    {
+        resets_watchdog = motivo == VIGIA_RESET_WATCHDOG;
+        return false;
+    }
+
+    resets_watchdog = (uint16_t)s2;
+    if (motivo == VIGIA_RESET_WATCHDOG && resets_watchdog < UINT16_MAX)
+        resets_watchdog++;
+
+    estado->protecao.estado = (uint8_t)((s1 >> DESLOC_ESTADO) & 3u);
+    estado->protecao.contando = s1 & BIT_CONTANDO;
+    estado->protecao.desligado = s1 & BIT_DESLIGADO;
+    estado->protecao.decorrido_ms = (uint16_t)(s1 >> DESLOC_DECORRIDO);
+    estado->fogo = s1 & BIT_FOGO;
+    estado->relatorio = s1 & BIT_RELATORIO;
+    return true;
+}
+
+vigia_reset_t vigia_motivo_reset(void)
+{
+    return motivo;
+}
+
+const char *vigia_nome_reset(vigia_reset_t m)
+{
+    switch (m)
+    {
+    case VIGIA_RESET_WATCHDOG: return "watchdog";
+    case VIGIA_RESET_SOFTWARE: return "software";
+    default:                   return "energização";
+    }
+}
+
+uint16_t vigia_resets_watchdog(void)
+{
+    return resets_watchdog;
+}
+
+void vigia_armar(uint16_t periodo_ms)
+{
+    uint32_t timeout_ms = VIGIA_TIMEOUT_MIN_MS + VIGIA_CICLOS_TOLERADOS * (uint32_t)periodo_ms;
+    if (timeout_ms > VIGIA_TIMEOUT_MAX_MS)
+        timeout_ms = VIGIA_TIMEOUT_MAX_MS;
+    watchdog_enable(timeout_ms, true);   // Pausa com o depurador parado no breakpoint
+}
+
+void vigia_alimentar(const vigia_estado_t *estado)
+{
+    uint32_t s1 = (estado->protecao.contando ? BIT_CONTANDO : 0) |
+                  (estado->protecao.desligado ? BIT_DESLIGADO : 0) |
+                  (estado->fogo ? BIT_FOGO : 0) |
+                  (estado->relatorio ? BIT_RELATORIO : 0) |
+                  ((uint32_t)(estado->protecao.estado & 3u) << DESLOC_ESTADO) |
+                  ((uint32_t)estado->protecao.decorrido_ms << DESLOC_DECORRIDO);
+    uint32_t s2 = resets_watchdog;
+
+    watchdog_hw->scratch[0] = VIGIA_MAGICO;
+    watchdog_hw->scratch[1] = s1;
+    watchdog_hw->scratch[2] = s2;
+    watchdog_hw->scratch[3] = verificacao(VIGIA_MAGICO, s1, s2);
+    watchdog_update();
+}
@@ -0,0 +1,52 @@
+#ifndef VIGIA_H
+#define VIGIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "protecao.h"
+
+// ===============================
+// === WATCHDOG E ESTADO RETIDO ===
+// ===============================
+// O watchdog de hardware é alimentado apenas pelo ciclo de proteção: se o laço
+// travar (ex: i2c_write_blocking com o barramento do OLED preso) a placa
+// reinicia. A cada ciclo o estado do disparo é gravado nos registradores de
+// rascunho 0–3 do watchdog (4–7 são do bootrom), que sobrevivem ao reset do
+// watchdog e a watchdog_reboot, mas são zerados na energização. No boot,
+// vigia_restaurar devolve esse estado antes de qualquer interface.
+
+#define VIGIA_TIMEOUT_MIN_MS   1000   // Folga para tela de depuração, exportação e gravação da flash
+#define VIGIA_TIMEOUT_MAX_MS   8000   // Limite do contador do RP2040 (~8,3 s)
+#define VIGIA_CICLOS_TOLERADOS 3      // Períodos de amostragem sem alimentar antes do reset
+#define VIGIA_PERIODO_MAX_MS   2000   // Maior período entre ciclos de proteção coberto pelo timeout
+
+typedef enum
+{
+    VIGIA_RESET_ENERGIA,    // Energização ou pino RUN (sem estado retido)
+    VIGIA_RESET_WATCHDOG,   // Laço travado: o contador do watchdog expirou
+    VIGIA_RESET_SOFTWARE,   // watchdog_reboot ou reinício comandado
+} vigia_reset_t;
+
+typedef struct
+{
+    protecao_retida_t protecao;
+    bool fogo;          // Entrada do sensor de fogo (alternada pelo botão B)
+    bool relatorio;     // Relatório de desligamento já emitido
+} vigia_estado_t;
+
+// Primeira chamada do boot: identifica o motivo do reset e lê o estado retido.
+// Retorna true e preenche 'estado' apenas se havia um estado válido.
+bool vigia_restaurar(vigia_estado_t *estado);
+
+vigia_reset_t vigia_motivo_reset(void);
+const char *vigia_nome_reset(vigia_reset_t motivo);
+uint16_t vigia_resets_watchdog(void);   // Resets por travamento desde a energização
+
+// Arma (ou reprograma) o watchdog para o maior período entre ciclos de proteção
+void vigia_armar(uint16_t periodo_ms);
+
+// Só no ciclo de proteção: grava o estado retido e alimenta o watchdog
+void vigia_alimentar(const vigia_estado_t *estado);
+
+#endif // VIGIA_H
@@ -1,5 +1,6 @@
 #include "ws2818b.pio.h"
-#include <math.h> // Inclua a biblioteca para usar round()
+#include "hardware/dma.h"
+#include <string.h>
 // funcionamento da mztriz de led---------------------------------------------------------------------------------------------
 //  Biblioteca gerada pelo arquivo .pio durante compilação.
 
@@ -21,6 +22,15 @@ npLED_t leds[LED_COUNT];
 PIO np_pio;
 uint sm;
 
+// Envio por DMA: npWrite copia o quadro e retorna, a PIO consome os bytes sozinha.
+// Assim npWrite pode ser chamada do alarme das animações sem segurar a IRQ
+// compartilhada pelos ~0,75 ms do quadro.
+#define NP_QUADRO_US (LED_COUNT * 24 * 5 / 4 + 100) // 1,25 us por bit + 100 us de RESET
+static uint8_t np_quadro_dma[LED_COUNT * 3];
+static int np_canal_dma;
+static absolute_time_t np_livre_em; // Fim do quadro anterior (incluindo o RESET)
+_Static_assert(sizeof(leds) == sizeof(np_quadro_dma), "pixel_t com padding");
+
 /**
  * Inicializa a máquina PIO para controle da matriz de LEDs.
  */
@@ -42,6 +52,16 @@ void npInit(uint pin)
   // Inicia programa na máquina PIO obtida.
   ws2818b_program_init(np_pio, sm, offset, LED_PIN, 800000.f);
 
+  // DMA de bytes para a FIFO: a escrita de 8 bits é replicada na palavra e a PIO usa o byte baixo.
+  np_canal_dma = dma_claim_unused_channel(true);
+  dma_channel_config cfg = dma_channel_get_default_config(np_canal_dma);
+  channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+  channel_config_set_read_increment(&cfg, true);
+  channel_config_set_write_increment(&cfg, false);
+  channel_config_set_dreq(&cfg, pio_get_dreq(np_pio, sm, true));
+  dma_channel_configure(np_canal_dma, &cfg, &np_pio->txf[sm], np_quadro_dma, sizeof(np_quadro_dma), false);
+  np_livre_em = get_absolute_time();
+
   // Limpa buffer de pixels.
   for (uint i = 0; i < LED_COUNT; ++i)
   {
@@ -71,18 +91,23 @@ void npClear()
 }
 
 /**
- * Escreve os dados do buffer nos LEDs.
+ * Espera o quadro em envio (e o RESET depois dele) terminar.
+ */
+void npAguardar()
+{
+  busy_wait_until(np_livre_em);
+}
+
+/**
+ * Inicia o envio do buffer para os LEDs e retorna sem esperar.
  */
 void npWrite()
 {
-  // Escreve cada dado de 8-bits dos pixels em sequência no buffer da máquina PIO.
-  for (uint i = 0; i < LED_COUNT; ++i)
-  {
-    pio_sm_put_blocking(np_pio, sm, (int)round(leds[i].G)); // Arredondamento para inteiro
-    pio_sm_put_blocking(np_pio, sm, (int)round(leds[i].R)); // Arredondamento para inteiro
-    pio_sm_put_blocking(np_pio, sm, (int)round(leds[i].B)); // Arredondamento para inteiro
-  }
-  sleep_us(100); // Espera 100us, sinal de RESET do datasheet.
+  // Só espera em chamadas seguidas, com o quadro anterior ainda no fio
+  npAguardar();
+  memcpy(np_quadro_dma, leds, sizeof(np_quadro_dma)); // Pixels na ordem G, R, B
+  dma_channel_transfer_from_buffer_now(np_canal_dma, np_quadro_dma, sizeof(np_quadro_dma));
+  np_livre_em = make_timeout_time_us(NP_QUADRO_US);
 }
 // Modificado do github: https://github.com/BitDogLab/BitDogLab-C/tree/main/neopixel_pio
 // Função para converter a posição do matriz para uma posição do vetor.
@@ -102,7 +127,7 @@ int getIndex(int x, int y)
 
 
 
-void desenhaSprite(int matriz[5][5][3], float intensidade)
+void desenhaSprite(const uint8_t matriz[5][5][3], float intensidade)
 {
   for (int linha = 0; linha < 5; linha++)
   {
@@ -123,3 +148,21 @@ void desenhaSprite(int matriz[5][5][3], float intensidade)
     }
   }
 }
+
+// Variante inteira de desenhaSprite: brilho de 0 a 255 (sem ponto flutuante).
+void desenhaSpriteBrilho(const uint8_t matriz[5][5][3], uint8_t brilho)
+{
+  for (int linha = 0; linha < 5; linha++)
+  {
+    for (int coluna = 0; coluna < 5; coluna++)
+    {
+      int posicao = getIndex(linha, coluna);
+
+      int r = (matriz[coluna][linha][0] * brilho) / 255;
+      int g = (matriz[coluna][linha][1] * brilho) / 255;
+      int b = (matriz[coluna][linha][2] * brilho) / 255;
+
+      npSetLED(posicao, r, g, b);
+    }
+  }
+}
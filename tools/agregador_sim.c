@@ -0,0 +1,246 @@
+// Concentrador RS-485 (lib/agregador.c) contra caixas simuladas, no host.
+// O barramento é simulado por eventos com a duração real de cada quadro na
+// velocidade escolhida; cada caixa responde pelo mesmo núcleo escravo do
+// firmware (lib/modbus.c) sobre o seu SystemStatus. Caixas mudas, ruído nas
+// respostas e atraso de resposta exercitam timeouts e repetições. O resultado
+// mostra o tempo de ciclo (simulado), o custo de CPU do mestre por ciclo e
+// confere a tabela e a pior caixa com o estado real das caixas.
+//
+//   cmake -S tools -B build-host && cmake --build build-host
+//   ./build-host/agregador_sim [-n caixas] [-b baud] [-c ciclos] [--timeout ms]
+//        [--tentativas n] [--periodo ms] [--mudas 3,7] [--ruido %] [--atraso us] [-v]
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "agregador.h"
+#include "modbus.h"
+
+#define PRIMEIRO_ENDERECO 1
+#define CAIXA_QUENTE      5   // Índice da caixa que entra em CRÍTICO no meio da simulação
+
+typedef struct
+{
+    SystemStatus status;
+    modbus_bloco_t bloco;
+    modbus_mapa_t mapa;
+    modbus_contadores_t contadores;
+    bool muda;
+} caixa_sim_t;
+
+static const modbus_reg_t regs_status[AGREGADOR_REGS] = {
+    {offsetof(SystemStatus, state), MB_U8},
+    {offsetof(SystemStatus, current_temp), MB_FLOAT_DC},
+    {offsetof(SystemStatus, fire_detected), MB_U8},
+    {offsetof(SystemStatus, taxa_subida), MB_I16},
+    {offsetof(SystemStatus, countdown), MB_I8},
+    {offsetof(SystemStatus, relatorio), MB_U8},
+    {offsetof(SystemStatus, canais_quentes), MB_U32_ALTO},
+    {offsetof(SystemStatus, canais_quentes), MB_U32_BAIXO},
+    {offsetof(SystemStatus, fusao_pontuacao), MB_U16},
+    {offsetof(SystemStatus, fusao_votos), MB_U8},
+};
+
+static caixa_sim_t caixas[AGREGADOR_MAX_CAIXAS];
+static uint8_t num_caixas = 16;
+static uint32_t baud = 19200;
+static uint32_t atraso_us = 200;    // Processamento na caixa até o primeiro bit da resposta
+static int ruido_pct = 0;
+static uint32_t semente = 12345;
+
+// Barramento: uma resposta em trânsito por vez (half-duplex)
+static uint64_t agora_us;
+static bool resposta_pendente;
+static uint64_t resposta_entrega_us;
+static uint8_t resposta[MODBUS_QUADRO_MAX];
+static uint16_t resposta_tamanho;
+static double escravos_ns;          // CPU das caixas simuladas, descontada do mestre
+
+static uint32_t aleatorio(void)
+{
+    semente = semente * 1103515245u + 12345u;
+    return semente >> 16;
+}
+
+static double agora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Temperaturas distintas por caixa; a CAIXA_QUENTE aquece de 1 °C/s após 5 s
+static void atualizar_caixa(uint8_t i, uint64_t t_us)
+{
+    SystemStatus *s = &caixas[i].status;
+    float temp = 25.0f + i * 0.5f;
+    if (i == CAIXA_QUENTE && t_us > 5000000u)
+        temp += (float)(t_us - 5000000u) / 1e6f;
+    s->current_temp = temp;
+    s->state = temp >= 60.0f ? SYSTEM_CRITICAL : temp >= 40.0f ? SYSTEM_ATTENTION : SYSTEM_NORMAL;
+    s->taxa_subida = i == CAIXA_QUENTE && t_us > 5000000u ? 600 : 0;
+    s->countdown = 9;
+}
+
+// Transporte do mestre: a caixa endereçada vê o quadro após o silêncio e responde
+static void enviar(const uint8_t *quadro, uint16_t tamanho, void *contexto)
+{
+    (void)contexto;
+    uint64_t fim_tx = agora_us + modbus_tempo_quadro_us(baud, tamanho);
+    uint8_t i = (uint8_t)(quadro[0] - PRIMEIRO_ENDERECO);
+    if (i >= num_caixas || caixas[i].muda)
+        return;
+
+    double inicio = agora_ns();
+    uint64_t fim_quadro = fim_tx + modbus_silencio_us(baud);
+    atualizar_caixa(i, fim_quadro);
+    caixa_sim_t *c = &caixas[i];
+    uint16_t n = modbus_processar(&c->mapa, quadro[0], quadro, tamanho, resposta, &c->contadores);
+    escravos_ns += agora_ns() - inicio;
+    if (n == 0)
+        return;
+    if (ruido_pct && (int)(aleatorio() % 100) < ruido_pct)
+        resposta[3 + aleatorio() % (n - 5)] ^= 0x10;
+
+    // Resposta do tamanho esperado é entregue no último byte; outras, após t3,5
+    uint64_t fim_resposta = fim_quadro + atraso_us + modbus_tempo_quadro_us(baud, n);
+    resposta_entrega_us = fim_resposta + (n == AGREGADOR_RESPOSTA_BYTES ? 0 : modbus_silencio_us(baud));
+    resposta_tamanho = n;
+    resposta_pendente = true;
+}
+
+static void ler_mudas(const char *lista)
+{
+    while (*lista)
+    {
+        char *fim;
+        long i = strtol(lista, &fim, 10);
+        if (fim == lista)
+            break;
+        if (i >= 0 && i < AGREGADOR_MAX_CAIXAS)
+            caixas[i].muda = true;
+        lista = *fim == ',' ? fim + 1 : fim;
+    }
+}
+
+static void uso(const char *prog)
+{
+    fprintf(stderr,
+            "uso: %s [-n caixas] [-b baud] [-c ciclos] [--timeout ms] [--tentativas n]\n"
+            "          [--periodo ms] [--mudas i,j,...] [--ruido %%] [--atraso us] [-v]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    agregador_config_t config = {.baud = 0, .timeout_ms = 50, .tentativas = 3, .periodo_ms = 0};
+    uint32_t ciclos = 100;
+    bool detalhado = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *op = argv[i];
+        if (strcmp(op, "-v") == 0)
+        {
+            detalhado = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            uso(argv[0]);
+        const char *valor = argv[++i];
+        if (strcmp(op, "-n") == 0)
+            num_caixas = (uint8_t)atoi(valor);
+        else if (strcmp(op, "-b") == 0)
+            baud = (uint32_t)atol(valor);
+        else if (strcmp(op, "-c") == 0)
+            ciclos = (uint32_t)atol(valor);
+        else if (strcmp(op, "--timeout") == 0)
+            config.timeout_ms = (uint16_t)atoi(valor);
+        else if (strcmp(op, "--tentativas") == 0)
+            config.tentativas = (uint8_t)atoi(valor);
+        else if (strcmp(op, "--periodo") == 0)
+            config.periodo_ms = (uint16_t)atoi(valor);
+        else if (strcmp(op, "--mudas") == 0)
+            ler_mudas(valor);
+        else if (strcmp(op, "--ruido") == 0)
+            ruido_pct = atoi(valor);
+        else if (strcmp(op, "--atraso") == 0)
+            atraso_us = (uint32_t)atol(valor);
+        else
+            uso(argv[0]);
+    }
+    if (num_caixas == 0 || num_caixas > AGREGADOR_MAX_CAIXAS || baud == 0)
+        uso(argv[0]);
+    config.baud = baud;
+
+    for (uint8_t i = 0; i < num_caixas; i++)
+    {
+        caixa_sim_t *c = &caixas[i];
+        c->bloco = (modbus_bloco_t){.primeiro = 0, .quantidade = AGREGADOR_REGS, .regs = regs_status, .base = &c->status};
+        c->mapa = (modbus_mapa_t){&c->bloco, 1};
+        atualizar_caixa(i, 0);
+    }
+
+    static agregador_t a;
+    agregador_iniciar(&a, &config, PRIMEIRO_ENDERECO, num_caixas, enviar, NULL, 0);
+
+    // Eventos em ordem de tempo: entrega da resposta ou próximo prazo do mestre
+    double cpu_ns = 0;
+    uint64_t prazo = 0;
+    while (a.estatisticas.ciclos < ciclos)
+    {
+        double inicio = agora_ns();
+        if (resposta_pendente && resposta_entrega_us <= prazo)
+        {
+            agora_us = resposta_entrega_us;
+            resposta_pendente = false;
+            prazo = agregador_receber(&a, resposta, resposta_tamanho, agora_us);
+        }
+        else
+        {
+            agora_us = prazo;
+            prazo = agregador_processar(&a, agora_us);
+        }
+        cpu_ns += agora_ns() - inicio;
+    }
+
+    const agregador_estatisticas_t *e = &a.estatisticas;
+    uint32_t por_caixa_us = modbus_tempo_quadro_us(baud, 8) + atraso_us +
+                            modbus_tempo_quadro_us(baud, AGREGADOR_RESPOSTA_BYTES) + 2 * modbus_silencio_us(baud);
+    printf("%u caixas a %lu baud, %lu ciclos em %.1f s simulados\n", num_caixas, (unsigned long)baud,
+           (unsigned long)e->ciclos, agora_us / 1e6);
+    printf("  ciclo: último %.1f ms, mín %.1f ms, médio %.1f ms, máx %.1f ms (ideal %.1f ms = %.2f ms/caixa)\n",
+           e->ciclo_us / 1000.0, e->ciclo_min_us / 1000.0, e->ciclo_soma_us / 1000.0 / e->ciclos,
+           e->ciclo_max_us / 1000.0, num_caixas * por_caixa_us / 1000.0, por_caixa_us / 1000.0);
+    printf("  requisições %lu, respostas %lu, timeouts %lu, erros %lu\n", (unsigned long)e->requisicoes,
+           (unsigned long)e->respostas, (unsigned long)e->timeouts, (unsigned long)e->erros);
+    printf("  CPU do mestre no host: %.0f ns por ciclo\n", (cpu_ns - escravos_ns) / e->ciclos);
+
+    // Confere a tabela com o estado real das caixas no instante da última resposta
+    int divergencias = 0;
+    for (uint8_t i = 0; i < num_caixas; i++)
+    {
+        const agregador_caixa_t *c = &a.caixas[i];
+        atualizar_caixa(i, (uint64_t)c->resposta_ms * 1000u);
+        int16_t esperado_dc = (int16_t)(caixas[i].status.current_temp * 10.0f + 0.5f);
+        bool ok = caixas[i].muda ? agregador_sem_resposta(c) && c->estado == AGREGADOR_SEM_DADOS
+                                 : c->falhas == 0 && c->estado == caixas[i].status.state &&
+                                       abs(c->temp_dc - esperado_dc) <= 1;
+        if (!ok)
+            divergencias++;
+        if (detalhado || !ok)
+            printf("  caixa %3u: estado %3u  %5.1f °C  taxa %5.1f  falhas %3u  resposta %lu ms%s\n", c->escravo,
+                   c->estado, c->temp_dc / 10.0, c->taxa_dc_min / 10.0, c->falhas, (unsigned long)c->resposta_ms,
+                   ok ? "" : "  <-- DIVERGE");
+    }
+
+    const agregador_caixa_t *pior = agregador_pior(&a);
+    printf("  pior caixa: %u (gravidade %u, %.1f °C)\n", pior->escravo, agregador_gravidade(pior),
+           pior->temp_dc / 10.0);
+    if (divergencias)
+        printf("ERRO: %d caixa(s) com a tabela divergente\n", divergencias);
+    return divergencias ? 1 : 0;
+}
@@ -0,0 +1,303 @@
+// Codificação do histórico compacto (lib/hist_compacto.c) no host: bytes por
+// amostra, vazão de codificação/decodificação e blocos pulados nas consultas.
+// A série sintética tem uma média por minuto com ciclo diário (16–40 °C na
+// caixa ao sol), ruído, reinícios que deixam lacunas e um evento de 75 °C.
+// A flash é simulada em RAM com a semântica da NOR (apagar = 0xFF, gravar só
+// zera bits). A ferramenta confere que o apagamento antecipado
+// (compacto_preparar) deixa as gravações de bloco sem apagar setores, que tudo
+// o que ficou na região volta igual, que o resumo pelos cabeçalhos bate com a
+// força bruta e que a reabertura continua do ponto certo.
+//
+//   cmake -S tools -B build-host && cmake --build build-host
+//   ./build-host/bench_hist_compacto [--dias 28] [--ruido 3] [--regiao 128]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hist_compacto.h"
+
+typedef struct
+{
+    uint32_t minuto;
+    int16_t temp_dc;
+} amostra_t;
+
+static uint8_t *flash;
+static uint32_t semente = 12345;
+
+static uint32_t aleatorio(void)
+{
+    semente = semente * 1103515245u + 12345u;
+    return semente >> 16;
+}
+
+static double agora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void apagar(uint32_t deslocamento, void *contexto)
+{
+    (void)contexto;
+    memset(flash + deslocamento, 0xFF, COMPACTO_SETOR_BYTES);
+}
+
+static void gravar(uint32_t deslocamento, const uint8_t *pagina, void *contexto)
+{
+    (void)contexto;
+    for (uint32_t i = 0; i < COMPACTO_PAGINA_BYTES; i++)
+        flash[deslocamento + i] &= pagina[i];
+}
+
+static uint32_t gerar(amostra_t *serie, uint32_t dias, int ruido_dc)
+{
+    uint32_t n = 0, minuto = 0;
+    uint32_t evento = dias * 1440u * 2 / 3;
+    for (uint32_t m = 0; m < dias * 1440u; m++)
+    {
+        // Reinício a cada ~5 dias: 30 minutos sem amostras
+        if (m % 7200 == 7199)
+        {
+            minuto += 30;
+            continue;
+        }
+        double hora = (m % 1440) / 60.0;
+        double temp = 28.0 + 12.0 * sin((hora - 9.0) * M_PI / 12.0) + 2.0 * sin(m / 1440.0);
+        if (m >= evento && m < evento + 40)
+            temp += (m - evento < 20 ? m - evento : 40 - (m - evento)) * 2.5;
+        serie[n].minuto = minuto++;
+        serie[n].temp_dc = (int16_t)lround(temp * 10.0) + (int16_t)((int)(aleatorio() % (2 * ruido_dc + 1)) - ruido_dc);
+        n++;
+    }
+    return n;
+}
+
+static uint32_t tamanho_varint(uint32_t v)
+{
+    uint32_t n = 1;
+    while (v >= 0x80)
+    {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static uint32_t zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+typedef struct
+{
+    const amostra_t *esperado;
+    uint32_t n;
+    uint32_t divergencias;
+} conferencia_t;
+
+static bool conferir(uint32_t minuto, int16_t temp_dc, void *contexto)
+{
+    conferencia_t *c = contexto;
+    const amostra_t *e = &c->esperado[c->n++];
+    if (e->minuto != minuto || e->temp_dc != temp_dc)
+        c->divergencias++;
+    return true;
+}
+
+static bool contar(uint32_t minuto, int16_t temp_dc, void *contexto)
+{
+    (void)minuto;
+    (void)temp_dc;
+    (*(uint32_t *)contexto)++;
+    return true;
+}
+
+// Primeira amostra da série com minuto >= 'minuto'
+static uint32_t buscar(const amostra_t *serie, uint32_t n, uint32_t minuto)
+{
+    uint32_t i = 0;
+    while (i < n && serie[i].minuto < minuto)
+        i++;
+    return i;
+}
+
+static void uso(const char *prog)
+{
+    fprintf(stderr, "uso: %s [--dias n] [--ruido dc] [--regiao KB]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t dias = 28, regiao_kb = 128;
+    int ruido_dc = 3;
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 >= argc)
+            uso(argv[0]);
+        const char *op = argv[i];
+        long valor = atol(argv[++i]);
+        if (strcmp(op, "--dias") == 0)
+            dias = (uint32_t)valor;
+        else if (strcmp(op, "--ruido") == 0)
+            ruido_dc = (int)valor;
+        else if (strcmp(op, "--regiao") == 0)
+            regiao_kb = (uint32_t)valor;
+        else
+            uso(argv[0]);
+    }
+    if (dias == 0 || ruido_dc < 0 || regiao_kb < 8 || regiao_kb % 4 != 0)
+        uso(argv[0]);
+
+    amostra_t *serie = malloc(dias * 1440u * sizeof(amostra_t));
+    uint32_t n = gerar(serie, dias, ruido_dc);
+    uint32_t tamanho = regiao_kb * 1024u;
+    flash = malloc(tamanho);
+    memset(flash, 0xFF, tamanho);
+    compacto_regiao_t regiao = {flash, tamanho, apagar, gravar, NULL};
+
+    // --- Codificação ---
+    static compacto_t hc;
+    compacto_abrir(&hc, &regiao);
+    double inicio = agora_ns();
+    for (uint32_t i = 0; i < n; i++)
+        compacto_adicionar(&hc, serie[i].minuto, serie[i].temp_dc);
+    double ns_codificar = (agora_ns() - inicio) / n;
+    compacto_descarregar(&hc);
+
+    // --- Apagamento antecipado (firmware: só em NORMAL): uma preparação por hora basta ---
+    static compacto_t preparado;
+    memset(flash, 0xFF, tamanho);
+    compacto_abrir(&preparado, &regiao);
+    uint32_t apagados_na_gravacao = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (i % 60 == 0)
+            compacto_preparar(&preparado);
+        uint32_t antes = preparado.setores_apagados;
+        compacto_adicionar(&preparado, serie[i].minuto, serie[i].temp_dc);
+        apagados_na_gravacao += preparado.setores_apagados - antes;
+    }
+
+    // As conferências abaixo usam a região gravada sem preparação (anel completo)
+    memset(flash, 0xFF, tamanho);
+    compacto_abrir(&hc, &regiao);
+    for (uint32_t i = 0; i < n; i++)
+        compacto_adicionar(&hc, serie[i].minuto, serie[i].temp_dc);
+    compacto_descarregar(&hc);
+
+    // Comparação: a mesma série só com diferenças (o que é gravado) e com delta-de-delta
+    uint64_t bytes_delta = 0, bytes_dd = 0;
+    for (uint32_t i = 1; i < n; i++)
+    {
+        int32_t d = serie[i].temp_dc - serie[i - 1].temp_dc;
+        int32_t dd = i > 1 ? d - (serie[i - 1].temp_dc - serie[i - 2].temp_dc) : d;
+        uint32_t lacuna = serie[i].minuto - serie[i - 1].minuto > 1;
+        bytes_delta += tamanho_varint(zigzag(d) << 1 | lacuna);
+        bytes_dd += tamanho_varint(zigzag(dd) << 1 | lacuna);
+    }
+
+    compacto_ocupacao_t o;
+    compacto_ocupacao(&hc, &o);
+    double b_amostra = (double)hc.blocos_gravados * COMPACTO_BLOCO_BYTES / n;
+    printf("%lu amostras de 1 min (%u dias, ruído ±%d décimos) em região de %lu KB\n", (unsigned long)n, dias,
+           ruido_dc, (unsigned long)regiao_kb);
+    printf("  bytes/amostra: float %.2f | int16 %.2f | diferenças %.2f | delta-de-delta %.2f | blocos na flash %.2f\n",
+           4.0, 2.0, (double)bytes_delta / (n - 1), (double)bytes_dd / (n - 1), b_amostra);
+    printf("  %lu blocos gravados, %lu setores apagados; na região: %lu blocos, %lu amostras (%.1f dias)\n",
+           (unsigned long)hc.blocos_gravados, (unsigned long)hc.setores_apagados, (unsigned long)o.blocos,
+           (unsigned long)o.amostras, o.amostras / 1440.0);
+    printf("  capacidade da região: %.1f semanas de médias por minuto\n",
+           (tamanho - COMPACTO_SETOR_BYTES) / b_amostra / (7 * 1440.0));
+    printf("  codificação: %.1f ns/amostra (%.1f M amostras/s)\n", ns_codificar, 1e3 / ns_codificar);
+    printf("  preparação antecipada: %lu setores apagados, %lu durante uma gravação de bloco\n",
+           (unsigned long)preparado.setores_apagados, (unsigned long)apagados_na_gravacao);
+
+    int falhas = 0;
+    if (apagados_na_gravacao)
+    {
+        printf("ERRO: a preparação antecipada não evitou apagar setores na gravação\n");
+        falhas++;
+    }
+
+    // --- Decodificação de tudo o que ficou na região (as amostras mais recentes) ---
+    uint32_t retidas = o.amostras;
+    conferencia_t conf = {&serie[n - retidas], 0, 0};
+    compacto_consulta_t tudo = {0, UINT32_MAX, INT16_MIN};
+    compacto_varredura_t v;
+    inicio = agora_ns();
+    compacto_varrer(&hc, &tudo, conferir, &conf, &v);
+    double ns_decodificar = (agora_ns() - inicio) / (conf.n ? conf.n : 1);
+    printf("  decodificação: %.1f ns/amostra (%.1f M amostras/s), %lu blocos\n", ns_decodificar,
+           1e3 / ns_decodificar, (unsigned long)v.blocos_lidos);
+    if (conf.n != retidas || conf.divergencias)
+    {
+        printf("ERRO: %lu de %lu amostras lidas, %lu divergentes\n", (unsigned long)conf.n, (unsigned long)retidas,
+               (unsigned long)conf.divergencias);
+        falhas++;
+    }
+
+    // --- Consulta de um dia no meio do que ficou: blocos fora do intervalo são pulados ---
+    const amostra_t *retida = &serie[n - retidas];
+    uint32_t meio = retida[retidas / 2].minuto;
+    compacto_consulta_t dia = {meio, meio + 1439, INT16_MIN};
+    uint32_t i_dia = buscar(serie, n, dia.de);
+    conf = (conferencia_t){&serie[i_dia], 0, 0};
+    inicio = agora_ns();
+    compacto_varrer(&hc, &dia, conferir, &conf, &v);
+    printf("  1 dia: %lu amostras, %lu blocos lidos, %lu pulados, %.1f µs\n", (unsigned long)conf.n,
+           (unsigned long)v.blocos_lidos, (unsigned long)v.blocos_pulados, (agora_ns() - inicio) / 1e3);
+    if (conf.divergencias || conf.n != buscar(serie, n, dia.ate + 1) - i_dia)
+        falhas++;
+
+    // --- Minutos acima de 60 °C: só os blocos com máximo acima são decodificados ---
+    compacto_consulta_t quente = {0, UINT32_MAX, 600};
+    uint32_t acima = 0, esperado = 0;
+    for (uint32_t i = 0; i < retidas; i++)
+        esperado += retida[i].temp_dc >= 600;
+    inicio = agora_ns();
+    compacto_varrer(&hc, &quente, contar, &acima, &v);
+    printf("  >= 60 °C: %lu minutos, %lu blocos lidos, %lu pulados, %.1f µs\n", (unsigned long)acima,
+           (unsigned long)v.blocos_lidos, (unsigned long)v.blocos_pulados, (agora_ns() - inicio) / 1e3);
+    if (acima != esperado)
+        falhas++;
+
+    // --- Resumo de 7 dias pelos cabeçalhos, conferido com a força bruta ---
+    uint32_t de = retida[retidas / 4].minuto, ate = de + 7 * 1440 - 1;
+    int16_t min, max, min_bruto = INT16_MAX, max_bruto = INT16_MIN;
+    for (uint32_t i = 0; i < retidas; i++)
+        if (retida[i].minuto >= de && retida[i].minuto <= ate)
+        {
+            if (retida[i].temp_dc < min_bruto)
+                min_bruto = retida[i].temp_dc;
+            if (retida[i].temp_dc > max_bruto)
+                max_bruto = retida[i].temp_dc;
+        }
+    inicio = agora_ns();
+    bool achou = compacto_resumo(&hc, de, ate, &min, &max, &v);
+    printf("  resumo de 7 dias: %.1f/%.1f °C, %lu blocos lidos, %lu pelo cabeçalho, %.1f µs\n", min / 10.0,
+           max / 10.0, (unsigned long)v.blocos_lidos, (unsigned long)v.blocos_pulados, (agora_ns() - inicio) / 1e3);
+    if (min_bruto <= max_bruto && (!achou || min != min_bruto || max != max_bruto))
+        falhas++;
+
+    // --- Reabertura (boot): continua após o último minuto gravado ---
+    static compacto_t reaberto;
+    compacto_abrir(&reaberto, &regiao);
+    if (reaberto.ultimo_minuto != serie[n - 1].minuto || reaberto.proximo != hc.proximo)
+    {
+        printf("ERRO: reabertura em %lu/%lu, esperado %lu/%lu\n", (unsigned long)reaberto.ultimo_minuto,
+               (unsigned long)reaberto.proximo, (unsigned long)serie[n - 1].minuto, (unsigned long)hc.proximo);
+        falhas++;
+    }
+
+    if (falhas)
+        printf("ERRO: %d verificação(ões) falharam\n", falhas);
+    free(serie);
+    free(flash);
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+// Custo por avaliação do detector de ponto quente entre strings (lib/ponto_quente.c)
+// para 8, 16 e 32 canais, no host. Os canais simulam uma manhã fria (~18 °C com
+// ruído de ±0,5 °C) com um conector 15 °C acima dos vizinhos; a ferramenta
+// confere que só ele é confirmado e mede o tempo médio por ciclo de avaliação.
+//
+//   cmake -S tools -B build-host && cmake --build build-host
+//   ./build-host/bench_ponto_quente [avaliacoes]
+//
+// No RP2040 o mesmo código é medido pela imagem microbench (casos ponto_quente_N).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ponto_quente.h"
+
+#define CONJUNTOS 64   // Conjuntos de leituras alternados entre as avaliações
+
+static uint32_t semente = 12345;
+
+static int16_t ruido_dc(int amplitude)
+{
+    semente = semente * 1103515245u + 12345u;
+    return (int16_t)((int)((semente >> 16) % (2 * amplitude + 1)) - amplitude);
+}
+
+static double agora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Retorna 0 se apenas o canal quente foi confirmado
+static int medir(uint8_t canais, long avaliacoes)
+{
+    static int16_t leituras[CONJUNTOS][PONTO_QUENTE_MAX_CANAIS];
+    const uint8_t quente = canais / 3;
+
+    for (int c = 0; c < CONJUNTOS; c++)
+    {
+        for (uint8_t i = 0; i < canais; i++)
+            leituras[c][i] = 180 + ruido_dc(5);
+        leituras[c][quente] += 150;
+    }
+
+    ponto_quente_t pq;
+    const ponto_quente_config_t config = PONTO_QUENTE_CONFIG_PADRAO;
+    ponto_quente_iniciar(&pq, &config);
+
+    uint32_t mascara = 0;
+    double inicio = agora_ns();
+    for (long k = 0; k < avaliacoes; k++)
+        mascara = ponto_quente_avaliar(&pq, (uint32_t)k * 100u, leituras[k % CONJUNTOS], canais);   // Ciclo de 100 ms
+    double ns = (agora_ns() - inicio) / avaliacoes;
+
+    int ok = mascara == (1u << quente);
+    printf("%6u %14.1f %12.1f %12.1f   0x%08lx %s\n", canais, ns, pq.mediana_dc / 10.0, pq.mad_dc / 10.0,
+           (unsigned long)mascara, ok ? "ok" : "FALHA");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    long avaliacoes = argc > 1 ? atol(argv[1]) : 1000000;
+    if (avaliacoes <= 0)
+        avaliacoes = 1;
+
+    printf("%6s %14s %12s %12s   %-10s\n", "canais", "ns/avaliacao", "mediana °C", "MAD °C", "quentes");
+    int falhas = 0;
+    falhas += medir(8, avaliacoes);
+    falhas += medir(16, avaliacoes);
+    falhas += medir(32, avaliacoes);
+    return falhas ? 1 : 0;
+}
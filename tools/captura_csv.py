@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Extrai a captura pré-disparo (linhas #CAPTURA/#C) de um log serial para CSV.
+
+Cada canal vira um arquivo no formato aceito por tools/replay.c
+(tempo_ms,adc), com tempo relativo à primeira amostra e o instante do disparo
+em um comentário "# disparo_ms=". Com --temperatura acrescenta a coluna em °C
+usando o mesmo modelo do NTC da tabela do firmware (só para análise).
+
+    captura_csv.py log_serial.txt -o evento        # evento_canal0.csv, ...
+"""
+
+import argparse
+import os
+import re
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+INICIO = re.compile(r'#CAPTURA inicio taxa_hz=(\d+) canais=(\d+) disparo_us=(\d+)')
+CANAL = re.compile(r'#CAPTURA canal=(\d+) adc=(\d+) amostras=(\d+) fim_us=(\d+)')
+LINHA = re.compile(r'#C(\d+) (\d+) ([0-9a-fA-F]+)')
+
+
+def desempacotar(dados):
+    """Duas amostras de 12 bits a cada três bytes, a primeira no nibble baixo."""
+    amostras = []
+    for i in range(0, len(dados) - 2, 3):
+        b0, b1, b2 = dados[i], dados[i + 1], dados[i + 2]
+        amostras.append(b0 | ((b1 & 0x0F) << 8))
+        amostras.append((b1 >> 4) | (b2 << 4))
+    return amostras
+
+
+def ler_log(caminho):
+    """Retorna a última captura completa ({'taxa', 'disparo_us', 'canais'}) ou None."""
+    captura = None
+    concluida = None
+    with open(caminho, encoding='utf-8', errors='replace') as f:
+        for linha in f:
+            linha = linha.strip()
+            m = INICIO.search(linha)
+            if m:
+                captura = {'taxa': int(m.group(1)), 'disparo_us': int(m.group(3)), 'canais': {}}
+                continue
+            if captura is None:
+                continue
+            m = CANAL.search(linha)
+            if m:
+                captura['canais'][int(m.group(1))] = {
+                    'adc': int(m.group(2)), 'total': int(m.group(3)),
+                    'fim_us': int(m.group(4)), 'amostras': {}}
+                continue
+            m = LINHA.search(linha)
+            if m:
+                canal = captura['canais'].get(int(m.group(1)))
+                if canal is not None:
+                    canal['amostras'][int(m.group(2))] = desempacotar(bytes.fromhex(m.group(3)))
+                continue
+            if '#CAPTURA fim' in linha:
+                concluida = captura
+                captura = None
+    return concluida
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('log', help='saída serial gravada (ex: minicom -C, tee)')
+    parser.add_argument('-o', '--prefixo', default='captura', help='prefixo dos arquivos CSV')
+    parser.add_argument('--temperatura', action='store_true',
+                        help='acrescenta a coluna em °C (modelo Beta; o CSV deixa de servir ao replay)')
+    parser.add_argument('--beta', type=float, default=3950.0)
+    parser.add_argument('--r25', type=float, default=10000.0)
+    parser.add_argument('--r-serie', type=float, default=10000.0)
+    args = parser.parse_args()
+
+    captura = ler_log(args.log)
+    if captura is None:
+        print('ERRO: nenhuma captura completa no log', file=sys.stderr)
+        return 1
+
+    if args.temperatura:
+        from gerar_tabela_ntc import resistencia_ntc, temperatura_beta
+
+    periodo_us = 1000000 // captura['taxa']
+    for numero, canal in sorted(captura['canais'].items()):
+        amostras = []
+        for inicio in sorted(canal['amostras']):
+            if inicio != len(amostras):
+                print('ERRO: canal %d sem as amostras %d..%d' % (numero, len(amostras), inicio - 1), file=sys.stderr)
+                return 1
+            amostras.extend(canal['amostras'][inicio])
+        amostras = amostras[:canal['total']]
+        if len(amostras) != canal['total']:
+            print('ERRO: canal %d com %d de %d amostras' % (numero, len(amostras), canal['total']), file=sys.stderr)
+            return 1
+
+        inicio_us = canal['fim_us'] - (len(amostras) - 1) * periodo_us
+        caminho = '%s_canal%d.csv' % (args.prefixo, numero)
+        with open(caminho, 'w', encoding='utf-8') as f:
+            f.write('# captura pré-disparo: adc=%d taxa_hz=%d amostras=%d\n' % (canal['adc'], captura['taxa'], len(amostras)))
+            f.write('# disparo_ms=%d\n' % ((captura['disparo_us'] - inicio_us) // 1000))
+            for i, adc in enumerate(amostras):
+                tempo_ms = (i * periodo_us) // 1000
+                if args.temperatura:
+                    t = temperatura_beta(resistencia_ntc(adc, args.r_serie), args.beta, args.r25)
+                    f.write('%d,%d,%.1f\n' % (tempo_ms, adc, t))
+                else:
+                    f.write('%d,%d\n' % (tempo_ms, adc))
+        print('%s: %d amostras (%.1f s), disparo em %d ms' % (caminho, len(amostras), len(amostras) / captura['taxa'],
+                                                         (captura['disparo_us'] - inicio_us) // 1000))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Compara duas capturas do microbench (imagem bench/microbench.c) caso a caso.
+
+Cada captura é a saída serial da suíte (pode conter outras linhas; só o bloco
+entre o cabeçalho CSV e "# fim" é lido). A comparação usa a mediana de cada
+caso e falha (código 1) se algum ficar mais lento que a tolerância.
+
+    comparar_bench.py v0.1.txt v0.2.txt --tolerancia 10
+"""
+
+import argparse
+import sys
+
+CABECALHO = 'caso,iteracoes,min_ns,mediana_ns,max_ns,ciclos'
+
+
+def ler_captura(caminho):
+    """Retorna {caso: mediana_ns} da última execução completa da suíte."""
+    casos = {}
+    atual = None
+    with open(caminho, encoding='utf-8', errors='replace') as f:
+        for linha in f:
+            linha = linha.strip()
+            if linha == CABECALHO:
+                atual = {}
+            elif linha == '# fim' and atual is not None:
+                casos = atual
+                atual = None
+            elif atual is not None and linha and not linha.startswith('#'):
+                campos = linha.split(',')
+                if len(campos) == 6:
+                    atual[campos[0]] = int(campos[3])
+    return casos
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('base', help='captura de referência (versão anterior)')
+    parser.add_argument('nova', help='captura da versão em teste')
+    parser.add_argument('--tolerancia', type=float, default=10.0,
+                        help='piora máxima aceita por caso, em %% (padrão 10)')
+    args = parser.parse_args()
+
+    base = ler_captura(args.base)
+    nova = ler_captura(args.nova)
+    if not base or not nova:
+        print('ERRO: captura sem execução completa da suíte', file=sys.stderr)
+        return 2
+
+    regressoes = 0
+    print('%-30s %12s %12s %8s' % ('caso', 'base (ns)', 'nova (ns)', 'Δ %'))
+    for caso in sorted(set(base) | set(nova)):
+        if caso not in base or caso not in nova:
+            print('%-30s %12s %12s %8s' % (caso, base.get(caso, '-'), nova.get(caso, '-'), 'novo' if caso in nova else 'removido'))
+            continue
+        delta = 100.0 * (nova[caso] - base[caso]) / base[caso] if base[caso] else 0.0
+        marca = ''
+        if delta > args.tolerancia:
+            marca = '  <-- REGRESSÃO'
+            regressoes += 1
+        print('%-30s %12d %12d %+7.1f%s' % (caso, base[caso], nova[caso], delta, marca))
+
+    if regressoes:
+        print('ERRO: %d caso(s) acima da tolerância de %.1f%%' % (regressoes, args.tolerancia), file=sys.stderr)
+    return 1 if regressoes else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Gera a tabela de linearização do NTC (ADC -> décimos de °C) usada por lib/ntc.c.
+
+Divisor considerado: 3V3 -> NTC -> pino ADC -> R_serie -> GND, de modo que a
+leitura do ADC cresce com a temperatura. A curva vem do modelo Beta ou, se os
+coeficientes forem informados, da equação de Steinhart-Hart.
+"""
+
+import argparse
+import math
+
+ADC_MAX = 4095
+
+
+def resistencia_ntc(adc, r_serie):
+    if adc <= 0:
+        return math.inf
+    if adc >= ADC_MAX:
+        return 0.0
+    return r_serie * (ADC_MAX - adc) / adc
+
+
+def temperatura_beta(r, beta, r25):
+    if r == math.inf:
+        return -math.inf
+    if r <= 0.0:
+        return math.inf
+    return 1.0 / (1.0 / 298.15 + math.log(r / r25) / beta) - 273.15
+
+
+def temperatura_steinhart(r, a, b, c):
+    if r == math.inf:
+        return -math.inf
+    if r <= 0.0:
+        return math.inf
+    ln_r = math.log(r)
+    return 1.0 / (a + b * ln_r + c * ln_r ** 3) - 273.15
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--beta", type=float, default=3950.0)
+    parser.add_argument("--r25", type=float, default=10000.0)
+    parser.add_argument("--r-serie", type=float, default=10000.0)
+    parser.add_argument("--steinhart", type=float, nargs=3, metavar=("A", "B", "C"))
+    parser.add_argument("--passo-bits", type=int, default=5)
+    parser.add_argument("--t-min", type=float, default=-40.0)
+    parser.add_argument("--t-max", type=float, default=150.0)
+    parser.add_argument("-o", "--saida", required=True)
+    args = parser.parse_args()
+
+    passo = 1 << args.passo_bits
+    entradas = (ADC_MAX + 1) // passo + 1
+
+    valores = []
+    for i in range(entradas):
+        r = resistencia_ntc(min(i * passo, ADC_MAX), args.r_serie)
+        if args.steinhart:
+            t = temperatura_steinhart(r, *args.steinhart)
+        else:
+            t = temperatura_beta(r, args.beta, args.r25)
+        t = min(max(t, args.t_min), args.t_max)
+        valores.append(int(round(t * 10.0)))
+
+    if args.steinhart:
+        modelo = "Steinhart-Hart A=%g B=%g C=%g" % tuple(args.steinhart)
+    else:
+        modelo = "Beta=%g R25=%g ohms" % (args.beta, args.r25)
+
+    linhas = []
+    for i in range(0, entradas, 8):
+        linhas.append("    " + ", ".join("%5d" % v for v in valores[i:i + 8]) + ",")
+
+    with open(args.saida, "w", encoding="utf-8") as f:
+        f.write("// Arquivo gerado por tools/gerar_tabela_ntc.py - não editar\n")
+        f.write("// Modelo: %s, R_serie=%g ohms\n" % (modelo, args.r_serie))
+        f.write("#ifndef NTC_TABELA_H\n#define NTC_TABELA_H\n\n")
+        f.write("#include <stdint.h>\n\n")
+        f.write("#define NTC_PASSO_BITS %d\n" % args.passo_bits)
+        f.write("#define NTC_TABELA_TAM %d\n\n" % entradas)
+        f.write("// Atributo de seção opcional (ex: tabela na SRAM, lib/secao_critica.h)\n")
+        f.write("#ifndef NTC_TABELA_SECAO\n#define NTC_TABELA_SECAO\n#endif\n\n")
+        f.write("static const int16_t ntc_tabela[NTC_TABELA_TAM] NTC_TABELA_SECAO = {\n")
+        f.write("\n".join(linhas) + "\n};\n\n")
+        f.write("#endif // NTC_TABELA_H\n")
+
+
+if __name__ == "__main__":
+    main()
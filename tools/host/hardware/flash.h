@@ -0,0 +1,20 @@
+#ifndef HOST_HARDWARE_FLASH_H
+#define HOST_HARDWARE_FLASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Flash simulada em RAM com a semântica da NOR (apagar = 0xFF, gravar só zera
+// bits). Só os dois setores dos slots A/B da configuração.
+
+#define FLASH_SECTOR_SIZE     4096u
+#define FLASH_PAGE_SIZE       256u
+#define PICO_FLASH_SIZE_BYTES (2 * FLASH_SECTOR_SIZE)
+
+extern uint8_t flash_host[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)flash_host)
+
+void flash_range_erase(uint32_t deslocamento, size_t tamanho);
+void flash_range_program(uint32_t deslocamento, const uint8_t *dados, size_t tamanho);
+
+#endif // HOST_HARDWARE_FLASH_H
@@ -0,0 +1,17 @@
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+// Um único fluxo de execução no host: não há interrupções a desligar
+static inline uint32_t save_and_disable_interrupts(void)
+{
+    return 0;
+}
+
+static inline void restore_interrupts(uint32_t estado)
+{
+    (void)estado;
+}
+
+#endif // HOST_HARDWARE_SYNC_H
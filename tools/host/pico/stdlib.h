@@ -0,0 +1,16 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Substituto mínimo do Pico SDK para compilar módulos de lib/ no host
+// (tools/host/sdk_host.c): só o que lib/config.c usa.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define PICO_ERROR_TIMEOUT (-1)
+
+// Sem console no host: nunca há caractere disponível
+int getchar_timeout_us(uint32_t timeout_us);
+
+#endif // HOST_PICO_STDLIB_H
@@ -0,0 +1,24 @@
+// Implementação no host das funções do Pico SDK declaradas em tools/host/
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+
+uint8_t flash_host[PICO_FLASH_SIZE_BYTES] = {[0 ... PICO_FLASH_SIZE_BYTES - 1] = 0xFF};
+
+int getchar_timeout_us(uint32_t timeout_us)
+{
+    (void)timeout_us;
+    return PICO_ERROR_TIMEOUT;
+}
+
+void flash_range_erase(uint32_t deslocamento, size_t tamanho)
+{
+    memset(flash_host + deslocamento, 0xFF, tamanho);
+}
+
+void flash_range_program(uint32_t deslocamento, const uint8_t *dados, size_t tamanho)
+{
+    for (size_t i = 0; i < tamanho; i++)
+        flash_host[deslocamento + i] &= dados[i];
+}
@@ -0,0 +1,214 @@
+// Escravo Modbus RTU de teste no host, servido em um pseudo-terminal.
+// Usa o mesmo núcleo e o mesmo mapa do firmware (lib/modbus.c e
+// lib/modbus_mapa.c), com a configuração de lib/config.c sobre uma flash em RAM
+// (tools/host/) e uma temperatura simulada publicada a cada 100 ms. Como no
+// laço principal do firmware, as escritas do SCADA ficam na fila do mapa e
+// são aplicadas fora do processamento do quadro.
+//
+//   cmake -S tools -B build-host && cmake --build build-host
+//   ./build-host/modbus_pty            -> imprime o dispositivo, ex: /dev/pts/3
+//   mbpoll -m rtu -b 19200 -P even -a 1 -t 3 -r 1 -c 10 /dev/pts/3
+//   ./build-host/modbus_pty --teste    -> requisições roteirizadas contra o mapa (ctest)
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <fcntl.h>
+#include <poll.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "modbus.h"
+#include "modbus_mapa.h"
+#include "config.h"
+#include "historico.h"
+#include "status.h"
+
+#define ESCRAVO      1
+#define SILENCIO_MS  2     // t3,5 arredondado (19200 baud = 2 ms)
+#define PERIODO_MS   100
+
+static status_publicado_t status_pub;
+static historico_t historico;
+static modbus_contadores_t contadores;
+static const modbus_mapa_t *mapa;
+
+static uint64_t agora_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void simular(uint64_t t_ms)
+{
+    SystemStatus s = {0};
+    s.current_temp = 25.0f + (float)((t_ms / 100) % 400) / 10.0f;   // rampa 25–65 °C
+    s.state = s.current_temp >= 60.0f ? SYSTEM_CRITICAL : s.current_temp >= 40.0f ? SYSTEM_ATTENTION : SYSTEM_NORMAL;
+    s.taxa_subida = 60;
+    s.countdown = 9;
+    status_publicar(&status_pub, &s);
+
+    hist_adicionar(&historico, t_ms, (int16_t)(s.current_temp * 10.0f));
+    modbus_mapa_publicar_historico(&historico);
+}
+
+// Aplica as escritas da fila, como o laço principal do firmware, e mostra o que mudou
+static void aplicar_escritas(void)
+{
+    config_t antes = *config_atual();
+    if (!modbus_mapa_aplicar_escritas())
+        return;
+    for (uint8_t c = 0; c < config_num_campos; c++)
+    {
+        int32_t de = config_ler_campo(&antes, &config_campos[c]);
+        int32_t para = config_ler_campo(config_atual(), &config_campos[c]);
+        if (de != para)
+            printf("  %s: %ld -> %ld\n", config_campos[c].nome, (long)de, (long)para);
+    }
+}
+
+// --- Modo --teste: requisições roteirizadas contra o mapa do firmware ---
+static uint16_t requisitar(const uint8_t *req, uint16_t tamanho, uint8_t *resp)
+{
+    return modbus_processar(mapa, ESCRAVO, req, tamanho, resp, &contadores);
+}
+
+static uint16_t montar_escrita(uint8_t *q, uint16_t inicio, const uint16_t *valores, uint16_t n)
+{
+    q[0] = ESCRAVO;
+    q[1] = 16;
+    q[2] = (uint8_t)(inicio >> 8);
+    q[3] = (uint8_t)inicio;
+    q[4] = 0;
+    q[5] = (uint8_t)n;
+    q[6] = (uint8_t)(2 * n);
+    for (uint16_t i = 0; i < n; i++)
+    {
+        q[7 + 2 * i] = (uint8_t)(valores[i] >> 8);
+        q[8 + 2 * i] = (uint8_t)valores[i];
+    }
+    uint16_t crc = modbus_crc16(q, 7 + 2 * n);
+    q[7 + 2 * n] = (uint8_t)crc;
+    q[8 + 2 * n] = (uint8_t)(crc >> 8);
+    return 9 + 2 * n;
+}
+
+static uint16_t reg_da_resposta(const uint8_t *resp, uint16_t i)
+{
+    return (uint16_t)(resp[3 + 2 * i] << 8 | resp[4 + 2 * i]);
+}
+
+static int testar(void)
+{
+    uint8_t req[MODBUS_QUADRO_MAX], resp[MODBUS_QUADRO_MAX];
+    int falhas = 0;
+#define VERIFICAR(cond, msg)                      \
+    do                                            \
+    {                                             \
+        bool ok_ = (cond);                        \
+        printf("%s  %s\n", ok_ ? "ok   " : "FALHA", msg); \
+        falhas += !ok_;                           \
+    } while (0)
+
+    for (uint32_t t = 0; t <= 90000; t += PERIODO_MS)
+        simular(t);
+
+    // Status (FC04 0–9) e histórico (FC04 100–107) pelo mapa do firmware
+    uint16_t n = requisitar(req, modbus_montar_leitura(req, ESCRAVO, false, MB_REG_STATUS, 10), resp);
+    VERIFICAR(n == 25 && reg_da_resposta(resp, 1) == 350, "FC04 0–9: temperatura publicada (35.0 °C)");
+    n = requisitar(req, modbus_montar_leitura(req, ESCRAVO, false, MB_REG_HISTORICO, 8), resp);
+    VERIFICAR(n == 21 && reg_da_resposta(resp, 6) == 1, "FC04 100–107: um minuto fechado no histórico");
+    VERIFICAR(n == 21 && ((uint32_t)reg_da_resposta(resp, 2) << 16 | reg_da_resposta(resp, 3)) == 300,
+              "FC04 102–103: 300 amostras no minuto em andamento");
+
+    // FC16 com o segundo valor fora da faixa: exceção e nada aplicado
+    int16_t atencao = config_atual()->limiar_atencao_dc;
+    uint16_t invalida[2] = {450, (uint16_t)-1000};
+    n = requisitar(req, montar_escrita(req, MB_REG_CONFIG, invalida, 2), resp);
+    VERIFICAR(n == 5 && resp[1] == (16 | 0x80) && resp[2] == MODBUS_EXC_VALOR, "FC16 com valor fora da faixa: exceção 03");
+    VERIFICAR(!modbus_mapa_aplicar_escritas() && config_atual()->limiar_atencao_dc == atencao,
+              "FC16 rejeitada não altera nenhum campo");
+
+    // FC16 válida: só é aplicada pelo laço principal
+    uint16_t valida[2] = {450, 650};
+    n = requisitar(req, montar_escrita(req, MB_REG_CONFIG, valida, 2), resp);
+    VERIFICAR(n == 8 && config_atual()->limiar_atencao_dc == atencao, "FC16 válida: aceita e ainda não aplicada");
+    VERIFICAR(modbus_mapa_aplicar_escritas() && config_atual()->limiar_atencao_dc == 450 &&
+                  config_atual()->limiar_critico_dc == 650,
+              "FC16 válida aplicada inteira no laço principal");
+    n = requisitar(req, modbus_montar_leitura(req, ESCRAVO, true, MB_REG_CONFIG, 2), resp);
+    VERIFICAR(n == 9 && reg_da_resposta(resp, 0) == 450 && reg_da_resposta(resp, 1) == 650, "FC03 lê os valores aplicados");
+
+    printf("%s\n", falhas ? "ERRO: mapa Modbus divergente" : "mapa Modbus ok");
+    return falhas ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    config_carregar();
+    mapa = modbus_mapa_iniciar(&status_pub, &contadores);
+    hist_iniciar(&historico);
+    if (argc > 1 && strcmp(argv[1], "--teste") == 0)
+        return testar();
+
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0)
+    {
+        perror("pty");
+        return 1;
+    }
+
+    struct termios tio;
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+    printf("Escravo Modbus RTU (endereço %d) em %s\n", ESCRAVO, ptsname(fd));
+    fflush(stdout);
+
+    uint8_t rx[MODBUS_QUADRO_MAX], tx[MODBUS_QUADRO_MAX];
+    uint16_t tam = 0;
+    uint64_t proxima = 0;
+
+    for (;;)
+    {
+        uint64_t t = agora_ms();
+        if (t >= proxima)
+        {
+            simular(t);
+            proxima = t + PERIODO_MS;
+        }
+
+        // Silêncio após bytes recebidos = fim de quadro
+        struct pollfd p = {fd, POLLIN, 0};
+        int pronto = poll(&p, 1, tam ? SILENCIO_MS : (int)(proxima - t));
+        if (pronto > 0 && (p.revents & POLLIN))
+        {
+            ssize_t n = read(fd, rx + tam, sizeof(rx) - tam);
+            if (n > 0)
+                tam += (uint16_t)n;
+            continue;
+        }
+        if (pronto > 0 && (p.revents & POLLHUP))
+        {
+            usleep(50000);   // Nenhum mestre conectado ao escravo do pty
+            continue;
+        }
+
+        if (tam > 0)
+        {
+            uint16_t n = modbus_processar(mapa, ESCRAVO, rx, tam, tx, &contadores);
+            if (n > 0 && write(fd, tx, n) != n)
+                perror("write");
+            printf("quadro %u bytes -> resposta %u (ok %u, crc %u, exc %u)\n", tam, n,
+                   contadores.quadros, contadores.erros_crc, contadores.excecoes);
+            aplicar_escritas();
+            fflush(stdout);
+            tam = 0;
+        }
+    }
+}
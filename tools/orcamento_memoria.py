@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""Relatório de uso de RAM/flash por módulo a partir do arquivo .map do GNU ld.
+
+Soma as seções de entrada de cada objeto conforme a seção de saída em que
+foram colocadas: .text/.rodata/.boot2/... contam para a flash, .bss/.heap/
+.stack contam para a RAM e .data conta para as duas (valor inicial na flash,
+cópia em RAM). Falha (código 1) quando o total ou algum módulo com limite
+próprio ultrapassa o orçamento, ou quando um módulo com limite não aparece no
+.map (nome errado ou sem memória própria: o limite não estaria verificando nada).
+
+    orcamento_memoria.py firmware.elf.map --ram 128K --flash 512K \
+        --modulo lib/captura.c:ram=16K
+"""
+
+import argparse
+import re
+import sys
+from collections import defaultdict
+
+SECOES_RAM = ('.bss', '.heap', '.stack', '.scratch_x', '.scratch_y',
+              '.uninitialized_data', '.ram_vector_table', '.tbss')
+SECOES_RAM_E_FLASH = ('.data', '.tdata')
+SECOES_IGNORADAS = ('.debug', '.comment', '.ARM.attributes', '.stab', '.note',
+                    '.flash_end', '.end_of_stack')
+
+SAIDA = re.compile(r'^(\.[\w.]+)\s+0x[0-9a-fA-F]+\s+0x[0-9a-fA-F]+')
+ENTRADA = re.compile(r'^ (\.[\w.$-]+|COMMON)\s*(?:\s(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S.*))?$')
+CONTINUACAO = re.compile(r'^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S.*)$')
+
+
+def tamanho(texto):
+    """Aceita 4096, 0x1000, 64K ou 2M."""
+    texto = texto.strip().upper()
+    mult = 1
+    if texto.endswith('K'):
+        mult, texto = 1024, texto[:-1]
+    elif texto.endswith('M'):
+        mult, texto = 1024 * 1024, texto[:-1]
+    return int(texto, 0) * mult
+
+
+def nome_modulo(objeto):
+    """Reduz o caminho do objeto a um nome de módulo legível."""
+    objeto = objeto.strip()
+    arquivo = re.match(r'(.*/)?([^/(]+\.a)\((.*)\)$', objeto)
+    if arquivo:
+        return arquivo.group(2)
+    m = re.search(r'CMakeFiles/[^/]+\.dir/(.*?)\.(?:obj|o)$', objeto)
+    if m:
+        caminho = m.group(1)
+        sdk = re.search(r'(?:^|/)src/(?:rp2_common|common|rp2040|host)/([^/]+)/', caminho)
+        if sdk:
+            return 'sdk/' + sdk.group(1)
+        return re.sub(r'^(?:\.\./)+', '', caminho)
+    return objeto.rsplit('/', 1)[-1]
+
+
+def classificar(secao_saida):
+    if secao_saida.startswith(SECOES_IGNORADAS):
+        return None
+    if secao_saida.startswith(SECOES_RAM_E_FLASH):
+        return 'ambos'
+    if secao_saida.startswith(SECOES_RAM):
+        return 'ram'
+    return 'flash'
+
+
+def ler_mapa(caminho):
+    uso = defaultdict(lambda: [0, 0])   # módulo -> [ram, flash]
+    saida = None
+    dentro = False
+    pendente = False
+
+    with open(caminho, encoding='utf-8', errors='replace') as f:
+        for linha in f:
+            linha = linha.rstrip('\n')
+            if linha.startswith('Linker script and memory map'):
+                dentro = True
+                continue
+            if not dentro:
+                continue
+
+            m = SAIDA.match(linha)
+            if m or (linha.startswith('.') and ' ' not in linha.strip()):
+                saida = (m.group(1) if m else linha.strip())
+                pendente = False
+                continue
+
+            m = ENTRADA.match(linha)
+            if m:
+                if m.group(2) is None:
+                    pendente = True   # Nome longo: endereço e tamanho na linha seguinte
+                    continue
+                endereco, tam, objeto = m.group(2), m.group(3), m.group(4)
+            elif pendente:
+                m = CONTINUACAO.match(linha)
+                pendente = False
+                if not m:
+                    continue
+                endereco, tam, objeto = m.groups()
+            else:
+                continue
+
+            tipo = classificar(saida or '')
+            tam = int(tam, 16)
+            if tipo is None or tam == 0 or int(endereco, 16) == 0:
+                continue
+
+            modulo = nome_modulo(objeto)
+            if tipo in ('ram', 'ambos'):
+                uso[modulo][0] += tam
+            if tipo in ('flash', 'ambos'):
+                uso[modulo][1] += tam
+    return uso
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('mapa')
+    parser.add_argument('--ram', type=tamanho, help='orçamento total de RAM')
+    parser.add_argument('--flash', type=tamanho, help='orçamento total de flash')
+    parser.add_argument('--modulo', action='append', default=[],
+                        help='limite por módulo: nome:ram=12K[,flash=4K]')
+    parser.add_argument('--top', type=int, default=25, help='módulos listados')
+    args = parser.parse_args()
+
+    uso = ler_mapa(args.mapa)
+    total_ram = sum(v[0] for v in uso.values())
+    total_flash = sum(v[1] for v in uso.values())
+
+    print('%-40s %10s %10s' % ('módulo', 'RAM', 'flash'))
+    ordem = sorted(uso.items(), key=lambda kv: (kv[1][0] + kv[1][1]), reverse=True)
+    for nome, (ram, flash) in ordem[:args.top]:
+        print('%-40s %10d %10d' % (nome, ram, flash))
+    if len(ordem) > args.top:
+        resto = ordem[args.top:]
+        print('%-40s %10d %10d' % ('(outros %d)' % len(resto),
+                                   sum(v[0] for _, v in resto), sum(v[1] for _, v in resto)))
+    print('%-40s %10d %10d' % ('TOTAL', total_ram, total_flash))
+
+    erros = []
+    if args.ram is not None and total_ram > args.ram:
+        erros.append('RAM total %d > orçamento %d' % (total_ram, args.ram))
+    if args.flash is not None and total_flash > args.flash:
+        erros.append('flash total %d > orçamento %d' % (total_flash, args.flash))
+
+    for regra in args.modulo:
+        nome, _, limites = regra.partition(':')
+        if nome not in uso:
+            erros.append('%s: módulo não encontrado no .map' % nome)
+            continue
+        ram, flash = uso[nome]
+        for limite in filter(None, limites.split(',')):
+            tipo, _, valor = limite.partition('=')
+            usado = ram if tipo == 'ram' else flash
+            if usado > tamanho(valor):
+                erros.append('%s: %s %d > orçamento %d' % (nome, tipo, usado, tamanho(valor)))
+
+    if args.ram is not None or args.flash is not None:
+        print('orçamento: RAM %s, flash %s' % (args.ram, args.flash))
+    for erro in erros:
+        print('ERRO: ' + erro, file=sys.stderr)
+    return 1 if erros else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,401 @@
+// Replay de traços de temperatura pela lógica de proteção do firmware, no host.
+// As amostras são entregues a lib/protecao.c com o tempo do próprio traço (tempo
+// simulado), então horas de dados rodam em frações de segundo.
+//
+//   cmake -S tools -B build-host && cmake --build build-host
+//   ./build-host/replay [opções] traco1.csv traco2.bin ...
+//
+// Formatos aceitos:
+//   CSV     tempo_ms,adc[,chama[,fumaca]]   (linhas começando com '#' são
+//           comentários; "# evento_ms=<t>" marca o início real do incêndio)
+//   binário "TRC1", uint32 evento_ms (0xFFFFFFFF = sem evento) e registros
+//           {uint32 tempo_ms; uint16 adc; uint16 flags (bit 0 = chama,
+//           bits 4–15 = ADC do sensor de fumaça)}, little-endian
+//
+// Alarmes críticos e desligamentos antes do evento (ou em traços sem evento)
+// contam como falsos; a latência é medida do evento até o primeiro de cada um.
+// Mais de um desligamento depois do evento também falha: a contagem fica
+// travada até a volta a NORMAL, então cada incêndio desliga uma vez.
+// A antecedência é o tempo entre o primeiro CRÍTICO e a primeira amostra no
+// limiar crítico absoluto (o único disparo antes da taxa de elevação). Um traço
+// com "# antecipacao_min_s=<s>" falha se a antecedência ficar abaixo disso
+// (tools/tracos/, executados pelo ctest).
+//
+// Com --ritmo a proteção não avalia toda amostra: como no firmware, cada ciclo
+// usa a média das amostras desde o anterior e o próximo ciclo vem após o período
+// do nível de risco (lib/ritmo.c); uma mudança do sensor de chama avalia na hora.
+//
+// Chama e fumaça passam pela fusão de sensores da proteção (lib/fusao.c) com os
+// pesos de --peso-*; traços sem essas colunas equivalem a sensores em repouso.
+// O resumo mostra ciclos por segundo e tempo em cada nível ao lado da latência.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "protecao.h"
+#include "ritmo.h"
+#include "ntc.h"
+
+#define SEM_EVENTO UINT64_MAX
+
+typedef struct
+{
+    protecao_t protecao;
+    SystemStatus status;
+    SystemState anterior;
+    uint64_t evento_ms;
+
+    uint64_t amostras;
+    uint64_t inicio_ms;
+    uint64_t fim_ms;
+    uint32_t alarmes;
+    uint32_t alarmes_falsos;
+    uint32_t desligamentos;
+    uint32_t desligamentos_falsos;
+    uint64_t latencia_alarme_ms;        // SEM_EVENTO enquanto não detectado
+    uint64_t latencia_desligamento_ms;
+    uint64_t primeiro_critico_ms;       // Primeiro CRÍTICO após o evento
+    uint64_t limiar_ms;                 // Primeira amostra >= limiar crítico após o evento
+    int64_t antecipacao_min_ms;         // -1: sem exigência no traço
+
+    // --ritmo: amostras acumuladas até o próximo ciclo de proteção
+    ritmo_t ritmo;
+    uint64_t proximo_ciclo_ms;
+    uint32_t soma_adc;
+    uint32_t soma_fumaca;
+    uint32_t n_adc;
+    bool chama_anterior;
+    uint64_t ciclos;
+} replay_t;
+
+static protecao_config_t config_protecao = {400, 600, 2600, 3600};
+static taxa_config_t config_taxa = TAXA_CONFIG_PADRAO;
+static fusao_config_t config_fusao = FUSAO_CONFIG_PADRAO;
+static ritmo_config_t config_ritmo = RITMO_CONFIG_PADRAO;
+static bool silencioso = false;
+static bool adaptativo = false;
+
+static const char *const nomes_estado[] = {"NORMAL", "ATENCAO", "CRITICO"};
+
+static void replay_iniciar(replay_t *r)
+{
+    memset(r, 0, sizeof(*r));
+    protecao_iniciar(&r->protecao, &config_protecao, &config_taxa, &config_fusao);
+    r->status.countdown = 9;
+    r->anterior = SYSTEM_NORMAL;
+    r->evento_ms = SEM_EVENTO;
+    r->latencia_alarme_ms = SEM_EVENTO;
+    r->latencia_desligamento_ms = SEM_EVENTO;
+    r->primeiro_critico_ms = SEM_EVENTO;
+    r->limiar_ms = SEM_EVENTO;
+    r->antecipacao_min_ms = -1;
+    ritmo_iniciar(&r->ritmo, &config_ritmo);
+}
+
+static void replay_amostra(replay_t *r, const char *nome, uint64_t tempo_ms, uint16_t adc, bool chama, uint16_t fumaca)
+{
+    if (r->amostras++ == 0)
+        r->inicio_ms = tempo_ms;
+    r->fim_ms = tempo_ms;
+
+    // Referência: quando o limiar absoluto sozinho dispararia
+    if (r->limiar_ms == SEM_EVENTO && tempo_ms >= r->evento_ms &&
+        ntc_adc_para_dc(adc) >= config_protecao.limiar_critico_dc)
+        r->limiar_ms = tempo_ms;
+
+    if (adaptativo)
+    {
+        r->soma_adc += adc;
+        r->soma_fumaca += fumaca;
+        r->n_adc++;
+        if (tempo_ms < r->proximo_ciclo_ms && chama == r->chama_anterior)
+            return;
+        adc = (uint16_t)((r->soma_adc + r->n_adc / 2) / r->n_adc);
+        fumaca = (uint16_t)((r->soma_fumaca + r->n_adc / 2) / r->n_adc);
+        r->soma_adc = 0;
+        r->soma_fumaca = 0;
+        r->n_adc = 0;
+        r->chama_anterior = chama;
+    }
+    r->ciclos++;
+
+    int16_t temp_dc = ntc_adc_para_dc(adc);
+    protecao_sensores_t sensores = {.chama = chama, .fumaca_adc = fumaca};
+    bool desligou = protecao_ciclo(&r->protecao, &r->status, (uint32_t)tempo_ms, temp_dc, &sensores);
+    bool antes_do_evento = tempo_ms < r->evento_ms;
+
+    if (adaptativo)
+    {
+        ritmo_atualizar(&r->ritmo, (uint32_t)tempo_ms, &r->status, temp_dc, &r->protecao.config);
+        r->proximo_ciclo_ms = tempo_ms + ritmo_periodo_ms(&r->ritmo);
+    }
+
+    if (r->status.state != r->anterior)
+    {
+        if (!silencioso)
+            printf("%s t=%.1fs %s -> %s (%.1f C, %.1f C/min, fusão %u votos 0x%x)\n", nome, tempo_ms / 1000.0,
+                   nomes_estado[r->anterior], nomes_estado[r->status.state],
+                   temp_dc / 10.0, r->status.taxa_subida / 10.0, r->status.fusao_pontuacao, r->status.fusao_votos);
+
+        if (r->status.state == SYSTEM_CRITICAL)
+        {
+            r->alarmes++;
+            if (antes_do_evento)
+                r->alarmes_falsos++;
+            else if (r->latencia_alarme_ms == SEM_EVENTO)
+            {
+                r->latencia_alarme_ms = tempo_ms - r->evento_ms;
+                r->primeiro_critico_ms = tempo_ms;
+            }
+        }
+        r->anterior = r->status.state;
+    }
+
+    if (desligou)
+    {
+        if (!silencioso)
+            printf("%s t=%.1fs DESLIGAMENTO\n", nome, tempo_ms / 1000.0);
+
+        r->desligamentos++;
+        if (antes_do_evento)
+            r->desligamentos_falsos++;
+        else if (r->latencia_desligamento_ms == SEM_EVENTO)
+            r->latencia_desligamento_ms = tempo_ms - r->evento_ms;
+    }
+}
+
+static bool ler_csv(FILE *f, replay_t *r, const char *nome)
+{
+    char linha[128];
+    while (fgets(linha, sizeof(linha), f))
+    {
+        if (linha[0] == '#')
+        {
+            const char *p = strstr(linha, "evento_ms=");
+            if (p)
+                r->evento_ms = strtoull(p + 10, NULL, 10);
+            p = strstr(linha, "antecipacao_min_s=");
+            if (p)
+                r->antecipacao_min_ms = (int64_t)(strtod(p + 18, NULL) * 1000.0);
+            continue;
+        }
+
+        char *fim;
+        uint64_t tempo = strtoull(linha, &fim, 10);
+        if (fim == linha || *fim != ',')
+            continue;   // Cabeçalho ou linha vazia
+        uint16_t adc = (uint16_t)strtoul(fim + 1, &fim, 10);
+        bool chama = false;
+        uint16_t fumaca = 0;
+        if (*fim == ',')
+        {
+            chama = strtoul(fim + 1, &fim, 10) != 0;
+            if (*fim == ',')
+                fumaca = (uint16_t)strtoul(fim + 1, NULL, 10);
+        }
+        replay_amostra(r, nome, tempo, adc, chama, fumaca);
+    }
+    return true;
+}
+
+static uint32_t le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool ler_binario(FILE *f, replay_t *r, const char *nome)
+{
+    uint8_t cab[8];
+    if (fread(cab, 1, sizeof(cab), f) != sizeof(cab) || memcmp(cab, "TRC1", 4) != 0)
+        return false;
+    uint32_t evento = le32(&cab[4]);
+    if (evento != 0xFFFFFFFFu)
+        r->evento_ms = evento;
+
+    static uint8_t bloco[8 * 4096];
+    size_t n;
+    while ((n = fread(bloco, 8, sizeof(bloco) / 8, f)) > 0)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            const uint8_t *reg = &bloco[8 * i];
+            uint16_t flags = (uint16_t)(reg[6] | (reg[7] << 8));
+            replay_amostra(r, nome, le32(reg), (uint16_t)(reg[4] | (reg[5] << 8)), flags & 1, flags >> 4);
+        }
+    }
+    return true;
+}
+
+static void imprimir_latencia(const char *rotulo, uint64_t latencia_ms, uint64_t evento_ms)
+{
+    if (evento_ms == SEM_EVENTO)
+        return;
+    if (latencia_ms == SEM_EVENTO)
+        printf("  %s: NÃO DETECTADO\n", rotulo);
+    else
+        printf("  %s: %.1f s após o evento\n", rotulo, latencia_ms / 1000.0);
+}
+
+static void uso(const char *prog)
+{
+    fprintf(stderr,
+            "uso: %s [-q] [--atencao dC] [--critico dC] [--taxa-atencao dC/min]\n"
+            "          [--taxa-critica dC/min] [--taxa-histerese dC/min] [--confirmacoes n]\n"
+            "          [--ritmo] [--ritmo-repouso ms] [--ritmo-margem dC] [--ritmo-taxa dC/min]\n"
+            "          [--ritmo-estavel s] [--peso-chama n] [--peso-fumaca n]\n"
+            "          [--peso-temperatura n] [--peso-taxa n] [--fusao-limiar n]\n"
+            "          [--fusao-votos n] [--fusao-confirmacao ms] [--fumaca-base adc]\n"
+            "          [--fumaca-alarme adc] traco...\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    int primeiro = 1;
+    for (; primeiro < argc && argv[primeiro][0] == '-'; primeiro++)
+    {
+        const char *op = argv[primeiro];
+        if (strcmp(op, "-q") == 0)
+        {
+            silencioso = true;
+            continue;
+        }
+        if (strcmp(op, "--ritmo") == 0)
+        {
+            adaptativo = true;
+            continue;
+        }
+        if (primeiro + 1 >= argc)
+            uso(argv[0]);
+
+        long valor = strtol(argv[++primeiro], NULL, 0);
+        if (strcmp(op, "--atencao") == 0)
+            config_protecao.limiar_atencao_dc = (int16_t)valor;
+        else if (strcmp(op, "--critico") == 0)
+            config_protecao.limiar_critico_dc = (int16_t)valor;
+        else if (strcmp(op, "--taxa-atencao") == 0)
+            config_taxa.atencao_dc_min = (int16_t)valor;
+        else if (strcmp(op, "--taxa-critica") == 0)
+            config_taxa.critica_dc_min = (int16_t)valor;
+        else if (strcmp(op, "--taxa-histerese") == 0)
+            config_taxa.histerese_dc_min = (int16_t)valor;
+        else if (strcmp(op, "--confirmacoes") == 0)
+            config_taxa.confirmacoes = (uint8_t)valor;
+        else if (strcmp(op, "--ritmo-repouso") == 0)
+            config_ritmo.periodo_ms[RITMO_REPOUSO] = (uint16_t)valor;
+        else if (strcmp(op, "--ritmo-margem") == 0)
+            config_ritmo.margem_dc = (int16_t)valor;
+        else if (strcmp(op, "--ritmo-taxa") == 0)
+            config_ritmo.taxa_dc_min = (int16_t)valor;
+        else if (strcmp(op, "--ritmo-estavel") == 0)
+            config_ritmo.estavel_ms = (uint32_t)valor * 1000u;
+        else if (strcmp(op, "--peso-chama") == 0)
+            config_fusao.peso[FUSAO_CHAMA] = (uint8_t)valor;
+        else if (strcmp(op, "--peso-fumaca") == 0)
+            config_fusao.peso[FUSAO_FUMACA] = (uint8_t)valor;
+        else if (strcmp(op, "--peso-temperatura") == 0)
+            config_fusao.peso[FUSAO_TEMPERATURA] = (uint8_t)valor;
+        else if (strcmp(op, "--peso-taxa") == 0)
+            config_fusao.peso[FUSAO_TAXA] = (uint8_t)valor;
+        else if (strcmp(op, "--fusao-limiar") == 0)
+            config_fusao.limiar = (uint16_t)valor;
+        else if (strcmp(op, "--fusao-votos") == 0)
+            config_fusao.votos_imediatos = (uint8_t)valor;
+        else if (strcmp(op, "--fusao-confirmacao") == 0)
+            config_fusao.confirmacao_ms = (uint16_t)valor;
+        else if (strcmp(op, "--fumaca-base") == 0)
+            config_protecao.fumaca_base_adc = (uint16_t)valor;
+        else if (strcmp(op, "--fumaca-alarme") == 0)
+            config_protecao.fumaca_alarme_adc = (uint16_t)valor;
+        else
+            uso(argv[0]);
+    }
+    if (primeiro >= argc)
+        uso(argv[0]);
+
+    uint64_t total_amostras = 0, total_ms = 0;
+    uint32_t total_falsos = 0, nao_detectados = 0, sem_antecipacao = 0, repetidos = 0;
+    clock_t relogio = clock();
+
+    for (int i = primeiro; i < argc; i++)
+    {
+        const char *nome = argv[i];
+        size_t len = strlen(nome);
+        bool binario = len > 4 && strcmp(nome + len - 4, ".bin") == 0;
+
+        FILE *f = fopen(nome, binario ? "rb" : "r");
+        if (!f)
+        {
+            perror(nome);
+            return 1;
+        }
+
+        static replay_t r;
+        replay_iniciar(&r);
+        bool ok = binario ? ler_binario(f, &r, nome) : ler_csv(f, &r, nome);
+        fclose(f);
+        if (!ok)
+        {
+            fprintf(stderr, "%s: formato inválido\n", nome);
+            return 1;
+        }
+
+        uint64_t duracao = r.amostras ? r.fim_ms - r.inicio_ms : 0;
+        printf("%s: %llu amostras, %.2f h simuladas\n", nome, (unsigned long long)r.amostras, duracao / 3600000.0);
+        printf("  alarmes críticos: %u (falsos %u), desligamentos: %u (falsos %u)\n",
+               r.alarmes, r.alarmes_falsos, r.desligamentos, r.desligamentos_falsos);
+        imprimir_latencia("detecção (CRÍTICO)", r.latencia_alarme_ms, r.evento_ms);
+        imprimir_latencia("desligamento", r.latencia_desligamento_ms, r.evento_ms);
+        if (r.primeiro_critico_ms != SEM_EVENTO)
+        {
+            // Sem cruzar o limiar no traço, a antecedência é ao menos até o fim dele
+            uint64_t referencia = r.limiar_ms != SEM_EVENTO ? r.limiar_ms : r.fim_ms;
+            int64_t antecipacao = (int64_t)referencia - (int64_t)r.primeiro_critico_ms;
+            printf("  antecedência sobre %.1f °C: %s%.1f s", config_protecao.limiar_critico_dc / 10.0,
+                   r.limiar_ms != SEM_EVENTO ? "" : ">= ", antecipacao / 1000.0);
+            if (r.antecipacao_min_ms >= 0)
+            {
+                bool ok = antecipacao >= r.antecipacao_min_ms;
+                printf(" (mínimo %.1f s: %s)", r.antecipacao_min_ms / 1000.0, ok ? "ok" : "FALHOU");
+                if (!ok)
+                    sem_antecipacao++;
+            }
+            printf("\n");
+        }
+        else if (r.antecipacao_min_ms >= 0)
+        {
+            sem_antecipacao++;
+        }
+        if (duracao > 0)
+            printf("  ciclos de proteção: %llu (%.2f/s)\n", (unsigned long long)r.ciclos, r.ciclos * 1000.0 / duracao);
+        if (adaptativo)
+        {
+            uint64_t total_nivel = 0;
+            for (int n = 0; n < RITMO_NIVEIS; n++)
+                total_nivel += r.ritmo.tempo_ms[n];
+            printf("  tempo por nível:");
+            for (int n = 0; n < RITMO_NIVEIS; n++)
+                printf(" %s %.1f%%", ritmo_nomes[n], total_nivel ? 100.0 * r.ritmo.tempo_ms[n] / total_nivel : 0.0);
+            printf("\n");
+        }
+
+        total_amostras += r.amostras;
+        total_ms += duracao;
+        total_falsos += r.desligamentos_falsos;
+        if (r.evento_ms != SEM_EVENTO && r.latencia_desligamento_ms == SEM_EVENTO)
+            nao_detectados++;
+        if (r.desligamentos - r.desligamentos_falsos > 1)
+            repetidos++;
+    }
+
+    double segundos = (double)(clock() - relogio) / CLOCKS_PER_SEC;
+    printf("\n%d traços, %.1f h simuladas em %.3f s (%.0fx tempo real)\n", argc - primeiro, total_ms / 3600000.0,
+           segundos, segundos > 0 ? (total_ms / 1000.0) / segundos : 0.0);
+    printf("desligamentos falsos: %u, eventos não detectados: %u, antecedência abaixo do mínimo: %u, "
+           "desligamentos repetidos: %u\n",
+           total_falsos, nao_detectados, sem_antecipacao, repetidos);
+
+    return (total_falsos || nao_detectados || sem_antecipacao || repetidos) ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+// Teste de estresse do seqlock de buffer duplo (lib/status.c) no host: uma
+// thread escritora publica SystemStatus com todos os campos derivados do mesmo
+// contador, e leitoras em paralelo usam os dois caminhos do firmware — a cópia
+// (status_ler, tela e relatório) e a leitura sem cópia com repetição (mapa
+// Modbus). Um instantâneo com campos de publicações diferentes é uma leitura
+// rasgada e faz o teste falhar.
+//
+//   cmake -S tools -B build-host && cmake --build build-host
+//   ./build-host/stress_status [--leitoras 3] [--publicacoes 2000000]
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "status.h"
+
+static status_publicado_t pub;
+static atomic_bool fim_escrita;
+
+typedef struct
+{
+    bool sem_copia;        // true: status_leitura_inicio/status_estavel/status_leitura_valida
+    uint64_t leituras;
+    uint64_t repeticoes;   // Leituras sem cópia refeitas porque a publicação mudou
+    uint64_t rasgadas;
+    uint32_t ultimo;       // Contador da leitura anterior (não pode voltar)
+    uint64_t regressoes;
+} leitora_t;
+
+// Todos os campos vêm de k: qualquer mistura entre publicações é detectável
+static void montar(SystemStatus *s, uint32_t k)
+{
+    s->state = (SystemState)(k % 3);
+    s->current_temp = (float)(k & 0xFFFFF);   // Exato em float até 2^24
+    s->fire_detected = (k & 1) != 0;
+    s->taxa_subida = (int16_t)(k * 7);
+    s->countdown = (int8_t)(k % 10);
+    s->relatorio = (k & 2) != 0;
+    s->canais_quentes = k;
+    s->fusao_pontuacao = (uint16_t)(k >> 3);
+    s->fusao_votos = (uint8_t)(k * 13);
+}
+
+static bool consistente(const SystemStatus *s)
+{
+    SystemStatus esperado;
+    memset(&esperado, 0, sizeof(esperado));
+    montar(&esperado, s->canais_quentes);
+    return s->state == esperado.state && s->current_temp == esperado.current_temp &&
+           s->fire_detected == esperado.fire_detected && s->taxa_subida == esperado.taxa_subida &&
+           s->countdown == esperado.countdown && s->relatorio == esperado.relatorio &&
+           s->fusao_pontuacao == esperado.fusao_pontuacao && s->fusao_votos == esperado.fusao_votos;
+}
+
+static void *escrever(void *arg)
+{
+    uint32_t publicacoes = *(const uint32_t *)arg;
+    SystemStatus s;
+    memset(&s, 0, sizeof(s));
+    for (uint32_t k = 1; k <= publicacoes; k++)
+    {
+        montar(&s, k);
+        status_publicar(&pub, &s);
+    }
+    atomic_store(&fim_escrita, true);
+    return NULL;
+}
+
+static void *ler(void *arg)
+{
+    leitora_t *l = arg;
+    SystemStatus s;
+    while (!atomic_load(&fim_escrita))
+    {
+        if (l->sem_copia)
+        {
+            // Como o mapa Modbus: campos lidos direto da cópia estável, refeitos se ela mudou
+            uint32_t seq;
+            bool ok;
+            for (;;)
+            {
+                seq = status_leitura_inicio(&pub);
+                const SystemStatus *estavel = status_estavel(&pub, seq);
+                memcpy(&s, estavel, sizeof(s));
+                ok = consistente(&s);
+                if (status_leitura_valida(&pub, seq))
+                    break;
+                l->repeticoes++;
+            }
+            if (!ok)
+                l->rasgadas++;
+        }
+        else
+        {
+            status_ler(&pub, &s);
+            if (!consistente(&s))
+                l->rasgadas++;
+        }
+
+        if (s.canais_quentes < l->ultimo)
+            l->regressoes++;
+        l->ultimo = s.canais_quentes;
+        l->leituras++;
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    int num_leitoras = 3;
+    uint32_t publicacoes = 2000000;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--leitoras") == 0)
+            num_leitoras = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--publicacoes") == 0)
+            publicacoes = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+    }
+    if (num_leitoras < 1 || num_leitoras > 16 || publicacoes == 0)
+    {
+        fprintf(stderr, "uso: %s [--leitoras 1-16] [--publicacoes n]\n", argv[0]);
+        return 2;
+    }
+
+    SystemStatus inicial;
+    memset(&inicial, 0, sizeof(inicial));
+    montar(&inicial, 0);
+    status_publicar(&pub, &inicial);
+
+    pthread_t leitoras[16], escritora;
+    leitora_t estado[16];
+    memset(estado, 0, sizeof(estado));
+    for (int i = 0; i < num_leitoras; i++)
+    {
+        estado[i].sem_copia = i % 2 == 1;
+        pthread_create(&leitoras[i], NULL, ler, &estado[i]);
+    }
+    pthread_create(&escritora, NULL, escrever, &publicacoes);
+
+    pthread_join(escritora, NULL);
+    uint64_t total_rasgadas = 0, total_regressoes = 0, total_leituras = 0;
+    for (int i = 0; i < num_leitoras; i++)
+    {
+        pthread_join(leitoras[i], NULL);
+        leitora_t *l = &estado[i];
+        printf("leitora %d (%s): %llu leituras, %llu repetidas, %llu rasgadas, %llu regressões\n", i,
+               l->sem_copia ? "sem cópia" : "status_ler", (unsigned long long)l->leituras,
+               (unsigned long long)l->repeticoes, (unsigned long long)l->rasgadas, (unsigned long long)l->regressoes);
+        total_rasgadas += l->rasgadas;
+        total_regressoes += l->regressoes;
+        total_leituras += l->leituras;
+    }
+
+    printf("%lu publicações, %llu leituras: %llu rasgadas, %llu regressões\n", (unsigned long)publicacoes,
+           (unsigned long long)total_leituras, (unsigned long long)total_rasgadas,
+           (unsigned long long)total_regressoes);
+    return (total_rasgadas || total_regressoes || total_leituras == 0) ? 1 : 0;
+}
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Gera os traços de referência de tools/tracos/ para o replay (tools/replay.c).
+
+Curvas típicas de aquecimento de uma caixa de strings, convertidas em leituras
+do ADC pelo mesmo divisor do NTC da tabela (tools/gerar_tabela_ntc.py, valores
+padrão). Cada traço de incêndio marca o início do aquecimento com
+"# evento_ms=" e a antecedência mínima exigida do disparo pela taxa de elevação
+em relação ao limiar crítico com "# antecipacao_min_s=". O ruído é determinístico
+(semente fixa), então regenerar produz os mesmos arquivos.
+"""
+
+import argparse
+import math
+import os
+import random
+
+ADC_MAX = 4095
+
+
+def adc_de(temp, beta=3950.0, r25=10000.0, r_serie=10000.0):
+    r = r25 * math.exp(beta * (1.0 / (temp + 273.15) - 1.0 / 298.15))
+    return int(round(ADC_MAX * r_serie / (r + r_serie)))
+
+
+def rampa(taxa_c_min):
+    return lambda s: taxa_c_min * s / 60.0
+
+
+def exponencial(amplitude, tau_s):
+    return lambda s: amplitude * (1.0 - math.exp(-s / tau_s))
+
+
+# nome: (base °C, curva após o evento, duração após o evento em s, antecedência mínima em s)
+TRACOS_INCENDIO = {
+    "rampa_30c_min": (28.0, rampa(30.0), 120, 45),
+    "rampa_10c_min": (30.0, rampa(10.0), 240, 130),
+    "arco_conector": (30.0, exponencial(70.0, 300.0), 300, 125),
+}
+
+PRE_EVENTO_S = 60
+PASSO_MS = 100
+
+
+def gravar(caminho, cabecalho, amostras):
+    with open(caminho, "w", encoding="utf-8") as f:
+        for linha in cabecalho:
+            f.write("# %s\n" % linha)
+        f.write("tempo_ms,adc\n")
+        for tempo_ms, temp in amostras:
+            f.write("%d,%d\n" % (tempo_ms, adc_de(temp)))
+
+
+def gerar_incendio(diretorio, nome, base, curva, duracao_s, antecipacao_min_s, aleatorio):
+    evento_ms = PRE_EVENTO_S * 1000
+    amostras = []
+    for i in range((PRE_EVENTO_S + duracao_s) * 1000 // PASSO_MS + 1):
+        t = i * PASSO_MS
+        temp = base + aleatorio.gauss(0.0, 0.2)
+        if t >= evento_ms:
+            temp += curva((t - evento_ms) / 1000.0)
+        amostras.append((t, temp))
+    gravar(os.path.join(diretorio, nome + ".csv"),
+           ["evento_ms=%d" % evento_ms, "antecipacao_min_s=%d" % antecipacao_min_s], amostras)
+
+
+def gerar_sol_nuvens(diretorio, aleatorio):
+    """Sem incêndio: caixa ao sol da manhã até ~52 °C, com nuvens passando."""
+    passo_ms = 500
+    amostras = []
+    sombra = 0.0
+    for i in range(40 * 60 * 1000 // passo_ms + 1):
+        t = i * passo_ms
+        s = t / 1000.0
+        temp = 25.0 + 27.0 * (1.0 - math.exp(-s / 900.0))
+        # Nuvem a cada 6 min: a caixa esfria ~4 °C em 1 min e volta em seguida
+        fase = s % 360.0
+        alvo = -4.0 if 120.0 <= fase < 180.0 else 0.0
+        sombra += (alvo - sombra) * (passo_ms / 1000.0) / 30.0
+        amostras.append((t, temp + sombra + aleatorio.gauss(0.0, 0.2)))
+    gravar(os.path.join(diretorio, "sol_nuvens.csv"), [], amostras)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("-o", "--saida", default=os.path.dirname(os.path.abspath(__file__)))
+    args = parser.parse_args()
+
+    aleatorio = random.Random(2024)
+    for nome, (base, curva, duracao_s, antecipacao_min_s) in TRACOS_INCENDIO.items():
+        gerar_incendio(args.saida, nome, base, curva, duracao_s, antecipacao_min_s, aleatorio)
+    gerar_sol_nuvens(args.saida, aleatorio)
+
+
+if __name__ == "__main__":
+    main()